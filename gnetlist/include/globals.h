@@ -27,11 +27,16 @@ extern int logging_dest;
 extern NETLIST *netlist_head;
 extern NETLIST *graphical_netlist_head; /* Special objects with 
 					   graphical=1 attribute */
-extern char *guile_proc;
 extern int list_backends;
+extern int fork_backends;
 extern int verbose_mode;
 extern int interactive_mode;
 extern int quiet_mode;
+extern int traverse_jobs;     /* number of threads used to traverse sheets */
+extern int server_mode;
+extern char *server_socket;   /* socket to listen on in server mode, or NULL */
+extern int stats_mode;
+extern char *stats_filename;  /* where to write --stats output, or NULL */
 extern int netlist_mode;
 extern char *output_filename;
 extern SCM pre_rc_list;       /* before rc loaded */
@@ -19,6 +19,7 @@
 
 extern int default_net_naming_priority;
 extern int default_hierarchy_traversal;
+extern int default_hierarchy_sheet_cache;
 extern int default_hierarchy_uref_mangle;
 extern int default_hierarchy_netname_mangle;
 extern int default_hierarchy_netattrib_mangle;
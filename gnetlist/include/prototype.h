@@ -1,3 +1,9 @@
+/* g_backend.c */
+void g_backend_add(const char *spec);
+int g_backend_count(void);
+void g_backend_free_all(void);
+void g_backend_load_all(const char *argv0);
+int g_backend_run_all(TOPLEVEL *pr_current, const char *cwd);
 /* g_netlist.c */
 void g_set_project_current(TOPLEVEL *pr_current);
 SCM g_scm_c_get_uref(TOPLEVEL *toplevel, OBJECT *object);
@@ -12,6 +18,8 @@ SCM g_get_all_connections(SCM scm_netname);
 SCM g_get_nets(SCM scm_uref, SCM scm_pin);
 SCM g_get_pins_nets(SCM scm_uref);
 SCM g_get_all_package_attributes(SCM scm_uref, SCM scm_wanted_attrib);
+SCM g_get_all_packages_attributes(SCM scm_wanted_attrib);
+SCM g_get_slotdefs(SCM scm_uref);
 SCM g_get_attribute_by_pinseq(SCM scm_uref, SCM scm_pinseq, SCM scm_wanted_attrib);
 SCM g_get_attribute_by_pinnumber(SCM scm_uref, SCM scm_pin, SCM scm_wanted_attrib);
 SCM g_get_toplevel_attribute(SCM scm_wanted_attrib);
@@ -20,6 +28,7 @@ SCM g_graphical_objs_in_net_with_attrib_get_attrib(SCM scm_netname, SCM scm_has_
 SCM g_rc_gnetlist_version(SCM version);
 SCM g_rc_net_naming_priority(SCM mode);
 SCM g_rc_hierarchy_traversal(SCM mode);
+SCM g_rc_hierarchy_sheet_cache(SCM mode);
 SCM g_rc_hierarchy_uref_mangle(SCM mode);
 SCM g_rc_hierarchy_netname_mangle(SCM mode);
 SCM g_rc_hierarchy_netattrib_mangle(SCM mode);
@@ -31,6 +40,9 @@ SCM g_rc_hierarchy_netname_order(SCM mode);
 SCM g_rc_hierarchy_uref_order(SCM mode);
 SCM g_rc_unnamed_netname(SCM name);
 SCM g_rc_unnamed_busname(SCM name);
+/* g_snapshot.c */
+SCM g_get_netlist_snapshot(void);
+void g_snapshot_destroy(void);
 /* g_register.c */
 void g_register_funcs(void);
 SCM g_quit(void);
@@ -51,6 +63,9 @@ CPINLIST *s_cpinlist_return_head(CPINLIST *tail);
 CPINLIST *s_cpinlist_add(CPINLIST *ptr);
 void s_cpinlist_print(CPINLIST *ptr);
 CPINLIST *s_cpinlist_search_pin(CPINLIST *ptr, char *pin_number);
+/* s_drc2.c */
+void s_drc2_destroy(void);
+SCM g_drc2_check(SCM port, SCM scm_check, SCM config);
 /* s_hierarchy.c */
 void s_hierarchy_traverse(TOPLEVEL *pr_current, OBJECT *o_current, NETLIST *netlist);
 void s_hierarchy_post_process(TOPLEVEL *pr_current, NETLIST *head);
@@ -63,15 +78,26 @@ char *s_hierarchy_create_netattrib(TOPLEVEL *pr_current, char *basename, char *h
 void s_hierarchy_remove_uref_mangling(TOPLEVEL *pr_current, NETLIST *head);
 char *s_hierarchy_return_baseuref(TOPLEVEL *pr_current, char *uref);
 int s_hierarchy_graphical_search(OBJECT* o_current, int count);
+void s_hierarchy_cache_destroy(void);
+/* s_intern.c */
+SCM s_intern_string(const char *str);
+SCM s_intern_copy_tree(SCM tree);
+void s_intern_build(NETLIST *head);
+void s_intern_destroy(void);
 /* s_misc.c */
 void verbose_print(char *string);
 void verbose_done(void);
 void verbose_reset_index(void);
+/* s_native.c */
+int s_native_is_backend(const char *name);
+GList *s_native_backend_names(GList *names);
+void s_native_run(const char *name, const char *filename);
 /* s_net.c */
 NET *s_net_return_tail(NET *head);
 NET *s_net_return_head(NET *tail);
 NET *s_net_add(NET *ptr);
 void s_net_print(NET *ptr);
+void s_net_reset_unnamed(void);
 char *s_net_return_connected_string(TOPLEVEL *pr_current, OBJECT *object, char *hierarchy_tag);
 int s_net_find(NET *net_head, NET *node);
 char *s_net_name_search(TOPLEVEL *pr_current, NET *net_head);
@@ -82,10 +108,22 @@ void s_netattrib_create_pins(TOPLEVEL *pr_current, OBJECT *o_current, NETLIST *n
 void s_netattrib_handle(TOPLEVEL *pr_current, OBJECT *o_current, NETLIST *netlist, char *hierarchy_tag);
 char *s_netattrib_net_search(OBJECT *o_current, char *wanted_pin);
 char *s_netattrib_return_netname(TOPLEVEL *pr_current, OBJECT *o_current, char *pinnumber, char *hierarchy_tag);
+/* s_netindex.c */
+void s_netindex_split_connected_to(const char *connected_to, char **uref, char **pin);
+void s_netindex_build(NETLIST *head);
+void s_netindex_destroy(void);
+SCM s_netindex_unique_nets_list(void);
+SCM s_netindex_connections_list(const char *net_name);
+guint s_netindex_net_count(void);
+const char *s_netindex_nth_net(guint n);
+guint s_netindex_connection_count(const char *net_name);
+void s_netindex_nth_connection(const char *net_name, guint n, const char **uref, const char **pin);
 /* s_netlist.c */
 NETLIST *s_netlist_return_tail(NETLIST *head);
 NETLIST *s_netlist_return_head(NETLIST *tail);
 NETLIST *s_netlist_add(NETLIST *ptr);
+void s_netlist_free(NETLIST *nl_current);
+NETLIST *s_netlist_copy(NETLIST *tail, NETLIST *fragment);
 void s_netlist_print(NETLIST *ptr);
 void s_netlist_post_process(TOPLEVEL *pr_current, NETLIST *head);
 void s_netlist_name_named_nets (TOPLEVEL *pr_current,
@@ -94,6 +132,18 @@ void s_netlist_name_named_nets (TOPLEVEL *pr_current,
 char *s_netlist_netname_of_netid (TOPLEVEL *pr_current,
 				  NETLIST *netlist_head,
 				  int net_id);
+/* s_package.c */
+void s_package_build(NETLIST *head);
+void s_package_destroy(void);
+SCM s_package_attribute_values(const char *refdes, const char *name);
+SCM s_package_all_attribute_values(const char *name);
+guint s_package_count(void);
+const char *s_package_nth_refdes(guint n);
+guint s_package_instance_count(const char *refdes);
+const char *s_package_instance_attribute(const char *refdes, guint instance, const char *name);
+const char *s_package_unique_attribute(const char *refdes, const char *name);
+GList *s_package_attribute_names(const char *refdes);
+SCM s_package_slotdefs(const char *refdes);
 /* s_rename.c */
 void s_rename_init(void);
 void s_rename_destroy_all(void);
@@ -103,10 +153,31 @@ int s_rename_search(char *src, char *dest, int quiet_flag);
 void s_rename_add(char *src, char *dest);
 void s_rename_all_lowlevel(NETLIST *netlist_head, char *src, char *dest);
 void s_rename_all(TOPLEVEL *pr_current, NETLIST *netlist_head);
+void s_rename_foreach(void (*func)(const char *src, const char *dest, gpointer user_data), gpointer user_data);
 SCM g_get_renamed_nets(SCM scm_level);
+/* s_server.c */
+int s_server_run(TOPLEVEL *pr_current, const char *argv0, const char *cwd, const char *socket_path);
+/* s_stats.c */
+void s_stats_phase_begin(const char *name, const char *detail);
+void s_stats_phase_end(void);
+void s_stats_add(const char *name, guint n);
+SCM g_stats_count_call(SCM scm_name);
+void s_stats_report(TOPLEVEL *pr_current);
 /* s_traverse.c */
 void s_traverse_init(void);
 void s_traverse_start(TOPLEVEL *pr_current);
+void s_traverse_set_pages(GList *pages);
+void s_traverse_depend_page(const char *filename, PAGE *page);
+guint s_traverse_depend_mark(void);
+GPtrArray *s_traverse_depend_slice(guint mark);
+void s_traverse_depend_replay(GPtrArray *slice);
+void s_traverse_depend_free(GPtrArray *depends);
+void s_traverse_set_incremental(int enable);
+void s_traverse_update_cache(TOPLEVEL *pr_current);
+void s_traverse_cache_destroy(void);
+void s_traverse_reset(void);
+NETLIST *s_traverse_netlist_head(void);
+NETLIST *s_traverse_graphical_netlist_head(void);
 void s_traverse_sheet(TOPLEVEL *pr_current, const GList *obj_list, char *hierarchy_tag);
 CPINLIST *s_traverse_component(TOPLEVEL *pr_current, OBJECT *component, char *hierarchy_tag);
 NET *s_traverse_net(TOPLEVEL *pr_current, NET *nets, int starting, OBJECT *object, char *hierarchy_tag, int type);
@@ -22,6 +22,8 @@
 ;;
 ;; DRC backend written by Carlos Nieves Onega starts here.
 ;;
+;;  2026-10-18: The checks are now done in C (gnetlist:drc2-check), over
+;;              indexes of the netlist.  Configuration is unchanged.
 ;;  2010-12-11: Fix stack overflows with large designs.
 ;;  2010-10-02: Applied patch from Karl Hammar. Do drc-matrix lower triangular
 ;;                    and let get-drc-matrixelement swap row/column if row < column.
@@ -321,591 +323,34 @@
 ;-----------------------------------------------------------------------
 
 ;-----------------------------------------------------------------------
-; SYMBOLS checking functions
+;   Checks
 ;
-
-;;
-;; Check for symbols not numbered.
-;;
-;; example of packages: (U100 U101 U102)
-(define drc2:check-non-numbered-items
-   (lambda (port packages)
-      (if (not (null? packages))
-         (let ((package (car packages)))
-            (begin
-	       (if (not (eq? (string-index package #\?) #f))
-		   (begin (display "ERROR: Reference not numbered: " port)
-			  (display package port)
-			  (newline port)
-			  (set! errors_number (+ errors_number 1))
-			  )
-		   )
-	       (drc2:check-non-numbered-items port (cdr packages)))))))
-
-
-;;
-;; Check for duplicated slots
-;;
-;; Check if a slot of a package is used more than one time. Checks all packages in the design.
-(define drc2:check-duplicated-slots
-  (lambda (port)
-    (define check-duplicated-slots-of-package
-      (lambda (uref)
-	(define check-slots-loop
-	  (lambda (slots_list)
-	    (if (> (length slots_list) 1)
-		(begin
-		  (if (member (car slots_list) (cdr slots_list))
-		      (begin
-			(display (string-append "ERROR: duplicated slot " 
-						(number->string (car slots_list))
-						" of uref "
-						uref) port)
-			(newline port)
-			(set! errors_number (+ errors_number 1))))
-		  (check-slots-loop (cdr slots_list))
-		  ))))
-	(check-slots-loop (gnetlist:get-slots uref))))
-    (for-each check-duplicated-slots-of-package packages)
-))
-
-
-
-;;
-;; Checks for slots not used.
-;;
-(define drc2:check-unused-slots
-  (lambda (port)
-    (define check-unused-slots-of-package
-      (lambda (uref)
-
- 	(define check-slots-loop
- 	  (lambda (slot_number slots_list)
- 	    (let ( (numslots (string->number (gnetlist:get-package-attribute uref "numslots"))) )
-	      (if (not (member slot_number slots_list))
-		  (begin
-		    (if (not (char=? action-unused-slots #\c))
-			(begin
-			  (if (char=? action-unused-slots #\e)
-			      (begin 
-				(display (string-append "ERROR: Unused slot "
-							(number->string slot_number)
-							" of uref " uref) port)
-				(set! errors_number (+ errors_number 1)))
-			      (begin
-				(display (string-append "WARNING: Unused slot "
-							(number->string slot_number)
-							" of uref " uref) port)
-				(set! warnings_number (+ warnings_number 1))))
-			  (newline port)))))
-	      (if (< slot_number numslots)
-		  (check-slots-loop (+ slot_number 1) slots_list)))))
-
-	(if (integer? (string->number (gnetlist:get-package-attribute uref "numslots")))
-	    (check-slots-loop 1 (gnetlist:get-unique-slots uref))
-	    )
-	))
-
-    (for-each check-unused-slots-of-package packages)
-    ))
-
-;;
-;; Check slot number is greater or equal than numslots for all packages
-;;
-(define drc2:check-slots
-  (lambda (port)
-    (define check-slots-of-package
-      (lambda (uref)
-	
-	(let* ( (numslots_string (gnetlist:get-package-attribute uref "numslots"))
-		(numslots (string->number numslots_string))
-		(slot_string (let ((slots (gnetlist:get-all-package-attributes uref "slot")))
-                               (if (or (null? slots) (not (car slots)))
-                                   "unknown" (car slots))))
-		(slot (string->number slot_string))
-		)
-	  (let ()
-	    (define check-slots-loop
-	      (lambda (slots_list)
-		(if (not (null? slots_list))
-		    (let ((this_slot (car slots_list)))
-		      (if (integer? this_slot)
-			  (if (not (and (<= this_slot numslots) (>= this_slot 1)))
-			      ;; If slot is not between 1 and numslots, then report an error.
-			      (begin
-				(display (string-append "ERROR: Reference " uref 
-							": Slot out of range (" 
-							(number->string this_slot)
-							").") port)
-				(newline port)
-				(set! errors_number (+ errors_number 1)))))
-		      
-		      (check-slots-loop (cdr slots_list))
-		      ))))
-	    
-	    (if (string-ci=? slot_string "unknown")
-		(begin
-		  ;; If slot attribute is not defined.
-		  (if (or (string-ci=? numslots_string "unknown") (= numslots 0))
-		      (begin
-			;; No slot neither numslots (or set to zero) attributes defined.
-			;; This is correct.
-			;;(display (string-append "No slotted reference: " uref))
-			(display "")
-			;;(newline)
-			)
-		      (begin
-			;; Slot not defined, but numslots defined or different than 0.
-			;; This is incorrect. Check if numslots is a number and
-			;; report the situation to the user.
-			(if (integer? numslots)
-			    ;; If no slot attribute, but numslots is defined and not zero.
-			    (begin
-			      ;; If numslots is a number, then slot should be defined.
-			      (display (string-append "ERROR: Multislotted reference " uref 
-						      " has no slot attribute defined.") port)
-			      (newline port)
-			      (set! errors_number (+ errors_number 1)))
-			    (begin
-			      (display (string-append "ERROR: Reference " uref 
-						      ": Incorrect value of numslots attribute ("
-						      numslots_string ").") 
-				       port)
-			      (newline port)
-			       (set! errors_number (+ errors_number 1))
-			      )
-			    )
-			))
-		  )
-		(begin
-		  ;; Slot attribute defined.
-		  ;; If it's a number, then check slots. If it's not, then report an error.
-		  (if (integer? slot)
-		      (if (integer? numslots)
-			  (check-slots-loop (gnetlist:get-unique-slots uref))
-			  (begin
-			    ;; Slot is defined and it's a number, but numslots it's not a number.
-			    (display (string-append "ERROR: Reference " uref
-						    ": Incorrect value of numslots attribute ("
-						    numslots_string ").") port)
-			    (newline port)
-			    (set! errors_number (+ errors_number 1))))
-		      (begin
-			;; Slot attribute is not a number.
-			(display (string-append "ERROR: Reference " uref 
-						": Incorrect value of slot attribute ("
-						slot_string ").") port)
-			(newline port)
-			(set! errors_number (+ errors_number 1))))
-		  ))))))
-    
-
-    (for-each check-slots-of-package packages)
-    ))
-
-;; Count the ocurrences of a given reference in the given list.
-(define (drc2:count-reference-in-list refdes lst)
-  (define refdes=? (if (defined? 'case_insensitive) string-ci=? string=?))
-  (fold
-   (lambda (x count) (if (refdes=? refdes x) (1+ count) count))
-   0 lst))
-
-;; Check duplicated references of the given list
-;;   If the number of ocurrences of a reference in the schematic doesn't match the number
-;;   of unique slots used by that part, then that reference is used more than one time in
-;;   the schematic.
-(define drc2:check-duplicated-references 
-  (lambda (port list)
-    (if (null? list)
-	0
-	(let ( (refdes (car list)))
-	       (if (> (drc2:count-reference-in-list refdes (gnetlist:get-non-unique-packages ""))
-		      (length (gnetlist:get-unique-slots refdes)))
-		   (begin
-		     (display (string-append "ERROR: Duplicated reference " refdes ".") port)
-		     (newline port)
-		     (set! errors_number (+ errors_number 1))))
-	       (drc2:check-duplicated-references port (cdr list))
-	       ))
-))
-
-
+; The checks themselves are done in C by gnetlist:drc2-check, which is
+; given the configuration below and writes its findings to the port.
 ;
-;  End of symbol checking functions
-;-----------------------------------------------------------------------
-
-
-;-----------------------------------------------------------------------
-;  NETs checking functions
-;
-
-;;
-;; Check for NoConnection nets with more than one pin connected.
-;;
-;; Example of all-nets: (net1 net2 net3 net4)
-(define (drc2:check-connected-noconnects port all-nets)
-  (for-each
-    (lambda (netname)
-      (let
-        ((directives (gnetlist:graphical-objs-in-net-with-attrib-get-attrib
-                    netname
-                    "device=DRC_Directive"
-                    "value")))
-        ;Only check nets with a NoConnection directive
-        (and
-          (member "NoConnection" directives)
-          ( >  (length (gnetlist:get-all-connections netname)) '1)
-          (begin
-            (display (string-append "ERROR: Net '"
-                            netname "' has connections, but "
-                            "has the NoConnection DRC directive: ") port)
-            (drc2:display-pins-of-type port "all" (gnetlist:get-all-connections netname))
-            (display "." port)
-            (newline port)
-            (set! errors_number (1+ errors_number))))))
-    all-nets))
-
-;;
-;; Check for nets with less than two pins connected.
-;;
-;; Example of all-nets: (net1 net2 net3 net4)
-(define drc2:check-single-nets
-  (lambda (port all-nets)
-      (if (not (null? all-nets))
-	  (let* ((netname (car all-nets))
-		 (directives (gnetlist:graphical-objs-in-net-with-attrib-get-attrib
-			      netname
-			      "device=DRC_Directive"
-			      "value")))
-	    (begin
-	      ; If one of the directives is NoConnection, 
-	      ; then it shouldn't be checked.
- 	      (if (not (member "NoConnection" directives))
-		  (begin
-		    (if (eq? (length (gnetlist:get-all-connections netname)) '0)
-			(begin (display (string-append "ERROR: Net '"
-						       netname "' has no connections.") port)
-			       (newline port)
-			       (set! errors_number (+ errors_number 1))
-			       )                      
-			)
-		    (if (eq? (length (gnetlist:get-all-connections netname)) '1)
-			(begin (display (string-append "ERROR: Net '"
-						       netname "' is connected to only one pin: ") port)
-			       (drc2:display-pins-of-type port "all" (gnetlist:get-all-connections netname))
-			       (display "." port)
-			       (newline port)
-			       (set! errors_number (+ errors_number 1))
-			       )                      
-			)
-		    ))
-	      (drc2:check-single-nets port (cdr all-nets)))))
-  ))
-
-;;
-;; Return a list with the pintypes of the pins connected to a net.
-;;
-;; Example. net-conn: ((U100 1) (U101 1)). pintypes-list: ("in" "out" "in")
-(define drc2:get-pintypes-of-net-connections
-  (lambda (net-conn pintypes-list)
-    (if (not (null? net-conn))
-	(let* ( (element (car net-conn)) 
-		(device (car element))
-		(pin (car (cdr (car net-conn))))
-		(pintype (gnetlist:get-attribute-by-pinnumber device pin "pintype"))
-		)
-	  (begin
-	    (cons pintype 
-		  (drc2:get-pintypes-of-net-connections (cdr net-conn)
-							  pintypes-list)
-		  )
-	    ))
-	(list)
-	)
-))
-
-;;
-;;  Count pintypes of a net.
-;;
-;; net: "in", "out", for example.
-(define drc2:count-pintypes-of-net
-  (lambda (net port)
-    (define output-list (make-list (length pintype-names) 0))
-    (define add-pintype
-      (lambda (type)
-	   (if (not (member (string-downcase type) pintype-names))
-	       (begin
-		 (display "INTERNAL ERROR: unknown pin type : " port)
-		 (display type port)
-		 (newline port))
-	       (begin
-		 (list-set! output-list (drc2:position-of-pintype type)
-                                       (+ 1 (list-ref output-list (drc2:position-of-pintype type))))))
-	   ))
-    (for-each add-pintype net)
-    output-list
-))
-
-
-;;
-;; Display pins of a specified type connected to a net
-;;
-;; type: number of the position of the type in the vector, or 
-;;       the string "all" to display all the pins.
-;; connections: ((U100 1) (U101 1)), for example.
-(define drc2:display-pins-of-type
-  (lambda (port type connections)
-    (if (not (null? connections))
-	(begin
-	  (let ((device (car (car connections)))
-		(pin (car (cdr (car connections)))))
-	    (if (or (and (string? type) (string-ci=? type "all"))
-		    (string-ci=? (list-ref pintype-names type)
-				 (gnetlist:get-attribute-by-pinnumber device pin "pintype"))
-		    )
-		(begin
-		  (display device port)
-		  (display ":" port)
-		  (display pin port)
-		  (display " " port)))
-	    (drc2:display-pins-of-type port type (cdr connections))
-	    ""
-	    )))))
-
-;;
-;; Check connection between two pintypes
-;;
-;; type1,type2: number of the position of the type in the vector.
-;; connections: ((U100 1) (U101 1)), for example.
-(define drc2:check-connection-of-two-pintypes
-  (lambda (port type1 type2 connections netname)
-    (let* (( drc-matrix-value (drc2:get-drc-matrix-element type1 type2)))
-      (cond
-       ((eqv? drc-matrix-value #\c) 1)
-       (else (if (and (not (eqv? drc-matrix-value #\e)) (not (eqv? drc-matrix-value #\w)))
-		 (begin
-		   (display "INTERNAL ERROR: DRC matrix has unknown value on position " port)
-		   (display type1 port)
-		   (display "," port)
-		   (display type2 port)
-		   (newline port)
-		   (error "INTERNAL ERROR: DRC matrix has unknown value. See output for more information"))
-		 
-		 (begin 
-		   (if (eqv? drc-matrix-value #\w) 
-		       (begin
-			 (display "WARNING: " port)
-			 (set! warnings_number (+ warnings_number 1)))
-		     (begin 
-		       (display "ERROR: " port)
-		       (set! errors_number (+ errors_number 1))
-		       ))	  
-		   (display "Pin(s) with pintype '" port)
-		   (display (drc2:get-full-name-of-pintype-by-number type1) port)
-		   (display "': " port)
-		   (display (drc2:display-pins-of-type port type1 
-							 connections) port)
-		   (display (string-append "\n\tare connected by net '" netname) port)
-                   (display "'\n\tto pin(s) with pintype '" port)
-		   (display (drc2:get-full-name-of-pintype-by-number type2) port)
-		   (display "': " port)
-		   (display (drc2:display-pins-of-type port type2
-							 connections) port)
-		   (newline port)
-		   )
-		 ))))))
-
-;;
-;; Check pintypes of the pins connected to a single net
-;;
-;; type1,type2: number of the position of the type in the vector.
-;; connections: ((U100 1) (U101 1)), for example.
-;; pintype-count: vector with the number of pins connected to a single net, by pintype.
-;;     (1 2 3 4 ... 10), for example.
-(define drc2:check-pintypes-of-single-net
-  (lambda (port connections pintypes pintype-count type1 type2 netname)
-    (define type1-count (list-ref pintype-count type1))
-    (define type2-count (list-ref pintype-count type2))
-    (define next-type1 
-      (lambda (port connections pintypes pintype-count type1 type2 netname)
-	(if (< type1 (- (length pintype-names) 2))
-	    (drc2:check-pintypes-of-single-net port connections pintypes pintype-count 
-						 (+ type1 1) (+ type1 1) netname)	
-	    )
-	))
-    (define next-type2
-      (lambda (port connections pintypes pintype-count type1 type2 netname)
-	(if (< type2 (- (length pintype-names) 2))
-	    (drc2:check-pintypes-of-single-net port connections pintypes pintype-count 
-						 type1 (+ type2 1) netname)
-	    (next-type1 port connections pintypes pintype-count type1 type1 netname)
-	    )))
-    
-					; Check type1 with type1 first
-    (if (= type1-count 0)
-					; if no pins of type1 connected, then continue with (+ type1 1)
-	(begin
-	  (next-type1 port connections pintypes pintype-count type1 type2 netname))
-	  
-    (if (= type1 type2)
-	(if (> type1-count 1)
-	    (begin
-	      (drc2:check-connection-of-two-pintypes port type1 type1 connections netname)
-	      (next-type2 port connections pintypes pintype-count type1 type2 netname)
-	      
-	      )
-	      (next-type2 port connections pintypes pintype-count type1 type2 netname))
-	(begin
-      (if (= type2-count 0)
-					; if no pins of type2 connected, then continue with (+ type2 1)
-	  (next-type2 port connections pintypes pintype-count type1 type2 netname)
-	  )
-      (if (and (> type1-count 0) (> type2-count 0))
-	  (begin	  
-					; Check connections between type1 and type2.
-	    (drc2:check-connection-of-two-pintypes port type1 type2 connections netname)
-					; and continue with the next type2 if within the limits
-	    (next-type2 port connections pintypes pintype-count type1 type2 netname)
-	    ))
-    )
-    ))))
-
-;; 
-;; Check if a net has a pintype which can drive the net.
-;;
-;; pintype-count: vector with the number of pins connected to a single net, by pintype.
-;;     (1 2 3 4 ... 10), for example.
-;; position: number of the position the function is checking.
-(define drc2:check-if-net-is-driven
-  (lambda (pintype-count position)
-    (if (< position (- (length pintype-names) 1))
-	(if (and (> (list-ref pintype-count position) 0)
-		 (= (list-ref pintype-can-drive position) 1))
-	    #t
-	    (drc2:check-if-net-is-driven pintype-count (+ position 1)))
-	#f)))
-
-;;
-;; Check pintype of the pins connected to every net in the design.
-;;
-;; all-nets: (net1 net2 net3), for example
-(define drc2:check-pintypes-of-nets
-  (lambda (port all-nets)
-      (if (not (null? all-nets))
-	  (let ((netname (car all-nets)))
-	    (begin	
-	      (let*  ( (connections (gnetlist:get-all-connections netname))
-		       (pintypes    (drc2:get-pintypes-of-net-connections 
-				     connections
-				     '()))
-		       (pintype-count (drc2:count-pintypes-of-net pintypes port))
-		       (directives (gnetlist:graphical-objs-in-net-with-attrib-get-attrib
-				    netname
-				    "device=DRC_Directive"
-				    "value"))
-		       )
-		; If some directives are defined, then it shouldn't be checked.
-		(if (not (member "DontCheckPintypes" directives))
-		    (drc2:check-pintypes-of-single-net port connections pintypes pintype-count 0 0 netname))
-		(if (not (defined? 'dont-check-not-driven-nets))
-		    (begin
-		      (if (and (not (member "DontCheckIfDriven" directives))
-			       (not (member "NoConnection" directives)))
-			  (if (eqv? (drc2:check-if-net-is-driven pintype-count 0) #f)
-			      (begin
-				(set! errors_number (+ errors_number 1))
-				(display "ERROR: Net " port)
-				(display netname port)
-				(display " is not driven." port)
-				(newline port)
-				))
-			  )
-		      ))
-		
-		)
-	      (drc2:check-pintypes-of-nets port (cdr all-nets))
-  )))
-))
-
-;;
-;; Check unconnected pins
-;;
-;; ref-list: ("U1" "U2"), for example.
-;; pin-net: ( (pin net) (pin net) ... )
-(define drc2:check-unconnected-pins
-  (lambda (port ref-list pin-net)
-    (define ref "")
-    (if (not (null? ref-list))
-	(begin
-	  (set! ref (car ref-list))
-	  (if (not (null? pin-net))
-	      (let* ( (pair (car pin-net)) 
-		      (pin (car pair)) 
-		      (connection (cdr pair))
-		      )
-		(begin
-		  (if (strncmp? connection "unconnected_pin" 15)
-		      (begin
-			(let* ((position (drc2:position-of-pintype 
-					  (gnetlist:get-attribute-by-pinnumber ref pin "pintype")))
-			       (drc-matrix-value (drc2:get-drc-matrix-element undefined position)))
-			  (begin
-			    (if (eqv? drc-matrix-value #\c)
-				#t
-				(begin
-				  (if (eqv? drc-matrix-value #\w) 
-				      (begin
-					(display "WARNING: " port)
-					(set! warnings_number (+ warnings_number 1)))
-				      (begin 
-					(display "ERROR: " port)
-					(set! errors_number (+ errors_number 1))
-					))	
-				  (display "Unconnected pin " port)
-				  (display ref port)
-				  (display ":" port)
-				  (display pin port)
-				  (newline port)
-				  (drc2:check-unconnected-pins port ref-list (cdr pin-net))
-				  ))
-			  ))
-			)
-		      (drc2:check-unconnected-pins port ref-list (cdr pin-net))
-		  )
-		))
-	      (if (> (length ref-list) 1)
-		  (drc2:check-unconnected-pins port (cdr ref-list) 
-					       (gnetlist:get-pins-nets (car (cdr ref-list)))))
-	    ))
-	)
-    ))
 
-; Report pins without the 'pintype' attribute (pintype=unknown)
-(define (drc2:report-unknown-pintypes port nets)
-  (define (count-unknown-pintypes nets)
-    (fold
-     (lambda (netname count)
-       (let* ((connections (gnetlist:get-all-connections netname))
-              (pintypes (drc2:get-pintypes-of-net-connections connections '()))
-              (pintype-count (drc2:count-pintypes-of-net pintypes port)))
-         (+ count
-            (list-ref pintype-count (drc2:position-of-pintype "unknown")))))
-     0 nets))
-  (define (display-unknown-pintypes nets)
-    (for-each
-     (lambda (netname)
-       (drc2:display-pins-of-type port
-                                  (drc2:position-of-pintype "unknown")
-                                  (gnetlist:get-all-connections netname)))
-     nets))
-  (and (> (count-unknown-pintypes nets) 0)
-       (begin
-         (display "NOTE: Found pins without the 'pintype' attribute: " port)
-         (display-unknown-pintypes nets)
-         (display "\n"))))
+;; Configuration of the checks, from the variables documented above.
+(define (drc2:configuration)
+  (list (cons 'drc-matrix drc-matrix)
+        (cons 'pintype-can-drive pintype-can-drive)
+        (cons 'action-unused-slots action-unused-slots)
+        (cons 'case-insensitive (defined? 'case_insensitive))
+        (cons 'check-not-driven-nets
+              (not (defined? 'dont-check-not-driven-nets)))))
+
+;; Run one check and add up the errors and warnings it found.
+;;
+;; check: one of non-numbered-parts, duplicated-references,
+;;        connected-noconnects, one-connection-nets, unknown-pintypes,
+;;        pintypes-of-nets, unconnected-pins, slots, duplicated-slots,
+;;        unused-slots.
+(define (drc2:run-check port check)
+  (let ((counts (gnetlist:drc2-check port check (drc2:configuration))))
+    (set! errors_number (+ errors_number (car counts)))
+    (set! warnings_number (+ warnings_number (cdr counts)))))
 
 ;
-;  End of Net checking functions
+;  End of checks
 ;-----------------------------------------------------------------------
 
 
@@ -934,7 +379,7 @@
 		(begin
 		  (display "Checking non-numbered parts..." port)
 		  (newline port)
-		  (drc2:check-non-numbered-items port packages)
+		  (drc2:run-check port 'non-numbered-parts)
 		  (newline port)))
 
 	    ;; Check for duplicated references   
@@ -942,7 +387,7 @@
 		(begin
 		  (display "Checking duplicated references..." port)
 		  (newline port)
-		  (drc2:check-duplicated-references port packages)
+		  (drc2:run-check port 'duplicated-references)
 		  (newline port)))
 
 	    ;; Check for NoConnection nets with more than one pin connected.
@@ -950,7 +395,7 @@
 		(begin
 		  (display "Checking NoConnection nets for connections..." port)
 		  (newline port)
-		  (drc2:check-connected-noconnects port (gnetlist:get-all-unique-nets "dummy"))
+		  (drc2:run-check port 'connected-noconnects)
 		  (newline port)))
 
 	    ;; Check nets with only one connection
@@ -958,7 +403,7 @@
 		(begin
 		  (display "Checking nets with only one connection..." port)
 		  (newline port)
-		  (drc2:check-single-nets port (gnetlist:get-all-unique-nets "dummy"))
+		  (drc2:run-check port 'one-connection-nets)
 		  (newline port)))
 
 	    ;; Check "unknown" pintypes
@@ -966,7 +411,7 @@
 		(begin
 		  (display "Checking pins without the 'pintype' attribute..." port)
 		  (newline port)
-		  (drc2:report-unknown-pintypes port (gnetlist:get-all-unique-nets "dummy"))
+		  (drc2:run-check port 'unknown-pintypes)
 		  (newline port)))
 	    
 	    ;; Check pintypes of the pins connected to every net
@@ -974,7 +419,7 @@
 		(begin
 		  (display "Checking type of pins connected to a net..." port)
 		  (newline port)
-		  (drc2:check-pintypes-of-nets port (gnetlist:get-all-unique-nets "dummy"))
+		  (drc2:run-check port 'pintypes-of-nets)
 		  (newline port)))
 	    
 	    ;; Check unconnected pins
@@ -982,8 +427,7 @@
 		(begin
 		  (display "Checking unconnected pins..." port)
 		  (newline port)
-		  (if (not (null? packages))
-		      (drc2:check-unconnected-pins port packages (gnetlist:get-pins-nets (car packages))))
+		  (drc2:run-check port 'unconnected-pins)
 		  (newline port)))
 
 	    ;; Check slots   
@@ -991,7 +435,7 @@
 		(begin
 		  (display "Checking slots..." port)
 		  (newline port)
-		  (drc2:check-slots port)
+		  (drc2:run-check port 'slots)
 		  (newline port)))
 
 	    ;; Check for duplicated slots   
@@ -999,7 +443,7 @@
 		(begin
 		  (display "Checking duplicated slots..." port)
 		  (newline port)
-		  (drc2:check-duplicated-slots port)
+		  (drc2:run-check port 'duplicated-slots)
 		  (newline port)))
 
 	    ;; Check for unused slots
@@ -1007,7 +451,7 @@
 		(begin
 		  (display "Checking unused slots..." port)
 		  (newline port)
-		  (drc2:check-unused-slots port)
+		  (drc2:run-check port 'unused-slots)
 		  (newline port)))
 
 	    ;; Display total number of warnings
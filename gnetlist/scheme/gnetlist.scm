@@ -119,6 +119,13 @@ values: ~A
 " refdes name values))
       value))
 
+;; Calls 'unique-attribute' as seen from the module of the backend
+;; being run.  When several backends are run, each is loaded into a
+;; module of its own, and a plain reference from here would always
+;; find the default resolver above rather than the backend's.
+(define (gnetlist:unique-attribute refdes name values)
+  ((module-ref (current-module) 'unique-attribute) refdes name values))
+
 (define (gnetlist:get-package-attribute refdes name)
   "Return the value associated with attribute NAME on package
 identified by REFDES.
@@ -140,12 +147,65 @@ value.
 
 Note that given the current load sequence of gnetlist, this
 customization can only happen in the backend itself or in a file
-loaded after the backend ('-m' option of gnetlist)."
+loaded after the backend ('-m' option of gnetlist).  When several
+backends are run at once, a redefinition only applies to the backend
+that makes it."
   (let* ((values (gnetlist:get-all-package-attributes refdes name))
          (value  (and (not (null? values))
-                      (unique-attribute refdes name values))))
+                      (gnetlist:unique-attribute refdes name values))))
     (or value "unknown")))
 
+(define (gnetlist:get-packages-attribute name)
+  "Return an association list mapping the refdes of every package to
+the value of attribute NAME on that package.
+
+This is equivalent to calling 'gnetlist:get-package-attribute' for
+each package returned by 'gnetlist:get-packages', in the same order,
+and honours any redefinition of 'unique-attribute' in the same way,
+but fetches the values for all packages from gnetlist in one call."
+  (map (lambda (entry)
+         (let* ((refdes (car entry))
+                (values (cdr entry))
+                (value  (and (not (null? values))
+                             (gnetlist:unique-attribute refdes name values))))
+           (cons refdes (or value "unknown"))))
+       (gnetlist:get-all-packages-attributes name)))
+
+;;
+;; Accessors for the structure returned by gnetlist:get-netlist-snapshot.
+;; The snapshot is built once and shared, so it must not be modified.
+;;
+(define (gnetlist:snapshot-packages snapshot)
+  "Return the vector of package records in SNAPSHOT."
+  (assq-ref snapshot 'packages))
+
+(define (gnetlist:snapshot-nets snapshot)
+  "Return the vector of net records in SNAPSHOT."
+  (assq-ref snapshot 'nets))
+
+(define (gnetlist:snapshot-package snapshot refdes)
+  "Return the package record for REFDES in SNAPSHOT, or #f."
+  (hash-ref (assq-ref snapshot 'package-table) refdes))
+
+(define (gnetlist:snapshot-net snapshot netname)
+  "Return the net record for NETNAME in SNAPSHOT, or #f."
+  (hash-ref (assq-ref snapshot 'net-table) netname))
+
+(define (gnetlist:package-record-refdes package) (vector-ref package 0))
+(define (gnetlist:package-record-pins package) (vector-ref package 2))
+(define (gnetlist:package-record-attribute package name)
+  "Return the list of values of attribute NAME on each instance of
+PACKAGE, as gnetlist:get-all-package-attributes does, except that the
+empty list is returned if no instance has the attribute at all."
+  (hash-ref (vector-ref package 1) name '()))
+
+(define (gnetlist:pin-record-number pin) (vector-ref pin 0))
+(define (gnetlist:pin-record-netname pin) (vector-ref pin 1))
+(define (gnetlist:pin-record-label pin) (vector-ref pin 2))
+
+(define (gnetlist:net-record-name net) (vector-ref net 0))
+(define (gnetlist:net-record-connections net) (vector-ref net 1))
+
 (define (gnetlist:get-slots refdes)
   "Return a sorted list of slots used by package REFDES.
 
@@ -171,6 +231,12 @@ REFDES. As a result, slots may be repeated in the returned list."
   "Return a sorted list of unique slots used by package REFDES."
   (delete-duplicates! (gnetlist:get-slots refdes)))
 
+(define (gnetlist:get-slot-pins refdes slot)
+  "Return the pin numbers of slot SLOT of package REFDES, in pinseq
+order, as given by its slotdef attribute.  An empty list is returned
+if the slot is not defined."
+  (or (assv-ref (gnetlist:get-slotdefs refdes) slot) '()))
+
 ;;
 ;; Given a uref, returns the device attribute value (unknown if not defined)
 ;;
@@ -0,0 +1,445 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file g_backend.c
+ * \brief Loading and running netlist backends.
+ *
+ * Several backends can be requested in one run with
+ * <tt>-g BACKEND:FILE</tt>.  When there is more than one, each backend
+ * is loaded into an anonymous module of its own, which inherits every
+ * binding of the current module, so that the definitions of one
+ * backend cannot clobber those of another.  A single backend is
+ * loaded straight into the current module, as it always has been.
+ *
+ * Backends that need the same traversal share it: the design is
+ * traversed once for every distinct combination of netlist mode
+ * (spice backends number unnamed nets differently) and \c get-uref
+ * procedure (which a backend may redefine), and then every backend in
+ * the group is run against the same post-processed netlist, optionally
+ * each in a process of its own (see \c --fork-backends).
+ *
+ * Backends built into gnetlist (see s_native.c) have no Scheme file to
+ * load and are run by calling into C, but are otherwise treated like
+ * any other backend.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+#if defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+#define CAN_FORK_BACKENDS 1
+#endif
+
+/*! A backend requested on the command line. */
+typedef struct {
+  char *name;       /* backend name, e.g. "PCB" */
+  char *output;     /* output filename, or NULL for the -o filename */
+  SCM module;       /* module the backend was loaded into */
+  int native;       /* TRUE for a built-in backend (see s_native.c) */
+  int mode;         /* netlist mode the backend expects */
+  int traversal;    /* index of the traversal the backend shares */
+} BACKEND;
+
+/*! Requested backends, in command line order. */
+static GPtrArray *backends = NULL;
+
+/*! Number of distinct traversals the backends need. */
+static int n_traversals = 0;
+
+/*! \brief Request a backend.
+ *  \par Function Description
+ *  Called for each <tt>-g</tt> option.  \a spec is either a backend
+ *  name, or a backend name and an output filename separated by a
+ *  colon.
+ *
+ *  \param [in] spec  The argument of the <tt>-g</tt> option.
+ */
+void
+g_backend_add (const char *spec)
+{
+  BACKEND *backend;
+  const char *colon;
+
+  if (backends == NULL) {
+    backends = g_ptr_array_new ();
+  }
+
+  backend = g_new0 (BACKEND, 1);
+
+  colon = strchr (spec, ':');
+  if (colon != NULL) {
+    backend->name = g_strndup (spec, colon - spec);
+    backend->output = g_strdup (colon + 1);
+  } else {
+    backend->name = g_strdup (spec);
+    backend->output = NULL;
+  }
+
+  /* this is a kludge to make sure that spice mode gets set */
+  /*  Hacked by SDB to allow spice netlisters of arbitrary name
+   *        as long as they begin with "spice".  For example, this spice
+   *  netlister is valid: "spice-sdb".
+   */
+  backend->mode = (strncmp (backend->name, "spice", 5) == 0) ? SPICE : gEDA;
+  backend->module = SCM_BOOL_F;
+  backend->native = s_native_is_backend (backend->name);
+
+  g_ptr_array_add (backends, backend);
+}
+
+/*! \brief Get the number of requested backends.
+ *  \return The number of <tt>-g</tt> options given.
+ */
+int
+g_backend_count (void)
+{
+  return (backends != NULL) ? backends->len : 0;
+}
+
+/*! \brief Free the list of requested backends. */
+void
+g_backend_free_all (void)
+{
+  guint i;
+
+  if (backends == NULL) return;
+
+  for (i = 0; i < backends->len; i++) {
+    BACKEND *backend = g_ptr_array_index (backends, i);
+
+    if (scm_is_true (backend->module)) {
+      scm_gc_unprotect_object (backend->module);
+    }
+    g_free (backend->name);
+    g_free (backend->output);
+    g_free (backend);
+  }
+
+  g_ptr_array_free (backends, TRUE);
+  backends = NULL;
+}
+
+/*! \brief Make a module for a backend.
+ *  \par Function Description
+ *  Returns a new anonymous module which uses the current module, so
+ *  that the backend sees the gnetlist procedures and anything loaded
+ *  with <tt>-l</tt>, but its own definitions stay private.
+ */
+static SCM
+g_backend_new_module (void)
+{
+  SCM module;
+
+  module = scm_call_0 (scm_variable_ref (scm_c_lookup ("make-module")));
+  scm_call_2 (scm_variable_ref (scm_c_lookup ("module-use!")),
+              module, scm_current_module ());
+
+  return module;
+}
+
+/*! \brief Get the get-uref procedure a backend's traversal would use. */
+static SCM
+g_backend_get_uref (BACKEND *backend)
+{
+  SCM var = scm_module_variable (backend->module,
+                                 scm_from_utf8_symbol ("get-uref"));
+
+  return scm_is_true (var) ? scm_variable_ref (var) : SCM_BOOL_F;
+}
+
+/*! \brief Work out which backends can share a traversal. */
+static void
+g_backend_group (void)
+{
+  guint i, j;
+
+  n_traversals = 0;
+
+  for (i = 0; i < backends->len; i++) {
+    BACKEND *backend = g_ptr_array_index (backends, i);
+
+    backend->traversal = -1;
+    for (j = 0; j < i; j++) {
+      BACKEND *other = g_ptr_array_index (backends, j);
+
+      if (other->mode == backend->mode
+          && scm_is_eq (g_backend_get_uref (other),
+                        g_backend_get_uref (backend))) {
+        backend->traversal = other->traversal;
+        break;
+      }
+    }
+
+    if (backend->traversal < 0) {
+      backend->traversal = n_traversals++;
+    }
+  }
+}
+
+/*! \brief Load all requested backends.
+ *  \par Function Description
+ *  Finds and loads the Scheme file of each requested backend, then
+ *  evaluates the expressions given with <tt>-m</tt> in its module.
+ *  Exits if a backend cannot be found, or if several backends would
+ *  write to the same default output file.
+ *
+ *  \param [in] argv0  Program name, for error messages.
+ */
+void
+g_backend_load_all (const char *argv0)
+{
+  guint i;
+
+  for (i = 0; i < backends->len; i++) {
+    BACKEND *backend = g_ptr_array_index (backends, i);
+    SCM s_backend_path = SCM_BOOL_F;
+    SCM old_module;
+    char *str;
+
+    if (backends->len > 1 && backend->output == NULL) {
+      fprintf (stderr,
+               "ERROR: No output file given for backend `%s'.\n"
+               "When several backends are used, give each its own output "
+               "file with -g %s:FILE.\n",
+               backend->name, backend->name);
+      exit (1);
+    }
+
+    /* Search for backend scm file in load path */
+    if (!backend->native) {
+      str = g_strdup_printf("gnet-%s.scm", backend->name);
+      s_backend_path = scm_sys_search_load_path (scm_from_locale_string (str));
+      g_free (str);
+    }
+
+    /* If it couldn't be found, fail. */
+    if (!backend->native && scm_is_false (s_backend_path)) {
+      fprintf (stderr, "ERROR: Could not find backend `%s' in load path.\n",
+               backend->name);
+      fprintf (stderr,
+               "\nRun `%s --list-backends' for a full list of available backends.\n",
+               argv0);
+      exit (1);
+    }
+
+    if (backends->len > 1) {
+      backend->module = g_backend_new_module ();
+    } else {
+      backend->module = scm_current_module ();
+    }
+    scm_gc_protect_object (backend->module);
+
+    s_stats_phase_begin ("backend-load", backend->name);
+    old_module = scm_set_current_module (backend->module);
+
+    /* Load backend code.  Built-in backends have none, but still get
+     * a module for the -m expressions (which may redefine get-uref). */
+    if (!backend->native) {
+      scm_primitive_load (s_backend_path);
+    }
+
+    /* Evaluate second set of Scheme expressions. */
+    scm_eval (post_backend_list, backend->module);
+
+    scm_set_current_module (old_module);
+    s_stats_phase_end ();
+  }
+
+  g_backend_group ();
+}
+
+/*! \brief Run one backend. */
+static void
+g_backend_run (BACKEND *backend)
+{
+  SCM old_module;
+  SCM proc;
+  const char *output;
+
+  output = (backend->output != NULL) ? backend->output : output_filename;
+
+  if (!quiet_mode && backends->len > 1) {
+    printf ("Running backend [%s] to [%s]\n", backend->name, output);
+  }
+
+  s_stats_phase_begin ("backend", backend->name);
+  if (backend->native) {
+    s_native_run (backend->name, output);
+  } else {
+    old_module = scm_set_current_module (backend->module);
+    proc = scm_variable_ref (scm_c_lookup (backend->name));
+    scm_call_1 (proc, scm_from_locale_string (output));
+    scm_set_current_module (old_module);
+  }
+  s_stats_phase_end ();
+}
+
+#ifdef CAN_FORK_BACKENDS
+/*! \brief Run the backends of a traversal in child processes.
+ *  \return The number of backends which failed.
+ */
+static int
+g_backend_run_forked (int traversal)
+{
+  GArray *children;
+  int failed = 0;
+  guint i;
+
+  /* Don't let buffered output be written twice */
+  scm_flush_all_ports ();
+  fflush (NULL);
+
+  children = g_array_new (FALSE, FALSE, sizeof (pid_t));
+
+  /* The phases of the children are not seen here, so time them as one */
+  s_stats_phase_begin ("backend", "(forked)");
+
+  for (i = 0; i < backends->len; i++) {
+    BACKEND *backend = g_ptr_array_index (backends, i);
+    pid_t pid;
+
+    if (backend->traversal != traversal) continue;
+
+    pid = fork ();
+    if (pid == 0) {
+      g_backend_run (backend);
+      scm_flush_all_ports ();
+      fflush (NULL);
+      _exit (0);
+    }
+
+    if (pid < 0) {
+      /* Could not fork, so do it ourselves */
+      g_backend_run (backend);
+      continue;
+    }
+
+    g_array_append_val (children, pid);
+  }
+
+  for (i = 0; i < children->len; i++) {
+    int status;
+
+    if (waitpid (g_array_index (children, pid_t, i), &status, 0) < 0
+        || !WIFEXITED (status) || WEXITSTATUS (status) != 0) {
+      failed++;
+    }
+  }
+
+  s_stats_phase_end ();
+  g_array_free (children, TRUE);
+
+  return failed;
+}
+#endif
+
+/*! \brief Traverse the design and run every requested backend.
+ *  \par Function Description
+ *  For each group of backends that can share a traversal, traverses
+ *  the loaded schematics, loads gnetlist-post.scm and runs the
+ *  backends of the group in command line order.  If
+ *  <tt>--fork-backends</tt> was given, the backends of a group run in
+ *  parallel, each in a child process forked after traversal.
+ *
+ *  \param [in] pr_current  The current #TOPLEVEL structure.
+ *  \param [in] cwd         Directory to return to after traversal.
+ *  \return The number of backends which failed.
+ */
+int
+g_backend_run_all (TOPLEVEL *pr_current, const char *cwd)
+{
+  int failed = 0;
+  int traversal;
+  guint i;
+
+  for (traversal = 0; traversal < n_traversals; traversal++) {
+    BACKEND *first = NULL;
+    SCM old_module;
+    int n_backends = 0;
+
+    for (i = 0; i < backends->len; i++) {
+      BACKEND *backend = g_ptr_array_index (backends, i);
+      if (backend->traversal != traversal) continue;
+      if (first == NULL) first = backend;
+      n_backends++;
+    }
+
+    if (traversal > 0) {
+      s_traverse_reset ();
+    }
+
+    /* Traverse with the backend's netlist mode and get-uref */
+    netlist_mode = first->mode;
+    old_module = scm_set_current_module (first->module);
+    s_traverse_init ();
+    s_traverse_start (pr_current);
+    scm_set_current_module (old_module);
+
+    /* Change back to the directory where we started AGAIN.  This is done */
+    /* because the s_traverse functions can change the Current Working Directory. */
+    if (chdir (cwd) != 0) {
+      fprintf (stderr, "ERROR: Could not change back to directory [%s]\n",
+               cwd);
+    }
+
+    /* Run post-traverse code. */
+    s_stats_phase_begin ("post-process", "gnetlist-post.scm");
+    scm_primitive_load_path (scm_from_utf8_string ("gnetlist-post.scm"));
+    s_stats_phase_end ();
+
+#ifdef CAN_FORK_BACKENDS
+    if (fork_backends && n_backends > 1) {
+      failed += g_backend_run_forked (traversal);
+      continue;
+    }
+#endif
+
+    for (i = 0; i < backends->len; i++) {
+      BACKEND *backend = g_ptr_array_index (backends, i);
+      if (backend->traversal != traversal) continue;
+      g_backend_run (backend);
+    }
+  }
+
+  return failed;
+}
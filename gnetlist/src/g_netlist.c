@@ -69,7 +69,7 @@ SCM g_get_packages(SCM level)
         if (g_hash_table_lookup (ht, nl_current->component_uref) == NULL) {
           g_hash_table_insert (ht, nl_current->component_uref,
                                    nl_current->component_uref);
-          list = scm_cons (scm_from_utf8_string (nl_current->component_uref),
+          list = scm_cons (s_intern_string (nl_current->component_uref),
                            list);
         }
       }
@@ -91,7 +91,7 @@ SCM g_get_non_unique_packages(SCM level)
     for (nl_current = netlist_head; nl_current != NULL;
          nl_current = nl_current->next) {
       if (nl_current->component_uref != NULL) {
-        list = scm_cons (scm_from_utf8_string (nl_current->component_uref),
+        list = scm_cons (s_intern_string (nl_current->component_uref),
                          list);
       }
     }
@@ -124,7 +124,7 @@ SCM g_get_pins(SCM scm_uref)
 		pl_current = nl_current->cpins;
 		while (pl_current != NULL) {
 		    if (pl_current->pin_number) {
-              list = scm_cons (scm_from_utf8_string (pl_current->pin_number),
+              list = scm_cons (s_intern_string (pl_current->pin_number),
                                list);
 		    }
 		    pl_current = pl_current->next;
@@ -170,7 +170,7 @@ SCM g_get_all_nets(SCM scm_level)
 		    printf("Got net: `%s'\n", net_name);
 		    printf("pin %s\n", pl_current->pin_number);
 #endif
-		    list = scm_cons (scm_from_utf8_string (net_name),
+		    list = scm_cons (s_intern_string (net_name),
                                      list);
 		}
 	    }
@@ -184,63 +184,18 @@ SCM g_get_all_nets(SCM scm_level)
 
 SCM g_get_all_unique_nets(SCM scm_level)
 {
-
-    SCM list = SCM_EOL;
-    SCM x = SCM_EOL;
-    NETLIST *nl_current;
-    CPINLIST *pl_current;
-    char *net_name;
-
     SCM_ASSERT(scm_is_string (scm_level), scm_level, SCM_ARG1, 
 	       "gnetlist:get-all-unique-nets");
 
-    nl_current = netlist_head;
-
-    /* walk through the list of components, and through the list
-     * of individual pins on each, adding net names to the list
-     * being careful to ignore duplicates, and unconnected pins 
-     */
-    while (nl_current != NULL) {
-	pl_current = nl_current->cpins;
-	while (pl_current != NULL) {
-	    if (pl_current->net_name) {
-
-		net_name = pl_current->net_name;
-		/* filter off unconnected pins */
-		if (strncmp(net_name, "unconnected_pin", 15) != 0) {
-		    /* add the net name to the list */
-		    /*printf("Got net: `%s'\n",net_name); */
-
-		    x = scm_from_utf8_string (net_name);
-		    if (scm_is_false (scm_member (x, list))) {
-              list = scm_cons (x, list);
-		    }
-		}
-	    }
-	    pl_current = pl_current->next;
-	}
-	nl_current = nl_current->next;
-    }
-
-    return list;
+    /* the list is computed once from the net index and then copied */
+    return s_netindex_unique_nets_list ();
 }
 
 /* given a net name, return all connections */
 SCM g_get_all_connections(SCM scm_netname)
 {
-
-    SCM list = SCM_EOL;
-    SCM x = SCM_EOL;
-    SCM is_member = SCM_EOL;
-    SCM connlist = SCM_EOL;
-    SCM pairlist = SCM_EOL;
-    NETLIST *nl_current;
-    CPINLIST *pl_current;
-    NET *n_current;
+    SCM connlist;
     char *wanted_net_name;
-    char *net_name;
-    char *pin;
-    char *uref;
 
     SCM_ASSERT(scm_is_string(scm_netname), scm_netname, SCM_ARG1, 
 	       "gnetlist:get-all-connections");
@@ -248,69 +203,11 @@ SCM g_get_all_connections(SCM scm_netname)
     wanted_net_name = scm_to_utf8_string (scm_netname);
 
     if (wanted_net_name == NULL) {
-	return list;
+	return SCM_EOL;
     }
 
-
-    nl_current = netlist_head;
-
-    /* walk through the list of components, and through the list
-     * of individual pins on each, adding net names to the list
-     * being careful to ignore duplicates, and unconnected pins 
-     */
-    while (nl_current != NULL) {
-	pl_current = nl_current->cpins;
-	while (pl_current != NULL) {
-	    if (pl_current->net_name) {
-
-		net_name = pl_current->net_name;
-		/* filter off unconnected pins */
-		if (strcmp(net_name, wanted_net_name) == 0) {
-		    /* add the net name to the list */
-
-#if DEBUG
-		    printf("found net: `%s'\n", net_name);
-#endif
-
-		    n_current = pl_current->nets;
-		    while (n_current != NULL) {
-
-			if (n_current->connected_to) {
-
-			    pairlist = SCM_EOL;
-			    pin = (char *) g_malloc(sizeof(char) *
-						  strlen(n_current->
-							 connected_to));
-			    uref =
-				(char *) g_malloc(sizeof(char) *
-						strlen(n_current->
-						       connected_to));
-
-			    sscanf(n_current->connected_to,
-				   "%s %s", uref, pin);
-
-			    pairlist = scm_list_n (scm_from_utf8_string (uref),
-                                       scm_from_utf8_string (pin),
-                                       SCM_UNDEFINED);
-
-			    x = pairlist;
-			    is_member = scm_member(x, connlist);
-
-			    if (scm_is_false (is_member)) {
-				connlist = scm_cons (pairlist, connlist);
-			    }
-
-			    g_free(uref);
-			    g_free(pin);
-			}
-			n_current = n_current->next;
-		    }
-		}
-	    }
-	    pl_current = pl_current->next;
-	}
-	nl_current = nl_current->next;
-    }
+    /* the list is computed once from the net index and then copied */
+    connlist = s_netindex_connections_list (wanted_net_name);
 
     free (wanted_net_name);
     return connlist;
@@ -375,21 +272,10 @@ SCM g_get_nets(SCM scm_uref, SCM scm_pin)
 
         if (!n_current->connected_to) continue;
 
-        pairlist = SCM_EOL;
-        pin = (char *) g_malloc(sizeof(char) *
-                                strlen
-                                (n_current->
-                                 connected_to));
-        uref =
-          (char *) g_malloc(sizeof(char) *
-                            strlen(n_current->
-                                   connected_to));
-
-        sscanf(n_current->connected_to,
-               "%s %s", uref, pin);
-
-        pairlist = scm_list_n (scm_from_utf8_string (uref),
-                               scm_from_utf8_string (pin),
+        s_netindex_split_connected_to (n_current->connected_to, &uref, &pin);
+
+        pairlist = scm_list_n (s_intern_string (uref),
+                               s_intern_string (pin),
                                SCM_UNDEFINED);
 
         pinslist = scm_cons (pairlist, pinslist);
@@ -401,7 +287,7 @@ SCM g_get_nets(SCM scm_uref, SCM scm_pin)
   }
 
   if (net_name != NULL) {
-    outerlist = scm_cons (scm_from_utf8_string (net_name), pinslist);
+    outerlist = scm_cons (s_intern_string (net_name), pinslist);
   } else {
     outerlist = scm_cons (scm_from_utf8_string ("ERROR_INVALID_PIN"),
                           outerlist);
@@ -453,8 +339,8 @@ SCM g_get_pins_nets(SCM scm_uref)
 			    pin = pl_current->pin_number;
 			    net_name = pl_current->net_name;
 
-			    pairlist = scm_cons (scm_from_utf8_string (pin),
-                                                 scm_from_utf8_string (net_name));
+			    pairlist = scm_cons (s_intern_string (pin),
+                                                 s_intern_string (net_name));
 			    pinslist = scm_cons (pairlist, pinslist);
 			}
 
@@ -491,8 +377,7 @@ SCM g_get_pins_nets(SCM scm_uref)
  */
 SCM g_get_all_package_attributes(SCM scm_uref, SCM scm_wanted_attrib)
 {
-    SCM ret = SCM_EOL;
-    NETLIST *nl_current;
+    SCM ret;
     char *uref;
     char *wanted_attrib;
 
@@ -505,30 +390,63 @@ SCM g_get_all_package_attributes(SCM scm_uref, SCM scm_wanted_attrib)
     uref          = scm_to_utf8_string (scm_uref);
     wanted_attrib = scm_to_utf8_string (scm_wanted_attrib);
 
-    /* here is where you make it multi page aware */
-    nl_current = netlist_head;
+    /* the values of every instance of uref come from the package table */
+    ret = s_package_attribute_values (uref, wanted_attrib);
 
-    /* search for uref instances and through the entire list */
-    while (nl_current != NULL) {
+    free (uref);
+    free (wanted_attrib);
 
-	if (nl_current->component_uref) {
-	    if (strcmp(nl_current->component_uref, uref) == 0) {
-		char *value =
-		    o_attrib_search_object_attribs_by_name (nl_current->object_ptr,
-		                                            wanted_attrib, 0);
+    return ret;
+}
 
-		ret = scm_cons (value ? scm_from_utf8_string (value) : SCM_BOOL_F, ret);
+/*! \brief Get attribute values from all packages.
+ *  \par Function Description
+ *  Bulk version of g_get_all_package_attributes(): returns an
+ *  association list mapping every package reference to the list of
+ *  values that gnetlist:get-all-package-attributes would return for
+ *  it.  Packages are in the same order as gnetlist:get-packages.
+ *
+ *  \param [in] scm_wanted_attrib  Attribute name.
+ *  \return An association list of (refdes . values) pairs.
+ */
+SCM g_get_all_packages_attributes(SCM scm_wanted_attrib)
+{
+    SCM ret;
+    char *wanted_attrib;
 
-		g_free (value);
-	    }
-	}
-	nl_current = nl_current->next;
-    }
+    SCM_ASSERT(scm_is_string (scm_wanted_attrib),
+	       scm_wanted_attrib, SCM_ARG1, "gnetlist:get-all-packages-attributes");
 
-    free (uref);
+    wanted_attrib = scm_to_utf8_string (scm_wanted_attrib);
+    ret = s_package_all_attribute_values (wanted_attrib);
     free (wanted_attrib);
 
-    return scm_reverse_x (ret, SCM_EOL);
+    return ret;
+}
+
+/*! \brief Get the slot table of a package.
+ *  \par Function Description
+ *  Returns the parsed slotdef= attributes of the package with the
+ *  given refdes, as an association list from slot number to the list
+ *  of pin numbers of that slot (the first for pinseq=1, and so on),
+ *  sorted by slot number.
+ *
+ *  \param [in] scm_uref  Package reference.
+ *  \return An association list, empty if the package is not slotted.
+ */
+SCM g_get_slotdefs(SCM scm_uref)
+{
+    SCM ret;
+    char *uref;
+
+    SCM_ASSERT(scm_is_string (scm_uref),
+	       scm_uref, SCM_ARG1, "gnetlist:get-slotdefs");
+
+    uref = scm_to_utf8_string (scm_uref);
+    ret = s_package_slotdefs (uref);
+    free (uref);
+
+    return ret;
 }
 
 /* takes a uref and pinseq number and returns wanted_attribute associated */
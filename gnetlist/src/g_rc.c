@@ -94,6 +94,24 @@ SCM g_rc_hierarchy_traversal(SCM mode)
                    2);
 }
 
+SCM g_rc_hierarchy_sheet_cache(SCM mode)
+{
+  static const vstbl_entry mode_table[] = {
+    {TRUE, "enabled"},
+    {FALSE, "disabled"}
+  };
+
+  RETURN_G_RC_MODE("hierarchy-sheet-cache",
+                   default_hierarchy_sheet_cache, 2);
+}
+
+/*! \todo Finish function description!!!
+ *  \brief
+ *  \par Function Description
+ *
+ *  \param [in] mode
+ *  \return SCM_BOOL_T always.
+ */
 SCM g_rc_hierarchy_uref_mangle(SCM mode)
 {
   static const vstbl_entry mode_table[] = {
@@ -22,6 +22,9 @@
 
 #include <stdio.h>
 #include <sys/stat.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
@@ -59,6 +62,7 @@ static struct gsubr_t gnetlist_funcs[] = {
     
   { "net-naming-priority",          1, 0, 0, g_rc_net_naming_priority },
   { "hierarchy-traversal",          1, 0, 0, g_rc_hierarchy_traversal },
+  { "hierarchy-sheet-cache",        1, 0, 0, g_rc_hierarchy_sheet_cache },
   { "hierarchy-uref-mangle",        1, 0, 0, g_rc_hierarchy_uref_mangle },
   { "hierarchy-netname-mangle",     1, 0, 0, g_rc_hierarchy_netname_mangle },
   { "hierarchy-netattrib-mangle",   1, 0, 0, g_rc_hierarchy_netattrib_mangle },
@@ -80,8 +84,11 @@ static struct gsubr_t gnetlist_funcs[] = {
   { "gnetlist:get-all-connections", 1, 0, 0, g_get_all_connections },
   { "gnetlist:get-nets",            2, 0, 0, g_get_nets },
   { "gnetlist:get-pins-nets",       1, 0, 0, g_get_pins_nets },
+  { "gnetlist:get-netlist-snapshot", 0, 0, 0, g_get_netlist_snapshot },
 
   { "gnetlist:get-all-package-attributes", 2, 0, 0, g_get_all_package_attributes },
+  { "gnetlist:get-all-packages-attributes", 1, 0, 0, g_get_all_packages_attributes },
+  { "gnetlist:get-slotdefs",        1, 0, 0, g_get_slotdefs },
   { "gnetlist:get-toplevel-attribute", 1, 0, 0, g_get_toplevel_attribute },
   /* { "gnetlist:set-netlist-mode", 1, 0, 0, g_set_netlist_mode }, no longer needed */
   { "gnetlist:get-renamed-nets",    1, 0, 0, g_get_renamed_nets },
@@ -91,6 +98,7 @@ static struct gsubr_t gnetlist_funcs[] = {
 
   { "gnetlist:graphical-objs-in-net-with-attrib-get-attrib",    
     3, 0, 0, g_graphical_objs_in_net_with_attrib_get_attrib },
+  { "gnetlist:drc2-check",          3, 0, 0, g_drc2_check },
 
   /* SDB -- 9.1.2003 */
   { "gnetlist:get-backend-arguments", 0, 0, 0, g_get_backend_arguments },
@@ -98,6 +106,33 @@ static struct gsubr_t gnetlist_funcs[] = {
   { NULL,                           0, 0, 0, NULL } };
 
 
+/*! \brief Count the calls of the gnetlist primitives.
+ *  \par Function Description
+ *  Replaces each \c gnetlist: procedure with a wrapper which counts
+ *  its calls (see g_stats_count_call()) and then calls the primitive.
+ *  Only used with <tt>--stats</tt>, so that normal runs pay nothing.
+ */
+static void g_register_count_calls(void)
+{
+  struct gsubr_t *tmp;
+  char *expr;
+
+  scm_c_define_gsubr ("%gnetlist-count-call", 1, 0, 0, g_stats_count_call);
+
+  for (tmp = gnetlist_funcs; tmp->name != NULL; tmp++) {
+    if (strncmp (tmp->name, "gnetlist:", 9) != 0) continue;
+
+    expr = g_strdup_printf ("(define %s"
+                            "  (let ((proc %s))"
+                            "    (lambda args"
+                            "      (%%gnetlist-count-call \"%s\")"
+                            "      (apply proc args))))",
+                            tmp->name, tmp->name, tmp->name);
+    scm_c_eval_string (expr);
+    g_free (expr);
+  }
+}
+
 void g_register_funcs(void)
 {
   struct gsubr_t *tmp = gnetlist_funcs;
@@ -107,6 +142,9 @@ void g_register_funcs(void)
     tmp++;
   }
 
+  if (stats_mode) {
+    g_register_count_calls ();
+  }
 }
 
 SCM g_quit(void)
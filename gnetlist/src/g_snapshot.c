@@ -0,0 +1,254 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file g_snapshot.c
+ * \brief Whole-netlist snapshot for Scheme backends.
+ *
+ * Backends traditionally rebuild the design from many small
+ * `gnetlist:' primitive calls.  gnetlist:get-netlist-snapshot instead
+ * hands them the complete post-processed netlist as one Scheme data
+ * structure, built once, in which every string (refdes, pin number,
+ * net name, attribute name or value) comes from s_intern_string(), so
+ * that equal strings share their characters.
+ *
+ * The snapshot is an association list with the following keys:
+ *
+ *  - \c packages: a vector of package records, in the same order as
+ *    gnetlist:get-packages.
+ *  - \c nets: a vector of net records, in the same order as
+ *    gnetlist:get-all-unique-nets.
+ *  - \c package-table: a hash table from refdes to package record.
+ *  - \c net-table: a hash table from net name to net record.
+ *
+ * A package record is a vector <tt>#(REFDES ATTRIBUTES PINS)</tt>:
+ * ATTRIBUTES is a hash table from attribute name to the list of values
+ * gnetlist:get-all-package-attributes would return, and PINS is a
+ * vector of pin records <tt>#(PINNUMBER NETNAME PINLABEL)</tt> in the
+ * same order as gnetlist:get-pins-nets (NETNAME and PINLABEL may be
+ * #f).
+ *
+ * A net record is a vector <tt>#(NAME CONNECTIONS)</tt>, where
+ * CONNECTIONS is the list of <tt>(REFDES PINNUMBER)</tt> lists that
+ * gnetlist:get-all-connections would return.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! The cached snapshot, or SCM_UNDEFINED. */
+static SCM snapshot = SCM_UNDEFINED;
+
+static void
+g_snapshot_free_array (gpointer array)
+{
+  g_ptr_array_free (array, TRUE);
+}
+
+/*! \brief Group the pins of the netlist by refdes.
+ *  \return A table from refdes to a GPtrArray of CPINLIST pointers, in
+ *  gnetlist:get-pins-nets order.
+ */
+static GHashTable *
+g_snapshot_collect_pins (NETLIST *head)
+{
+  GHashTable *pins;
+  NETLIST *nl_current;
+  CPINLIST *pl_current;
+
+  pins = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                g_snapshot_free_array);
+
+  for (nl_current = head; nl_current != NULL; nl_current = nl_current->next) {
+    GPtrArray *array;
+
+    if (nl_current->component_uref == NULL) continue;
+
+    array = g_hash_table_lookup (pins, nl_current->component_uref);
+    if (array == NULL) {
+      array = g_ptr_array_new ();
+      g_hash_table_insert (pins, nl_current->component_uref, array);
+    }
+
+    for (pl_current = nl_current->cpins;
+         pl_current != NULL;
+         pl_current = pl_current->next) {
+      if (pl_current->pin_number != NULL) {
+        g_ptr_array_add (array, pl_current);
+      }
+    }
+  }
+
+  return pins;
+}
+
+static SCM
+g_snapshot_package (const char *refdes,
+                    GPtrArray *cpins)
+{
+  SCM attribs;
+  SCM pins;
+  GList *names;
+  GList *iter;
+  guint n_instances;
+  guint i;
+
+  names = s_package_attribute_names (refdes);
+  n_instances = s_package_instance_count (refdes);
+
+  attribs = scm_c_make_hash_table (g_list_length (names) + 1);
+  for (iter = names; iter != NULL; iter = g_list_next (iter)) {
+    SCM values = SCM_EOL;
+    int n;
+
+    for (n = n_instances - 1; n >= 0; n--) {
+      const char *value = s_package_instance_attribute (refdes, n, iter->data);
+      values = scm_cons (s_intern_string (value), values);
+    }
+    scm_hash_set_x (attribs, s_intern_string (iter->data), values);
+  }
+  g_list_free (names);
+
+  pins = scm_c_make_vector ((cpins != NULL) ? cpins->len : 0, SCM_BOOL_F);
+  for (i = 0; cpins != NULL && i < cpins->len; i++) {
+    CPINLIST *pin = g_ptr_array_index (cpins, i);
+    SCM record = scm_c_make_vector (3, SCM_BOOL_F);
+
+    scm_c_vector_set_x (record, 0, s_intern_string (pin->pin_number));
+    scm_c_vector_set_x (record, 1, s_intern_string (pin->net_name));
+    scm_c_vector_set_x (record, 2, s_intern_string (pin->pin_label));
+    scm_c_vector_set_x (pins, i, record);
+  }
+
+  return scm_vector (scm_list_3 (s_intern_string (refdes),
+                                 attribs, pins));
+}
+
+static SCM
+g_snapshot_net (const char *net_name)
+{
+  SCM connections = SCM_EOL;
+  guint n;
+  guint i;
+
+  n = s_netindex_connection_count (net_name);
+  for (i = 0; i < n; i++) {
+    const char *uref;
+    const char *pin;
+
+    s_netindex_nth_connection (net_name, i, &uref, &pin);
+    connections = scm_cons (scm_list_2 (s_intern_string (uref),
+                                        s_intern_string (pin)),
+                            connections);
+  }
+
+  return scm_vector (scm_list_2 (s_intern_string (net_name),
+                                 connections));
+}
+
+static SCM
+g_snapshot_build (void)
+{
+  GHashTable *pins;
+  SCM packages, package_table;
+  SCM nets, net_table;
+  guint n_packages, n_nets;
+  guint i;
+
+  pins = g_snapshot_collect_pins (netlist_head);
+
+  n_packages = s_package_count ();
+  packages = scm_c_make_vector (n_packages, SCM_BOOL_F);
+  package_table = scm_c_make_hash_table (n_packages + 1);
+  for (i = 0; i < n_packages; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    SCM record = g_snapshot_package (refdes,
+                                     g_hash_table_lookup (pins, refdes));
+
+    scm_c_vector_set_x (packages, i, record);
+    scm_hash_set_x (package_table, scm_c_vector_ref (record, 0), record);
+  }
+
+  /* the index numbers nets in order of first appearance, but
+   * gnetlist:get-all-unique-nets returns them the other way round */
+  n_nets = s_netindex_net_count ();
+  nets = scm_c_make_vector (n_nets, SCM_BOOL_F);
+  net_table = scm_c_make_hash_table (n_nets + 1);
+  for (i = 0; i < n_nets; i++) {
+    SCM record = g_snapshot_net (s_netindex_nth_net (i));
+
+    scm_c_vector_set_x (nets, n_nets - 1 - i, record);
+    scm_hash_set_x (net_table, scm_c_vector_ref (record, 0), record);
+  }
+
+  g_hash_table_destroy (pins);
+
+  return scm_list_4 (scm_cons (scm_from_utf8_symbol ("packages"), packages),
+                     scm_cons (scm_from_utf8_symbol ("nets"), nets),
+                     scm_cons (scm_from_utf8_symbol ("package-table"),
+                               package_table),
+                     scm_cons (scm_from_utf8_symbol ("net-table"), net_table));
+}
+
+/*! \brief Get a snapshot of the whole netlist.
+ *  \par Function Description
+ *  Returns the post-processed netlist as a single Scheme data
+ *  structure, described at the top of this file.  The snapshot is
+ *  built on the first call and shared by subsequent calls.
+ *
+ *  \warning The snapshot is shared and must not be modified.
+ *
+ *  \return The netlist snapshot.
+ */
+SCM
+g_get_netlist_snapshot (void)
+{
+  if (snapshot == SCM_UNDEFINED) {
+    snapshot = scm_gc_protect_object (g_snapshot_build ());
+  }
+
+  return snapshot;
+}
+
+/*! \brief Discard the cached netlist snapshot.
+ *  \par Function Description
+ *  Must be called whenever #netlist_head is rebuilt.
+ */
+void
+g_snapshot_destroy (void)
+{
+  if (snapshot != SCM_UNDEFINED) {
+    scm_gc_unprotect_object (snapshot);
+    snapshot = SCM_UNDEFINED;
+  }
+}
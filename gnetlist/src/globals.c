@@ -40,14 +40,19 @@ int logging_dest=LOG_WINDOW;
 NETLIST *netlist_head=NULL;
 NETLIST *graphical_netlist_head=NULL; /* Special objects with 
 					 graphical=1 attribute */
-char *guile_proc=NULL; 
 
 
 /* command line arguments */
 int list_backends=FALSE;
+int fork_backends=FALSE;
 int verbose_mode=FALSE;
 int interactive_mode=FALSE;
 int quiet_mode=FALSE;
+int traverse_jobs=1;
+int server_mode=FALSE;
+char *server_socket=NULL;
+int stats_mode=FALSE;
+char *stats_filename=NULL;
 
 /* what kind of netlist are we generating? see define.h for #defs */
 int netlist_mode=gEDA;
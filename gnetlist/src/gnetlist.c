@@ -52,6 +52,13 @@ void gnetlist_quit(void)
     s_clib_free();
     s_slib_free();
     s_rename_destroy_all();
+    s_hierarchy_cache_destroy();
+    s_netindex_destroy();
+    s_package_destroy();
+    s_drc2_destroy();
+    s_intern_destroy();
+    g_snapshot_destroy();
+    g_backend_free_all();
     /* o_text_freeallfonts(); */
 
     /* Free GSList *backend_params */
@@ -122,6 +129,9 @@ gnetlist_backends (TOPLEVEL *pr_current)
     closedir (dptr);
   }
 
+  /* Add the backends built into gnetlist */
+  backend_names = s_native_backend_names (backend_names);
+
   /* Sort the list of backends */
   backend_names = g_list_sort (backend_names, (GCompareFunc) strcmp);
 
@@ -141,11 +151,18 @@ void main_prog(void *closure, int argc, char *argv[])
     int i;
     int argv_index;
     char *cwd;
-    gchar *str;
     gchar *filename;
+    int failed = 0;
 
     TOPLEVEL *pr_current;
 
+#ifdef HAVE_GTHREAD
+    /* Sheets may be traversed on worker threads (see -j), and GLib
+     * requires threading to be initialised before any other GLib
+     * functions are called. */
+    if (!g_thread_supported ()) g_thread_init (NULL);
+#endif
+
     /* set default output filename */
     output_filename = g_strdup("output.net");
 
@@ -154,17 +171,6 @@ void main_prog(void *closure, int argc, char *argv[])
 
     scm_set_program_arguments (argc, argv, NULL);
 
-    /* this is a kludge to make sure that spice mode gets set */
-    /*  Hacked by SDB to allow spice netlisters of arbitrary name
-     *        as long as they begin with "spice".  For example, this spice
-     *  netlister is valid: "spice-sdb".
-     */
-    if (guile_proc) {
-        if (strncmp(guile_proc, "spice", 5) == 0) {
-            netlist_mode = SPICE;
-        }
-    }
-
     libgeda_init();
 
     /* create log file right away */
@@ -195,9 +201,13 @@ void main_prog(void *closure, int argc, char *argv[])
      * are loaded. */
     scm_eval (pre_rc_list, scm_current_module ());
 
+    /* This includes scanning the component libraries, which the rc
+     * files add */
+    s_stats_phase_begin ("rc-parse", NULL);
     g_rc_parse (pr_current, argv[0], "gnetlistrc", rc_filename);
     /* immediately setup user params */
     i_vars_set (pr_current);
+    s_stats_phase_end ();
 
     s_rename_init();
 
@@ -226,6 +236,7 @@ void main_prog(void *closure, int argc, char *argv[])
         printf ("Loading schematic [%s]\n", filename);
       }
 
+      s_stats_phase_begin ("load", filename);
       s_page_goto (pr_current, s_page_new (pr_current, filename));
 
       if (!f_open (pr_current, pr_current->page_current, filename, &err)) {
@@ -235,6 +246,7 @@ void main_prog(void *closure, int argc, char *argv[])
         g_error_free (err);
 	exit(2);
       }
+      s_stats_phase_end ();
 
       /* collect input filenames for backend use */
       input_files = g_slist_append(input_files, argv[i]);
@@ -253,6 +265,26 @@ void main_prog(void *closure, int argc, char *argv[])
     }
     /* free(cwd); - Defered; see below */
 
+    if (server_mode) {
+      if (argv[argv_index] != NULL) {
+        fprintf (stderr, "ERROR: Schematic files are given with each request in server mode.\n");
+        exit (1);
+      }
+
+      /* Load basic gnetlist functions */
+      scm_primitive_load_path (scm_from_utf8_string ("gnetlist.scm"));
+
+      if (!s_server_run (pr_current, argv[0], cwd, server_socket)) {
+        failed = 1;
+      }
+      g_free (cwd);
+
+      s_stats_report (pr_current);
+      gnetlist_quit ();
+      scm_dynwind_end ();
+      exit (failed);
+    }
+
     if (argv[argv_index] == NULL) {
         fprintf (stderr, "ERROR: No schematics files specified for processing.\n");
         fprintf (stderr, "\nRun `%s --help' for more information.\n", argv[0]);
@@ -264,64 +296,50 @@ void main_prog(void *closure, int argc, char *argv[])
 #endif
 
     /* Load basic gnetlist functions */
+    s_stats_phase_begin ("scheme-init", NULL);
     scm_primitive_load_path (scm_from_utf8_string ("gnetlist.scm"));
+    s_stats_phase_end ();
 
-    if (guile_proc) {
-      SCM s_backend_path;
-
-      /* Search for backend scm file in load path */
-      str = g_strdup_printf("gnet-%s.scm", guile_proc);
-      s_backend_path = scm_sys_search_load_path (scm_from_locale_string (str));
-      g_free (str);
-
-      /* If it couldn't be found, fail. */
-      if (scm_is_false (s_backend_path)) {
-        fprintf (stderr, "ERROR: Could not find backend `%s' in load path.\n",
-                 guile_proc);
-        fprintf (stderr,
-                 "\nRun `%s --list-backends' for a full list of available backends.\n",
-                 argv[0]);
-        exit (1);
-      }
-
-      /* Load backend code. */
-      scm_primitive_load (s_backend_path);
+    if (g_backend_count () > 0) {
+      /* Load backend code, traverse and run the backends */
+      g_backend_load_all (argv[0]);
+      failed = g_backend_run_all (pr_current, cwd);
+      g_free(cwd);
+    } else {
+      s_traverse_init();
+      s_traverse_start(pr_current);
 
-      /* Evaluate second set of Scheme expressions. */
-      scm_eval (post_backend_list, scm_current_module ());
-    }
+      /* Change back to the directory where we started AGAIN.  This is done */
+      /* because the s_traverse functions can change the Current Working Directory. */
+      if (chdir (cwd)) {
+        /* Error occured with chdir */
+#warning FIXME: What do we do?
+      }
+      g_free(cwd);
 
-    s_traverse_init();
-    s_traverse_start(pr_current);
+      /* Run post-traverse code. */
+      s_stats_phase_begin ("post-process", "gnetlist-post.scm");
+      scm_primitive_load_path (scm_from_utf8_string ("gnetlist-post.scm"));
+      s_stats_phase_end ();
 
-    /* Change back to the directory where we started AGAIN.  This is done */
-    /* because the s_traverse functions can change the Current Working Directory. */
-    if (chdir (cwd)) {
-      /* Error occured with chdir */
-#warning FIXME: What do we do?
-    }
-    g_free(cwd);
-
-    /* Run post-traverse code. */
-    scm_primitive_load_path (scm_from_utf8_string ("gnetlist-post.scm"));
-
-    if (guile_proc) {
-        /* check size here hack */
-        str = g_strdup_printf ("(%s \"%s\")", guile_proc, output_filename);
-        scm_c_eval_string (str);
-        g_free (str);
-        /* gh_eval_str_with_stack_saving_handler (input_str); */
-    } else if (interactive_mode) {
+      if (interactive_mode) {
         scm_c_eval_string ("(set-repl-prompt! \"gnetlist> \")");
         scm_shell (0, NULL);
-    } else {
+      } else {
         fprintf(stderr,
                 "You gave neither backend to execute nor interactive mode!\n");
+      }
     }
 
+    s_stats_report (pr_current);
     gnetlist_quit();
 
     scm_dynwind_end();
+
+    if (failed > 0) {
+      fprintf (stderr, "ERROR: %d backend(s) failed.\n", failed);
+      exit (1);
+    }
 }
 
 int main(int argc, char *argv[])
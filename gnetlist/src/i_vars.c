@@ -51,6 +51,7 @@
 
 int default_net_naming_priority = NETATTRIB_ATTRIBUTE;
 int default_hierarchy_traversal = TRUE;
+int default_hierarchy_sheet_cache = TRUE;
 int default_hierarchy_uref_mangle = TRUE;
 int default_hierarchy_netname_mangle = TRUE;
 int default_hierarchy_netattrib_mangle = TRUE;
@@ -23,6 +23,9 @@
 #include <missing.h>
 
 #include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
 #ifdef HAVE_STRING_H
 #include <string.h>
 #endif
@@ -43,7 +46,7 @@
 #include <dmalloc.h>
 #endif
 
-#define OPTIONS "c:g:hil:L:m:o:O:qvV"
+#define OPTIONS "c:g:hij:l:L:m:o:O:qvV"
 
 #ifndef OPTARG_IN_UNISTD
 extern char *optarg;
@@ -56,7 +59,11 @@ extern int optind;
 struct option long_options[] =
   {
     {"help", 0, 0, 'h'},
+    {"jobs", 1, 0, 'j'},
     {"list-backends", 0, &list_backends, TRUE},
+    {"fork-backends", 0, &fork_backends, TRUE},
+    {"server", 2, 0, 's'},
+    {"stats", 2, 0, 'S'},
     {"verbose", 0, 0, 'v'},
     {"version", 0, 0, 'V'},
     {0, 0, 0, 0}
@@ -68,7 +75,7 @@ struct option long_options[] =
 void usage(char *cmd)
 {
   printf (
-"Usage: %s [OPTION ...] [-g BACKEND] [--] FILE ...\n"
+"Usage: %s [OPTION ...] [-g BACKEND[:OUTFILE] ...] [--] FILE ...\n"
 "\n"
 "Generate a netlist from one or more gEDA schematic FILEs.\n"
 "\n"
@@ -76,13 +83,21 @@ void usage(char *cmd)
 "  -q              Quiet mode.\n"
 "  -v, --verbose   Verbose mode.\n"
 "  -L DIR          Add DIR to Scheme search path.\n"
-"  -g BACKEND      Specify netlist backend to use.\n"
+"  -g BACKEND[:OUTFILE]\n"
+"                  Specify netlist backend to use.  May be given more\n"
+"                  than once, each with its own OUTFILE.\n"
+"  --fork-backends Run several backends in parallel processes.\n"
 "  -O STRING       Pass an option string to backend.\n"
 "  -l FILE         Load Scheme file before loading backend.\n"
 "  -m FILE         Load Scheme file after loading backend.\n"
 "  -c EXPR         Evaluate Scheme expression at startup.\n"
 "  -i              Enter interactive Scheme REPL after loading.\n"
+"  -j, --jobs=N    Traverse schematic pages on N threads.\n"
 "  --list-backends Print a list of available netlist backends.\n"
+"  --server[=SOCKET]\n"
+"                  Answer netlist requests from standard input, or\n"
+"                  from clients of the UNIX socket SOCKET.\n"
+"  --stats[=FILE]  Write timing and counters as JSON to FILE or stderr.\n"
 "  -h, --help      Help; this message.\n"
 "  -V, --version   Show version information.\n"
 "  --              Treat all remaining arguments as filenames.\n"
@@ -177,7 +192,27 @@ parse_commandline (int argc, char *argv[])
       break;
 
     case 'g':
-      guile_proc = g_strdup(optarg);
+      g_backend_add (optarg);
+      break;
+
+    case 'j':
+      traverse_jobs = atoi(optarg);
+      if (traverse_jobs < 1) {
+        fprintf (stderr, "ERROR: Invalid number of jobs `%s'.\n", optarg);
+        exit (1);
+      }
+      break;
+
+    case 's':
+      server_mode = TRUE;
+      g_free (server_socket);
+      server_socket = (optarg != NULL) ? g_strdup (optarg) : NULL;
+      break;
+
+    case 'S':
+      stats_mode = TRUE;
+      g_free (stats_filename);
+      stats_filename = (optarg != NULL) ? g_strdup (optarg) : NULL;
       break;
 
     case 'l':
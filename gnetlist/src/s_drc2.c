@@ -0,0 +1,1027 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_drc2.c
+ * \brief Design rule checks of the drc2 backend.
+ *
+ * gnet-drc2.scm reads its configuration (the DRC matrix,
+ * pintype-can-drive and the other variables documented there) and
+ * writes the report headings, but the checks themselves are done here
+ * by gnetlist:drc2-check, over indexes of the post-processed netlist:
+ * the symbol instances of each refdes, the pintype of each pin, and
+ * the DRC directives attached to each net.  The Scheme implementation
+ * asked the whole netlist for each of those again for every pin and
+ * every net.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! Number of pintypes, including "unconnected". */
+#define DRC2_N_PINTYPES 12
+
+/*! Position of the "unknown" and "unconnected" pintypes. */
+#define DRC2_UNKNOWN      0
+#define DRC2_UNCONNECTED 11
+
+/*! Report text is handed to the Scheme port in pieces of this size. */
+#define DRC2_FLUSH_SIZE (64 * 1024)
+
+/* DRC directives found on a net */
+#define DRC2_NO_CONNECTION         1
+#define DRC2_DONT_CHECK_PINTYPES   2
+#define DRC2_DONT_CHECK_IF_DRIVEN  4
+
+static const char *pintype_names[DRC2_N_PINTYPES] = {
+  "unknown", "in", "out", "io", "oc", "oe", "pas", "tp", "tri", "clk",
+  "pwr", "unconnected"
+};
+
+static const char *pintype_full_names[DRC2_N_PINTYPES] = {
+  "unknown", "input", "output", "input/output", "open collector",
+  "open emitter", "passive", "totem-pole", "tristate", "clock", "power",
+  "unconnected"
+};
+
+/*! Indexes of the netlist, built once after traversal. */
+typedef struct {
+  GHashTable *instances;    /* refdes -> GPtrArray of NETLIST, in order */
+  GHashTable *pin_objects;  /* NETLIST -> table of pinnumber -> pin OBJECT */
+  GHashTable *pintypes;     /* "refdes pin" -> pintype */
+  GHashTable *directives;   /* net name -> DRC2_* directive flags */
+} DRC2_INDEX;
+
+static DRC2_INDEX *drc2_index = NULL;
+
+/*! State of one gnetlist:drc2-check call. */
+typedef struct {
+  SCM port;
+  GString *out;
+  char matrix[DRC2_N_PINTYPES][DRC2_N_PINTYPES];
+  int can_drive[DRC2_N_PINTYPES];
+  char action_unused_slots;
+  int case_insensitive;
+  int check_not_driven;
+  int errors;
+  int warnings;
+} DRC2_RUN;
+
+static void
+s_drc2_free_array (gpointer array)
+{
+  g_ptr_array_free (array, TRUE);
+}
+
+static void
+s_drc2_index_directives (GHashTable *directives, NETLIST *nl_current)
+{
+  CPINLIST *pl_current;
+  char *device;
+  char *value;
+  int flag = 0;
+
+  if (nl_current->object_ptr == NULL) return;
+
+  device = o_attrib_search_object_attribs_by_name (nl_current->object_ptr,
+                                                   "device", 0);
+  if (device == NULL || strcmp (device, "DRC_Directive") != 0) {
+    g_free (device);
+    return;
+  }
+  g_free (device);
+
+  value = o_attrib_search_object_attribs_by_name (nl_current->object_ptr,
+                                                  "value", 0);
+  if (value == NULL) return;
+
+  if (strcmp (value, "NoConnection") == 0) {
+    flag = DRC2_NO_CONNECTION;
+  } else if (strcmp (value, "DontCheckPintypes") == 0) {
+    flag = DRC2_DONT_CHECK_PINTYPES;
+  } else if (strcmp (value, "DontCheckIfDriven") == 0) {
+    flag = DRC2_DONT_CHECK_IF_DRIVEN;
+  }
+  g_free (value);
+
+  if (flag == 0) return;
+
+  for (pl_current = nl_current->cpins;
+       pl_current != NULL;
+       pl_current = pl_current->next) {
+    if (pl_current->net_name != NULL) {
+      int flags = GPOINTER_TO_INT (g_hash_table_lookup (directives,
+                                                        pl_current->net_name));
+      g_hash_table_insert (directives, pl_current->net_name,
+                           GINT_TO_POINTER (flags | flag));
+    }
+  }
+}
+
+/*! \brief Build the indexes of the netlist, if not done yet. */
+static DRC2_INDEX *
+s_drc2_index (void)
+{
+  NETLIST *nl_current;
+
+  if (drc2_index != NULL) return drc2_index;
+
+  drc2_index = g_new0 (DRC2_INDEX, 1);
+  drc2_index->instances = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                 NULL, s_drc2_free_array);
+  drc2_index->pin_objects =
+    g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                           (GDestroyNotify) g_hash_table_destroy);
+  drc2_index->pintypes = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                g_free, g_free);
+  drc2_index->directives = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (nl_current = netlist_head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+    GPtrArray *array;
+
+    if (nl_current->component_uref == NULL) continue;
+
+    array = g_hash_table_lookup (drc2_index->instances,
+                                 nl_current->component_uref);
+    if (array == NULL) {
+      array = g_ptr_array_new ();
+      g_hash_table_insert (drc2_index->instances,
+                           nl_current->component_uref, array);
+    }
+    g_ptr_array_add (array, nl_current);
+  }
+
+  for (nl_current = graphical_netlist_head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+    s_drc2_index_directives (drc2_index->directives, nl_current);
+  }
+
+  return drc2_index;
+}
+
+/*! \brief Destroy the DRC indexes.
+ *  \par Function Description
+ *  Must be called whenever #netlist_head is rebuilt.
+ */
+void
+s_drc2_destroy (void)
+{
+  if (drc2_index == NULL) return;
+
+  g_hash_table_destroy (drc2_index->instances);
+  g_hash_table_destroy (drc2_index->pin_objects);
+  g_hash_table_destroy (drc2_index->pintypes);
+  g_hash_table_destroy (drc2_index->directives);
+  g_free (drc2_index);
+  drc2_index = NULL;
+}
+
+/*! \brief Find a pin of a symbol instance by pin number.
+ *  \par Function Description
+ *  Returns what o_complex_find_pin_by_attribute() would for the
+ *  "pinnumber" attribute, from a table built on first use.
+ */
+static OBJECT *
+s_drc2_find_pin (DRC2_INDEX *index, NETLIST *instance, const char *pin)
+{
+  GHashTable *pins;
+
+  if (instance->object_ptr == NULL || instance->object_ptr->complex == NULL) {
+    return NULL;
+  }
+
+  pins = g_hash_table_lookup (index->pin_objects, instance);
+  if (pins == NULL) {
+    GList *iter;
+
+    pins = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    for (iter = instance->object_ptr->complex->prim_objs;
+         iter != NULL; iter = g_list_next (iter)) {
+      OBJECT *o_current = iter->data;
+      char *number;
+
+      if (o_current->type != OBJ_PIN) continue;
+
+      number = o_attrib_search_object_attribs_by_name (o_current,
+                                                       "pinnumber", 0);
+      if (number == NULL) continue;
+
+      /* the first pin with a given number wins */
+      if (g_hash_table_lookup (pins, number) == NULL) {
+        g_hash_table_insert (pins, number, o_current);
+      } else {
+        g_free (number);
+      }
+    }
+    g_hash_table_insert (index->pin_objects, instance, pins);
+  }
+
+  return g_hash_table_lookup (pins, pin);
+}
+
+/*! \brief Get the pintype of a pin.
+ *  \par Function Description
+ *  Returns what gnetlist:get-attribute-by-pinnumber would return for
+ *  the "pintype" attribute: the value found on the last instance of
+ *  \a refdes that has the pin, "pwr" for pins which only exist in the
+ *  netlist (e.g. from net= attributes), or "unknown".
+ */
+static const char *
+s_drc2_pintype (DRC2_INDEX *index, const char *refdes, const char *pin)
+{
+  GPtrArray *instances;
+  char *key;
+  char *value = NULL;
+  gpointer cached;
+  guint i;
+
+  key = g_strconcat (refdes, " ", pin, NULL);
+  if (g_hash_table_lookup_extended (index->pintypes, key, NULL, &cached)) {
+    g_free (key);
+    return cached;
+  }
+
+  instances = g_hash_table_lookup (index->instances, refdes);
+  for (i = 0; instances != NULL && i < instances->len; i++) {
+    NETLIST *instance = g_ptr_array_index (instances, i);
+    OBJECT *pin_object = s_drc2_find_pin (index, instance, pin);
+
+    if (pin_object != NULL) {
+      g_free (value);
+      value = o_attrib_search_object_attribs_by_name (pin_object,
+                                                      "pintype", 0);
+    } else if (instance->cpins != NULL
+               && s_cpinlist_search_pin (instance->cpins,
+                                         (char *) pin) != NULL) {
+      g_free (value);
+      value = g_strdup ("pwr");
+    }
+  }
+
+  if (value == NULL) {
+    value = g_strdup ("unknown");
+  }
+
+  g_hash_table_insert (index->pintypes, key, value);
+  return value;
+}
+
+/*! \brief Get the position of a pintype in the pintype list.
+ *  \return The position, or -1 if \a pintype is not a known pintype.
+ */
+static int
+s_drc2_pintype_position (const char *pintype)
+{
+  char *lower = g_utf8_strdown (pintype, -1);
+  int i;
+
+  for (i = 0; i < DRC2_N_PINTYPES; i++) {
+    if (strcmp (lower, pintype_names[i]) == 0) break;
+  }
+  g_free (lower);
+
+  return (i < DRC2_N_PINTYPES) ? i : -1;
+}
+
+static void
+s_drc2_flush (DRC2_RUN *run)
+{
+  if (run->out->len > 0) {
+    scm_lfwrite (run->out->str, run->out->len, run->port);
+    g_string_truncate (run->out, 0);
+  }
+}
+
+static void
+s_drc2_printf (DRC2_RUN *run, const char *format, ...)
+{
+  va_list args;
+
+  va_start (args, format);
+  g_string_append_vprintf (run->out, format, args);
+  va_end (args);
+
+  if (run->out->len > DRC2_FLUSH_SIZE) {
+    s_drc2_flush (run);
+  }
+}
+
+/*! \brief Write the pins of a net which have a given pintype.
+ *  \param [in] type  Position of the pintype, or -1 for all pins.
+ */
+static void
+s_drc2_print_pins (DRC2_RUN *run, const char *net_name, int type)
+{
+  DRC2_INDEX *index = s_drc2_index ();
+  int j;
+
+  for (j = s_netindex_connection_count (net_name) - 1; j >= 0; j--) {
+    const char *uref;
+    const char *pin;
+
+    s_netindex_nth_connection (net_name, j, &uref, &pin);
+    if (type < 0
+        || s_drc2_pintype_position (s_drc2_pintype (index, uref, pin)) == type) {
+      s_drc2_printf (run, "%s:%s ", uref, pin);
+    }
+  }
+}
+
+/*! \brief Count the pins of each pintype connected to a net. */
+static void
+s_drc2_count_pintypes (DRC2_RUN *run, const char *net_name,
+                       int count[DRC2_N_PINTYPES])
+{
+  DRC2_INDEX *index = s_drc2_index ();
+  int j;
+
+  memset (count, 0, DRC2_N_PINTYPES * sizeof (int));
+
+  for (j = s_netindex_connection_count (net_name) - 1; j >= 0; j--) {
+    const char *uref;
+    const char *pin;
+    const char *pintype;
+    int position;
+
+    s_netindex_nth_connection (net_name, j, &uref, &pin);
+    pintype = s_drc2_pintype (index, uref, pin);
+    position = s_drc2_pintype_position (pintype);
+    if (position < 0) {
+      s_drc2_printf (run, "INTERNAL ERROR: unknown pin type : %s\n", pintype);
+    } else {
+      count[position]++;
+    }
+  }
+}
+
+static int
+s_drc2_directives (const char *net_name)
+{
+  return GPOINTER_TO_INT (g_hash_table_lookup (s_drc2_index ()->directives,
+                                               net_name));
+}
+
+/*! \brief Parse the configuration alist passed by gnet-drc2.scm. */
+static void
+s_drc2_configure (DRC2_RUN *run, SCM config)
+{
+  SCM matrix = scm_assq_ref (config, scm_from_utf8_symbol ("drc-matrix"));
+  SCM can_drive = scm_assq_ref (config,
+                                scm_from_utf8_symbol ("pintype-can-drive"));
+  SCM action = scm_assq_ref (config,
+                             scm_from_utf8_symbol ("action-unused-slots"));
+  int row, column;
+
+  /* The matrix is lower triangular: the element for a row and a
+   * column is looked up with the greater of the two as the row */
+  for (row = 0; row < DRC2_N_PINTYPES; row++) {
+    for (column = 0; column <= row; column++) {
+      SCM element = SCM_BOOL_F;
+      SCM line;
+
+      if (scm_ilength (matrix) > row) {
+        line = scm_list_ref (matrix, scm_from_int (row));
+        if (scm_ilength (line) > column) {
+          element = scm_list_ref (line, scm_from_int (column));
+        }
+      }
+
+      run->matrix[row][column] =
+        scm_is_true (scm_char_p (element)) ? SCM_CHAR (element) : '\0';
+      run->matrix[column][row] = run->matrix[row][column];
+    }
+  }
+
+  for (row = 0; row < DRC2_N_PINTYPES; row++) {
+    run->can_drive[row] = (scm_ilength (can_drive) > row)
+      && scm_is_true (scm_num_eq_p (scm_list_ref (can_drive,
+                                                  scm_from_int (row)),
+                                    scm_from_int (1)));
+  }
+
+  run->action_unused_slots =
+    scm_is_true (scm_char_p (action)) ? SCM_CHAR (action) : 'w';
+
+  run->case_insensitive =
+    scm_is_true (scm_assq_ref (config,
+                               scm_from_utf8_symbol ("case-insensitive")));
+  run->check_not_driven =
+    scm_is_true (scm_assq_ref (config,
+                               scm_from_utf8_symbol ("check-not-driven-nets")));
+}
+
+/*! \brief Convert a string to a number, like string->number. */
+static SCM
+s_drc2_string_to_number (const char *str)
+{
+  return scm_string_to_number (scm_from_utf8_string (str), scm_from_int (10));
+}
+
+static gboolean
+s_drc2_is_integer (SCM x)
+{
+  return scm_is_true (scm_integer_p (x));
+}
+
+/*! \brief Append the decimal representation of a number to the report. */
+static void
+s_drc2_print_number (DRC2_RUN *run, SCM x)
+{
+  char *str = scm_to_utf8_string (scm_number_to_string (x, scm_from_int (10)));
+
+  s_drc2_printf (run, "%s", str);
+  free (str);
+}
+
+/*! \brief Insert a number after the elements of a sorted list not greater than it. */
+static SCM
+s_drc2_insert_sorted (SCM list, SCM x)
+{
+  if (scm_is_null (list) || scm_is_true (scm_less_p (x, scm_car (list)))) {
+    return scm_cons (x, list);
+  }
+
+  return scm_cons (scm_car (list), s_drc2_insert_sorted (scm_cdr (list), x));
+}
+
+/*! \brief Get the slots used by a package, like gnetlist:get-slots.
+ *  \par Function Description
+ *  Returns the sorted list of the slot numbers of every instance of
+ *  \a refdes, with 1 for instances without a slot attribute.  If
+ *  \a unique is TRUE, repeated slots are dropped, like
+ *  gnetlist:get-unique-slots does.
+ */
+static SCM
+s_drc2_slots (const char *refdes, gboolean unique)
+{
+  SCM slots = SCM_EOL;
+  guint n_instances;
+  guint i;
+
+  n_instances = s_package_instance_count (refdes);
+  for (i = 0; i < n_instances; i++) {
+    const char *value = s_package_instance_attribute (refdes, i, "slot");
+    SCM slot;
+
+    if (value == NULL) {
+      /* no slot attribute, assume slot number is 1 */
+      slot = scm_from_int (1);
+    } else {
+      slot = s_drc2_string_to_number (value);
+      if (scm_is_false (slot)) {
+        fprintf (stderr, "Uref %s: Bad slot number: %s.\n", refdes, value);
+        continue;
+      }
+    }
+
+    slots = s_drc2_insert_sorted (slots, slot);
+  }
+
+  if (unique) {
+    SCM result = SCM_EOL;
+
+    for (; !scm_is_null (slots); slots = scm_cdr (slots)) {
+      if (scm_is_false (scm_member (scm_car (slots), result))) {
+        result = scm_cons (scm_car (slots), result);
+      }
+    }
+    slots = scm_reverse_x (result, SCM_EOL);
+  }
+
+  return slots;
+}
+
+/*! \brief Check for symbols not numbered. */
+static void
+s_drc2_check_non_numbered_parts (DRC2_RUN *run)
+{
+  guint n = s_package_count ();
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+
+    if (strchr (refdes, '?') != NULL) {
+      s_drc2_printf (run, "ERROR: Reference not numbered: %s\n", refdes);
+      run->errors++;
+    }
+  }
+}
+
+/*! \brief Check for duplicated references.
+ *  \par Function Description
+ *  A reference is duplicated if there are more symbol instances with
+ *  it than unique slots used by the package.
+ */
+static void
+s_drc2_check_duplicated_references (DRC2_RUN *run)
+{
+  GHashTable *counts;
+  NETLIST *nl_current;
+  guint n = s_package_count ();
+  guint i;
+
+  counts = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  for (nl_current = netlist_head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+    char *key;
+    int count;
+
+    if (nl_current->component_uref == NULL) continue;
+
+    key = run->case_insensitive
+      ? g_utf8_casefold (nl_current->component_uref, -1)
+      : g_strdup (nl_current->component_uref);
+    count = GPOINTER_TO_INT (g_hash_table_lookup (counts, key));
+    g_hash_table_replace (counts, key, GINT_TO_POINTER (count + 1));
+  }
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    char *key;
+    int count;
+
+    key = run->case_insensitive
+      ? g_utf8_casefold (refdes, -1) : g_strdup (refdes);
+    count = GPOINTER_TO_INT (g_hash_table_lookup (counts, key));
+    g_free (key);
+
+    if (count > scm_ilength (s_drc2_slots (refdes, TRUE))) {
+      s_drc2_printf (run, "ERROR: Duplicated reference %s.\n", refdes);
+      run->errors++;
+    }
+  }
+
+  g_hash_table_destroy (counts);
+}
+
+/*! \brief Check for NoConnection nets with more than one pin connected. */
+static void
+s_drc2_check_connected_noconnects (DRC2_RUN *run)
+{
+  int i;
+
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+
+    if ((s_drc2_directives (net_name) & DRC2_NO_CONNECTION)
+        && s_netindex_connection_count (net_name) > 1) {
+      s_drc2_printf (run, "ERROR: Net '%s' has connections, but has the "
+                     "NoConnection DRC directive: ", net_name);
+      s_drc2_print_pins (run, net_name, -1);
+      s_drc2_printf (run, ".\n");
+      run->errors++;
+    }
+  }
+}
+
+/*! \brief Check for nets with less than two pins connected. */
+static void
+s_drc2_check_one_connection_nets (DRC2_RUN *run)
+{
+  int i;
+
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+    guint n;
+
+    /* NoConnection nets are not expected to be connected */
+    if (s_drc2_directives (net_name) & DRC2_NO_CONNECTION) continue;
+
+    n = s_netindex_connection_count (net_name);
+    if (n == 0) {
+      s_drc2_printf (run, "ERROR: Net '%s' has no connections.\n", net_name);
+      run->errors++;
+    } else if (n == 1) {
+      s_drc2_printf (run, "ERROR: Net '%s' is connected to only one pin: ",
+                     net_name);
+      s_drc2_print_pins (run, net_name, -1);
+      s_drc2_printf (run, ".\n");
+      run->errors++;
+    }
+  }
+}
+
+/*! \brief Report pins without the 'pintype' attribute. */
+static void
+s_drc2_check_unknown_pintypes (DRC2_RUN *run)
+{
+  int count[DRC2_N_PINTYPES];
+  int total = 0;
+  int i;
+
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    s_drc2_count_pintypes (run, s_netindex_nth_net (i), count);
+    total += count[DRC2_UNKNOWN];
+  }
+
+  if (total == 0) return;
+
+  s_drc2_printf (run, "NOTE: Found pins without the 'pintype' attribute: ");
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    s_drc2_print_pins (run, s_netindex_nth_net (i), DRC2_UNKNOWN);
+  }
+
+  /* The Scheme backend has always ended this line on the current
+   * output port rather than in the report */
+  s_drc2_flush (run);
+  scm_puts ("\n", scm_current_output_port ());
+}
+
+/*! \brief Report the connection of pins of two pintypes on a net. */
+static void
+s_drc2_check_connection (DRC2_RUN *run, const char *net_name,
+                         int type1, int type2)
+{
+  char value = run->matrix[type1][type2];
+
+  if (value == 'c') return;
+
+  if (value != 'e' && value != 'w') {
+    s_drc2_printf (run, "INTERNAL ERROR: DRC matrix has unknown value on "
+                   "position %d,%d\n", type1, type2);
+    s_drc2_flush (run);
+    scm_misc_error ("drc2", "INTERNAL ERROR: DRC matrix has unknown value. "
+                    "See output for more information", SCM_EOL);
+  }
+
+  if (value == 'w') {
+    s_drc2_printf (run, "WARNING: ");
+    run->warnings++;
+  } else {
+    s_drc2_printf (run, "ERROR: ");
+    run->errors++;
+  }
+
+  s_drc2_printf (run, "Pin(s) with pintype '%s': ", pintype_full_names[type1]);
+  s_drc2_print_pins (run, net_name, type1);
+  s_drc2_printf (run, "\n\tare connected by net '%s"
+                 "'\n\tto pin(s) with pintype '%s': ",
+                 net_name, pintype_full_names[type2]);
+  s_drc2_print_pins (run, net_name, type2);
+  s_drc2_printf (run, "\n");
+}
+
+/*! \brief Check the pintypes of the pins connected to every net.
+ *  \par Function Description
+ *  Checks every pair of pintypes present on each net against the DRC
+ *  matrix (pins of the same pintype only if there are several), and,
+ *  unless disabled, that some pin can drive the net.  "unconnected"
+ *  pins take part in neither check.
+ */
+static void
+s_drc2_check_pintypes_of_nets (DRC2_RUN *run)
+{
+  int count[DRC2_N_PINTYPES];
+  int i;
+
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+    int directives = s_drc2_directives (net_name);
+    int type1, type2;
+    int driven = FALSE;
+
+    s_drc2_count_pintypes (run, net_name, count);
+
+    if (!(directives & DRC2_DONT_CHECK_PINTYPES)) {
+      for (type1 = 0; type1 < DRC2_UNCONNECTED; type1++) {
+        if (count[type1] == 0) continue;
+
+        if (count[type1] > 1) {
+          s_drc2_check_connection (run, net_name, type1, type1);
+        }
+        for (type2 = type1 + 1; type2 < DRC2_UNCONNECTED; type2++) {
+          if (count[type2] > 0) {
+            s_drc2_check_connection (run, net_name, type1, type2);
+          }
+        }
+      }
+    }
+
+    if (!run->check_not_driven
+        || (directives & (DRC2_DONT_CHECK_IF_DRIVEN | DRC2_NO_CONNECTION))) {
+      continue;
+    }
+
+    for (type1 = 0; type1 < DRC2_UNCONNECTED; type1++) {
+      if (count[type1] > 0 && run->can_drive[type1]) {
+        driven = TRUE;
+        break;
+      }
+    }
+
+    if (!driven) {
+      run->errors++;
+      s_drc2_printf (run, "ERROR: Net %s is not driven.\n", net_name);
+    }
+  }
+}
+
+/*! \brief Check for unconnected pins.
+ *  \par Function Description
+ *  Reports each unconnected pin as the DRC matrix says for its
+ *  pintype and the "unconnected" pintype.
+ */
+static void
+s_drc2_check_unconnected_pins (DRC2_RUN *run)
+{
+  DRC2_INDEX *index = s_drc2_index ();
+  guint n = s_package_count ();
+  guint i, k;
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    GPtrArray *instances = g_hash_table_lookup (index->instances, refdes);
+
+    for (k = 0; instances != NULL && k < instances->len; k++) {
+      NETLIST *instance = g_ptr_array_index (instances, k);
+      CPINLIST *pl_current;
+
+      for (pl_current = instance->cpins;
+           pl_current != NULL;
+           pl_current = pl_current->next) {
+        const char *pintype;
+        int position;
+        char value;
+
+        if (pl_current->pin_number == NULL || pl_current->net_name == NULL
+            || strncmp (pl_current->net_name, "unconnected_pin", 15) != 0) {
+          continue;
+        }
+
+        pintype = s_drc2_pintype (index, refdes, pl_current->pin_number);
+        position = s_drc2_pintype_position (pintype);
+        if (position < 0) {
+          s_drc2_printf (run, "INTERNAL ERROR: unknown pin type : %s\n",
+                         pintype);
+          continue;
+        }
+
+        value = run->matrix[DRC2_UNCONNECTED][position];
+        if (value == 'c') continue;
+
+        if (value == 'w') {
+          s_drc2_printf (run, "WARNING: ");
+          run->warnings++;
+        } else {
+          s_drc2_printf (run, "ERROR: ");
+          run->errors++;
+        }
+        s_drc2_printf (run, "Unconnected pin %s:%s\n",
+                       refdes, pl_current->pin_number);
+      }
+    }
+  }
+}
+
+/*! \brief Check the slot and numslots attributes of every package. */
+static void
+s_drc2_check_slots (DRC2_RUN *run)
+{
+  guint n = s_package_count ();
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    const char *numslots_string;
+    const char *slot_string = NULL;
+    SCM numslots, slot;
+
+    numslots_string = s_package_unique_attribute (refdes, "numslots");
+    numslots = s_drc2_string_to_number (numslots_string);
+    if (s_package_instance_count (refdes) > 0) {
+      slot_string = s_package_instance_attribute (refdes, 0, "slot");
+    }
+    if (slot_string == NULL) {
+      slot_string = "unknown";
+    }
+    slot = s_drc2_string_to_number (slot_string);
+
+    if (g_ascii_strcasecmp (slot_string, "unknown") == 0) {
+      /* No slot attribute: correct unless numslots says otherwise */
+      if (g_ascii_strcasecmp (numslots_string, "unknown") == 0
+          || (scm_is_true (scm_number_p (numslots))
+              && scm_is_true (scm_num_eq_p (numslots, scm_from_int (0))))) {
+        continue;
+      }
+
+      if (s_drc2_is_integer (numslots)) {
+        s_drc2_printf (run, "ERROR: Multislotted reference %s has no slot "
+                       "attribute defined.\n", refdes);
+      } else {
+        s_drc2_printf (run, "ERROR: Reference %s: Incorrect value of numslots "
+                       "attribute (%s).\n", refdes, numslots_string);
+      }
+      run->errors++;
+
+    } else if (!s_drc2_is_integer (slot)) {
+      s_drc2_printf (run, "ERROR: Reference %s: Incorrect value of slot "
+                     "attribute (%s).\n", refdes, slot_string);
+      run->errors++;
+
+    } else if (!s_drc2_is_integer (numslots)) {
+      s_drc2_printf (run, "ERROR: Reference %s: Incorrect value of numslots "
+                     "attribute (%s).\n", refdes, numslots_string);
+      run->errors++;
+
+    } else {
+      SCM slots;
+
+      /* If a slot is not between 1 and numslots, report an error */
+      for (slots = s_drc2_slots (refdes, TRUE);
+           !scm_is_null (slots); slots = scm_cdr (slots)) {
+        SCM this_slot = scm_car (slots);
+
+        if (s_drc2_is_integer (this_slot)
+            && !(scm_is_true (scm_leq_p (this_slot, numslots))
+                 && scm_is_true (scm_geq_p (this_slot, scm_from_int (1))))) {
+          s_drc2_printf (run, "ERROR: Reference %s: Slot out of range (",
+                         refdes);
+          s_drc2_print_number (run, this_slot);
+          s_drc2_printf (run, ").\n");
+          run->errors++;
+        }
+      }
+    }
+  }
+}
+
+/*! \brief Check for slots used more than once. */
+static void
+s_drc2_check_duplicated_slots (DRC2_RUN *run)
+{
+  guint n = s_package_count ();
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    SCM slots;
+
+    for (slots = s_drc2_slots (refdes, FALSE);
+         !scm_is_null (slots); slots = scm_cdr (slots)) {
+      if (scm_is_true (scm_member (scm_car (slots), scm_cdr (slots)))) {
+        s_drc2_printf (run, "ERROR: duplicated slot ");
+        s_drc2_print_number (run, scm_car (slots));
+        s_drc2_printf (run, " of uref %s\n", refdes);
+        run->errors++;
+      }
+    }
+  }
+}
+
+/*! \brief Check for slots not used. */
+static void
+s_drc2_check_unused_slots (DRC2_RUN *run)
+{
+  guint n = s_package_count ();
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    SCM numslots;
+    SCM slots;
+    int slot;
+
+    numslots = s_drc2_string_to_number (s_package_unique_attribute (refdes,
+                                                                    "numslots"));
+    if (!s_drc2_is_integer (numslots)) continue;
+
+    slots = s_drc2_slots (refdes, TRUE);
+    for (slot = 1; ; slot++) {
+      if (scm_is_false (scm_member (scm_from_int (slot), slots))
+          && run->action_unused_slots != 'c') {
+        if (run->action_unused_slots == 'e') {
+          s_drc2_printf (run, "ERROR: Unused slot %d of uref %s\n",
+                         slot, refdes);
+          run->errors++;
+        } else {
+          s_drc2_printf (run, "WARNING: Unused slot %d of uref %s\n",
+                         slot, refdes);
+          run->warnings++;
+        }
+      }
+
+      if (scm_is_false (scm_less_p (scm_from_int (slot), numslots))) break;
+    }
+  }
+}
+
+static void
+s_drc2_free_run (void *data)
+{
+  DRC2_RUN *run = data;
+
+  g_string_free (run->out, TRUE);
+}
+
+/*! \brief Run one of the checks of the drc2 backend.
+ *  \par Function Description
+ *  Runs the check named by \a scm_check, writing its findings to
+ *  \a port in the format of the drc2 report.  The checks are named
+ *  after the variables which disable them in gnet-drc2.scm:
+ *  \c non-numbered-parts, \c duplicated-references,
+ *  \c connected-noconnects, \c one-connection-nets,
+ *  \c unknown-pintypes, \c pintypes-of-nets, \c unconnected-pins,
+ *  \c slots, \c duplicated-slots and \c unused-slots.
+ *
+ *  \a config is an association list with the keys \c drc-matrix,
+ *  \c pintype-can-drive, \c action-unused-slots (values as documented
+ *  in gnet-drc2.scm), \c case-insensitive and
+ *  \c check-not-driven-nets (booleans).
+ *
+ *  \param [in] port       Output port of the report.
+ *  \param [in] scm_check  Symbol naming the check.
+ *  \param [in] config     Configuration of the checks.
+ *  \return A pair of the numbers of errors and warnings found.
+ */
+SCM
+g_drc2_check (SCM port, SCM scm_check, SCM config)
+{
+  DRC2_RUN run;
+  char *check;
+
+  SCM_ASSERT (scm_is_true (scm_output_port_p (port)), port, SCM_ARG1,
+              "gnetlist:drc2-check");
+  SCM_ASSERT (scm_is_symbol (scm_check), scm_check, SCM_ARG2,
+              "gnetlist:drc2-check");
+  SCM_ASSERT (scm_is_true (scm_list_p (config)), config, SCM_ARG3,
+              "gnetlist:drc2-check");
+
+  scm_dynwind_begin (0);
+
+  check = scm_to_utf8_string (scm_symbol_to_string (scm_check));
+  scm_dynwind_free (check);
+
+  memset (&run, 0, sizeof (run));
+  run.port = port;
+  run.out = g_string_sized_new (DRC2_FLUSH_SIZE);
+  scm_dynwind_unwind_handler (s_drc2_free_run, &run, SCM_F_WIND_EXPLICITLY);
+
+  s_drc2_configure (&run, config);
+
+  if (strcmp (check, "non-numbered-parts") == 0) {
+    s_drc2_check_non_numbered_parts (&run);
+  } else if (strcmp (check, "duplicated-references") == 0) {
+    s_drc2_check_duplicated_references (&run);
+  } else if (strcmp (check, "connected-noconnects") == 0) {
+    s_drc2_check_connected_noconnects (&run);
+  } else if (strcmp (check, "one-connection-nets") == 0) {
+    s_drc2_check_one_connection_nets (&run);
+  } else if (strcmp (check, "unknown-pintypes") == 0) {
+    s_drc2_check_unknown_pintypes (&run);
+  } else if (strcmp (check, "pintypes-of-nets") == 0) {
+    s_drc2_check_pintypes_of_nets (&run);
+  } else if (strcmp (check, "unconnected-pins") == 0) {
+    s_drc2_check_unconnected_pins (&run);
+  } else if (strcmp (check, "slots") == 0) {
+    s_drc2_check_slots (&run);
+  } else if (strcmp (check, "duplicated-slots") == 0) {
+    s_drc2_check_duplicated_slots (&run);
+  } else if (strcmp (check, "unused-slots") == 0) {
+    s_drc2_check_unused_slots (&run);
+  } else {
+    scm_misc_error ("gnetlist:drc2-check", "Unknown check: ~A",
+                    scm_list_1 (scm_check));
+  }
+
+  s_drc2_flush (&run);
+
+  scm_dynwind_end ();
+
+  return scm_cons (scm_from_int (run.errors), scm_from_int (run.warnings));
+}
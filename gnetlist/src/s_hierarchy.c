@@ -32,12 +32,332 @@
 #include <libgeda/libgeda.h>
 
 #include "../include/globals.h"
+#include "../include/i_vars.h"
 #include "../include/prototype.h"
 
 #ifdef HAVE_LIBDMALLOC
 #include <dmalloc.h>
 #endif
 
+/*! Hierarchy tag used when traversing a sub-sheet into a template.
+ *  Every name that depends on the tag of the instance is built from the
+ *  tag by concatenation, so an instance can be produced from the template
+ *  by replacing this placeholder with its real tag. */
+#define HIERARCHY_TEMPLATE_TAG "\001"
+
+/*! The traversed netlist of one source= schematic. */
+typedef struct {
+  NETLIST *netlist;     /* components, tagged with HIERARCHY_TEMPLATE_TAG */
+  NETLIST *graphical;   /* graphical components, likewise */
+  GPtrArray *depends;   /* what the traversal depended on, if tracked */
+} SUBSHEET;
+
+/*! Maps resolved schematic filenames to #SUBSHEET templates. */
+static GHashTable *subsheet_cache = NULL;
+
+#ifdef HAVE_GTHREAD
+/*! Serialises loading and traversing sub-sheets, which changes the
+ *  current page and the page list, when sheets are traversed on
+ *  several threads.  Recursive, since sub-sheets can be nested. */
+static GStaticRecMutex hierarchy_lock = G_STATIC_REC_MUTEX_INIT;
+
+static void *s_hierarchy_lock_body(void *data)
+{
+    g_static_rec_mutex_lock(&hierarchy_lock);
+    return (NULL);
+}
+
+/*! \brief Take #hierarchy_lock.
+ *  \par Function Description
+ *  The holder of the lock runs Scheme (get-uref and friends), which
+ *  may have to wait for every other Guile thread to reach a safe
+ *  point for garbage collection.  A thread blocking on the lock in
+ *  Guile mode would never get there, so wait for it outside Guile
+ *  mode.
+ */
+static void s_hierarchy_lock(void)
+{
+    scm_without_guile(s_hierarchy_lock_body, NULL);
+}
+#endif
+
+/*! Where the refdes used during post processing appear in a netlist.
+ *  Built once per post processing pass, so that finding the I/O symbol
+ *  behind each port of a composite, and disconnecting it, does not
+ *  walk the whole netlist every time. */
+typedef struct {
+    NETLIST *head;
+    GHashTable *components;   /* refdes -> GPtrArray of NETLIST */
+    GHashTable *connections;  /* refdes -> GPtrArray of NET naming it */
+} HIERARCHY_INDEX;
+
+/*! The index of the netlist being post processed, or NULL. */
+static HIERARCHY_INDEX *hierarchy_index = NULL;
+
+/*! Next id handed out to the nets and pins of a template instance.
+ *  Object sids are never negative, and -1 marks list heads. */
+static int subsheet_next_id = -2;
+
+static void s_hierarchy_free_subsheet(SUBSHEET *sheet)
+{
+    s_netlist_free(sheet->netlist);
+    s_netlist_free(sheet->graphical);
+    s_traverse_depend_free(sheet->depends);
+    g_free(sheet);
+}
+
+/*! \brief Replace the template tag in a string.
+ *  \return A newly allocated copy of \a str with every occurrence of
+ *  #HIERARCHY_TEMPLATE_TAG replaced by \a hierarchy_tag, or NULL if
+ *  \a str is NULL.
+ */
+static char *s_hierarchy_instantiate_string(const char *str,
+					    const char *hierarchy_tag)
+{
+    gchar **parts;
+    char *return_value;
+
+    if (str == NULL) {
+	return (NULL);
+    }
+
+    if (strstr(str, HIERARCHY_TEMPLATE_TAG) == NULL) {
+	return (g_strdup(str));
+    }
+
+    parts = g_strsplit(str, HIERARCHY_TEMPLATE_TAG, -1);
+    return_value = g_strjoinv(hierarchy_tag, parts);
+    g_strfreev(parts);
+
+    return (return_value);
+}
+
+/*! \brief Give an instance its own copy of a template id.
+ *  \par Function Description
+ *  Net ids are used during post processing to tell whether two pins
+ *  are on the same net, so each instance must use ids that no other
+ *  instance (and no object) uses.
+ */
+static int s_hierarchy_instantiate_id(GHashTable *ids, int id)
+{
+    gpointer new_id;
+
+    if (id == -1) {
+	return (id);
+    }
+
+    if (!g_hash_table_lookup_extended(ids, GINT_TO_POINTER(id),
+				      NULL, &new_id)) {
+	new_id = GINT_TO_POINTER(subsheet_next_id--);
+	g_hash_table_insert(ids, GINT_TO_POINTER(id), new_id);
+    }
+
+    return (GPOINTER_TO_INT(new_id));
+}
+
+/*! \brief Instantiate a template netlist fragment.
+ *  \par Function Description
+ *  Appends a copy of the \a fragment to \a tail, with the template tag
+ *  replaced by \a hierarchy_tag and the ids remapped through \a ids.
+ */
+static void s_hierarchy_instantiate_fragment(NETLIST *tail,
+					     NETLIST *fragment,
+					     const char *hierarchy_tag,
+					     GHashTable *ids)
+{
+    NETLIST *nl_current;
+    CPINLIST *pl_current;
+    CPINLIST *pl_new;
+    NET *n_current;
+    NET *n_new;
+
+    for (nl_current = fragment; nl_current != NULL;
+	 nl_current = nl_current->next) {
+
+	tail = s_netlist_add(tail);
+	tail->nlid = s_hierarchy_instantiate_id(ids, nl_current->nlid);
+	tail->component_uref =
+	    s_hierarchy_instantiate_string(nl_current->component_uref,
+					   hierarchy_tag);
+	tail->object_ptr = nl_current->object_ptr;
+	tail->hierarchy_tag =
+	    s_hierarchy_instantiate_string(nl_current->hierarchy_tag,
+					   hierarchy_tag);
+	tail->composite_component = nl_current->composite_component;
+
+	pl_new = NULL;
+	for (pl_current = nl_current->cpins; pl_current != NULL;
+	     pl_current = pl_current->next) {
+
+	    pl_new = s_cpinlist_add(pl_new);
+	    if (tail->cpins == NULL) {
+		tail->cpins = pl_new;
+	    }
+
+	    pl_new->plid = s_hierarchy_instantiate_id(ids, pl_current->plid);
+	    pl_new->type = pl_current->type;
+	    pl_new->pin_number = g_strdup(pl_current->pin_number);
+	    pl_new->net_name =
+		s_hierarchy_instantiate_string(pl_current->net_name,
+					       hierarchy_tag);
+	    pl_new->pin_label = g_strdup(pl_current->pin_label);
+
+	    n_new = NULL;
+	    for (n_current = pl_current->nets; n_current != NULL;
+		 n_current = n_current->next) {
+
+		n_new = s_net_add(n_new);
+		if (pl_new->nets == NULL) {
+		    pl_new->nets = n_new;
+		}
+
+		n_new->nid = s_hierarchy_instantiate_id(ids, n_current->nid);
+		n_new->net_name_has_priority =
+		    n_current->net_name_has_priority;
+		n_new->net_name =
+		    s_hierarchy_instantiate_string(n_current->net_name,
+						   hierarchy_tag);
+		n_new->pin_label = g_strdup(n_current->pin_label);
+		n_new->connected_to =
+		    s_hierarchy_instantiate_string(n_current->connected_to,
+						   hierarchy_tag);
+	    }
+	}
+    }
+}
+
+/*! \brief Detach everything appended to a netlist after \a tail. */
+static NETLIST *s_hierarchy_detach_fragment(NETLIST *tail)
+{
+    NETLIST *fragment = tail->next;
+
+    if (fragment != NULL) {
+	fragment->prev = NULL;
+	tail->next = NULL;
+    }
+
+    return (fragment);
+}
+
+/*! \brief Check whether a sub-sheet may be built from a template.
+ *  \par Function Description
+ *  Traversal treats any pin whose connection string contains "POWER"
+ *  as a power pin, so a hierarchy tag containing that word changes
+ *  more than the mangled names and has to be traversed directly.
+ */
+static int s_hierarchy_template_usable(const char *hierarchy_tag)
+{
+    return (hierarchy_tag != NULL && strstr(hierarchy_tag, "POWER") == NULL);
+}
+
+/*! \brief Traverse a source= schematic using the sub-sheet cache.
+ *  \par Function Description
+ *  The first time a schematic is seen it is loaded and traversed once
+ *  with a placeholder hierarchy tag, and the resulting netlist fragment
+ *  is kept as a template.  Every instance, including the first, is then
+ *  appended to the netlist by copying the template and substituting
+ *  the tag of the instance, so that repeated instances of a sheet are
+ *  neither loaded nor traversed again.
+ *
+ *  \param [in]     pr_current    The current #TOPLEVEL structure.
+ *  \param [in]     filename      The source= filename.
+ *  \param [in]     netlist       The netlist node of the composite symbol.
+ *  \param [in,out] page_control  Page control of the last loaded page.
+ *  \return TRUE if the schematic was found, FALSE otherwise.
+ */
+static int s_hierarchy_traverse_cached(TOPLEVEL * pr_current,
+				       char *filename, NETLIST * netlist,
+				       int *page_control)
+{
+    char *full_filename;
+    SUBSHEET *sheet;
+    PAGE *child_page;
+    NETLIST *tail;
+    NETLIST *graphical_tail;
+    GHashTable *ids;
+    guint mark;
+
+    full_filename = s_slib_search_single(filename);
+    if (full_filename == NULL) {
+	return (FALSE);
+    }
+
+    if (subsheet_cache == NULL) {
+	subsheet_cache =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+				  (GDestroyNotify) s_hierarchy_free_subsheet);
+    }
+
+    sheet = g_hash_table_lookup(subsheet_cache, full_filename);
+    if (sheet == NULL) {
+	child_page =
+	    s_hierarchy_down_schematic_single(pr_current, filename,
+					      pr_current->page_current,
+					      *page_control,
+					      HIERARCHY_FORCE_LOAD);
+	if (child_page == NULL) {
+	    g_free(full_filename);
+	    return (FALSE);
+	}
+
+	*page_control = child_page->page_control;
+	s_page_goto (pr_current, child_page);
+    }
+
+    verbose_print("v\n");
+    verbose_reset_index();
+
+    netlist->composite_component = TRUE;
+
+    if (sheet == NULL) {
+	tail = s_netlist_return_tail(s_traverse_netlist_head());
+	graphical_tail =
+	    s_netlist_return_tail(s_traverse_graphical_netlist_head());
+
+	mark = s_traverse_depend_mark();
+	s_traverse_depend_page(full_filename, pr_current->page_current);
+
+	s_traverse_sheet (pr_current,
+			  s_page_objects (pr_current->page_current),
+			  HIERARCHY_TEMPLATE_TAG);
+
+	sheet = g_new0(SUBSHEET, 1);
+	sheet->netlist = s_hierarchy_detach_fragment(tail);
+	sheet->graphical = s_hierarchy_detach_fragment(graphical_tail);
+	sheet->depends = s_traverse_depend_slice(mark);
+	g_hash_table_insert(subsheet_cache, full_filename, sheet);
+    } else {
+	/* the instance depends on everything the template did */
+	s_traverse_depend_replay(sheet->depends);
+	g_free(full_filename);
+    }
+
+    ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+    s_hierarchy_instantiate_fragment(s_netlist_return_tail(s_traverse_netlist_head()),
+				     sheet->netlist,
+				     netlist->component_uref, ids);
+    s_hierarchy_instantiate_fragment(s_netlist_return_tail(s_traverse_graphical_netlist_head()),
+				     sheet->graphical,
+				     netlist->component_uref, ids);
+    g_hash_table_destroy(ids);
+
+    verbose_print("^");
+
+    return (TRUE);
+}
+
+/*! \brief Free the sub-sheet cache.
+ *  \par Function Description
+ *  Frees the netlist templates of all sub-sheets traversed so far.
+ */
+void s_hierarchy_cache_destroy(void)
+{
+    if (subsheet_cache != NULL) {
+	g_hash_table_destroy(subsheet_cache);
+	subsheet_cache = NULL;
+    }
+}
+
 void
 s_hierarchy_traverse(TOPLEVEL * pr_current, OBJECT * o_current,
 		     NETLIST * netlist)
@@ -90,20 +410,35 @@ s_hierarchy_traverse(TOPLEVEL * pr_current, OBJECT * o_current,
 
 	    /* guts here */
 	    /* guts for a single filename */
+#ifdef HAVE_GTHREAD
+	    s_hierarchy_lock();
+#endif
 	    p_current = pr_current->page_current;
+	    /* other threads may have moved the current page */
+	    pr_current->page_current = o_get_page(pr_current, o_current);
 #if DEBUG
 	    printf("Going down %s\n", current_filename);
 #endif
-	    child_page =
+	    if (default_hierarchy_sheet_cache &&
+		s_hierarchy_template_usable(netlist->component_uref)) {
+		if (s_hierarchy_traverse_cached(pr_current, current_filename,
+						netlist, &page_control)) {
+		    loaded_flag = TRUE;
+		} else {
+		    fprintf(stderr, "Could not open [%s]\n",
+			    current_filename);
+		}
+	    } else {
+	      child_page =
 		s_hierarchy_down_schematic_single(pr_current,
 						  current_filename,
 						  pr_current->page_current,
 						  page_control,
                                                   HIERARCHY_FORCE_LOAD);
 
-	    if (child_page == NULL) {
+	      if (child_page == NULL) {
 		fprintf(stderr, "Could not open [%s]\n", current_filename);
-	    } else {
+	      } else {
               page_control = child_page->page_control;
               s_page_goto (pr_current, child_page);
 
@@ -113,6 +448,7 @@ s_hierarchy_traverse(TOPLEVEL * pr_current, OBJECT * o_current,
 		verbose_reset_index();
 
 		netlist->composite_component = TRUE;
+		s_traverse_depend_page(child_page->page_filename, child_page);
 		/* can't do the following, don't know why... HACK TODO */
 		/*netlist->hierarchy_tag = u_basic_strdup (netlist->component_uref);*/
 		s_traverse_sheet (pr_current,
@@ -120,9 +456,13 @@ s_hierarchy_traverse(TOPLEVEL * pr_current, OBJECT * o_current,
 		                  netlist->component_uref);
 
 		verbose_print("^");
+	      }
 	    }
 
 	    pr_current->page_current = p_current;
+#ifdef HAVE_GTHREAD
+	    g_static_rec_mutex_unlock(&hierarchy_lock);
+#endif
 
 	    g_free(current_filename);
 	    pcount++;
@@ -174,6 +514,90 @@ s_hierarchy_traverse(TOPLEVEL * pr_current, OBJECT * o_current,
 }
 
 
+static void s_hierarchy_free_array(gpointer array)
+{
+    g_ptr_array_free(array, TRUE);
+}
+
+static void s_hierarchy_index_add(GHashTable *table, const char *refdes,
+				  gpointer data)
+{
+    GPtrArray *array = g_hash_table_lookup(table, refdes);
+
+    if (array == NULL) {
+	array = g_ptr_array_new();
+	g_hash_table_insert(table, g_strdup(refdes), array);
+    }
+    g_ptr_array_add(array, data);
+}
+
+static void s_hierarchy_index_destroy(void)
+{
+    if (hierarchy_index != NULL) {
+	g_hash_table_destroy(hierarchy_index->components);
+	g_hash_table_destroy(hierarchy_index->connections);
+	g_free(hierarchy_index);
+	hierarchy_index = NULL;
+    }
+}
+
+/*! \brief Get the refdes index of a netlist.
+ *  \par Function Description
+ *  Returns the index of the components and connections of \a head,
+ *  building it if the current index is for a different netlist.  The
+ *  index stays valid while refdes and connections are only removed,
+ *  which is all post processing does to them.
+ */
+static HIERARCHY_INDEX *s_hierarchy_index_get(NETLIST *head)
+{
+    NETLIST *nl_current;
+    CPINLIST *pl_current;
+    NET *n_current;
+    char *uref;
+    char *pin;
+
+    if (hierarchy_index != NULL && hierarchy_index->head == head) {
+	return (hierarchy_index);
+    }
+
+    s_hierarchy_index_destroy();
+
+    hierarchy_index = g_new(HIERARCHY_INDEX, 1);
+    hierarchy_index->head = head;
+    hierarchy_index->components =
+	g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+			      s_hierarchy_free_array);
+    hierarchy_index->connections =
+	g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+			      s_hierarchy_free_array);
+
+    for (nl_current = head; nl_current != NULL;
+	 nl_current = nl_current->next) {
+
+	if (nl_current->component_uref) {
+	    s_hierarchy_index_add(hierarchy_index->components,
+				  nl_current->component_uref, nl_current);
+	}
+
+	for (pl_current = nl_current->cpins; pl_current != NULL;
+	     pl_current = pl_current->next) {
+	    for (n_current = pl_current->nets; n_current != NULL;
+		 n_current = n_current->next) {
+		if (n_current->connected_to != NULL) {
+		    s_netindex_split_connected_to(n_current->connected_to,
+						  &uref, &pin);
+		    s_hierarchy_index_add(hierarchy_index->connections,
+					  uref, n_current);
+		    g_free(uref);
+		    g_free(pin);
+		}
+	    }
+	}
+    }
+
+    return (hierarchy_index);
+}
+
 void s_hierarchy_post_process(TOPLEVEL * pr_current, NETLIST * head)
 {
     NETLIST *nl_current;
@@ -244,6 +668,8 @@ void s_hierarchy_post_process(TOPLEVEL * pr_current, NETLIST * head)
 
     s_rename_all(pr_current, head);
     s_hierarchy_remove_compsite_all(head);
+
+    s_hierarchy_index_destroy();
 }
 
 int
@@ -252,8 +678,10 @@ s_hierarchy_setup_rename(TOPLEVEL * pr_current, NETLIST * head, char *uref,
 {
     NETLIST *nl_current;
     CPINLIST *pl_current;
+    GPtrArray *components;
     char *wanted_uref = NULL;
     int did_work = FALSE;
+    guint i;
 
     /* this is questionable, because I'm not sure if it's exactly the */
     /* same as the #if 0'ed out line */
@@ -266,83 +694,77 @@ s_hierarchy_setup_rename(TOPLEVEL * pr_current, NETLIST * head, char *uref,
 	   wanted_uref);
 #endif
 
-    nl_current = head;
-    while (nl_current != NULL) {
-	if (nl_current->component_uref) {
-	    pl_current = nl_current->cpins;
-	    if (strcmp(nl_current->component_uref, wanted_uref) == 0) {
-		if (nl_current->cpins) {
-		    /* skip over head of special io symbol */
-		    pl_current = nl_current->cpins->next;;
+    if (wanted_uref == NULL) {
+	return (FALSE);
+    }
+
+    components = g_hash_table_lookup(s_hierarchy_index_get(head)->components,
+				     wanted_uref);
+
+    for (i = 0; components != NULL && i < components->len; i++) {
+	nl_current = g_ptr_array_index(components, i);
+
+	/* instances already disconnected have lost their refdes */
+	if (nl_current->component_uref && nl_current->cpins) {
+	    /* skip over head of special io symbol */
+	    pl_current = nl_current->cpins->next;;
 #if DEBUG
-		    printf("net to be renamed: %s\n",
-			   pl_current->net_name);
-		    printf("%s -> %s\n", pl_current->net_name, new_name);
+	    printf("net to be renamed: %s\n",
+		   pl_current->net_name);
+	    printf("%s -> %s\n", pl_current->net_name, new_name);
 #endif
-		    s_rename_add(pl_current->net_name, new_name);
+	    s_rename_add(pl_current->net_name, new_name);
 
 #if DEBUG
-		    printf("Going to remove %s\n",
-			   nl_current->component_uref);
+	    printf("Going to remove %s\n",
+		   nl_current->component_uref);
 #endif
-		    s_hierarchy_remove_urefconn(head,
-						nl_current->
-						component_uref);
-		    did_work = TRUE;
-		}
-	    }
+	    s_hierarchy_remove_urefconn(head,
+					nl_current->
+					component_uref);
+	    did_work = TRUE;
 	}
-	nl_current = nl_current->next;
     }
 
+    g_free(wanted_uref);
+
     return (did_work);
 }
 
 void s_hierarchy_remove_urefconn(NETLIST * head, char *uref_disable)
 {
+    HIERARCHY_INDEX *index = s_hierarchy_index_get(head);
+    GPtrArray *connections;
+    GPtrArray *components;
     NETLIST *nl_current;
-    CPINLIST *pl_current;
     NET *n_current;
-    char uref[80], pin[10];
+    guint i;
 
-    nl_current = head;
-    while (nl_current != NULL) {
-	pl_current = nl_current->cpins;
-	while (pl_current != NULL) {
-	    n_current = pl_current->nets;
-	    while (n_current != NULL) {
-		if (n_current->connected_to != NULL) {
-		    sscanf(n_current->connected_to, "%s %s", uref, pin);
-#if DEBUG
-		    printf("	looking at : %s %s\n", uref, pin);
-#endif
-		    if (strcmp(uref_disable, uref) == 0) {
-#if DEBUG
-			printf("conn disabling %s\n",
-			       n_current->connected_to);
-#endif
-			/* can't do frees, since some names are links */
-/* 		g_free(n_current->connected_to);*/
-			n_current->connected_to = NULL;
-		    }
-		}
-		n_current = n_current->next;
-	    }
+    connections = g_hash_table_lookup(index->connections, uref_disable);
+    components = g_hash_table_lookup(index->components, uref_disable);
 
-	    pl_current = pl_current->next;
+    for (i = 0; connections != NULL && i < connections->len; i++) {
+	n_current = g_ptr_array_index(connections, i);
+#if DEBUG
+	if (n_current->connected_to != NULL) {
+	    printf("conn disabling %s\n", n_current->connected_to);
 	}
+#endif
+	/* can't do frees, since some names are links */
+/* 	g_free(n_current->connected_to);*/
+	n_current->connected_to = NULL;
+    }
 
-	if (nl_current->component_uref) {
-	    if (strcmp(nl_current->component_uref, uref_disable) == 0) {
+    for (i = 0; components != NULL && i < components->len; i++) {
+	nl_current = g_ptr_array_index(components, i);
 #if DEBUG
-		printf("refdes disabling: %s\n", nl_current->component_uref);
-#endif
-		/* can't do frees, since some names are links */
-		/*free(nl_current->component_uref); */
-		nl_current->component_uref = NULL;
-	    }
+	if (nl_current->component_uref != NULL) {
+	    printf("refdes disabling: %s\n", nl_current->component_uref);
 	}
-	nl_current = nl_current->next;
+#endif
+	/* can't do frees, since some names are links */
+	/*free(nl_current->component_uref); */
+	nl_current->component_uref = NULL;
     }
 }
 
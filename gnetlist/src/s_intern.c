@@ -0,0 +1,193 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_intern.c
+ * \brief Shared Scheme strings for netlist names.
+ *
+ * A design only has a few thousand distinct refdes, pin numbers and
+ * net names, but backends ask for them hundreds of thousands of times.
+ * Rather than converting the C string to a new Scheme string on every
+ * primitive call, each distinct name is turned into a Scheme string
+ * once, when the netlist has been built, and every primitive returns a
+ * copy of that string until the netlist is rebuilt.
+ *
+ * The copies are made with string-copy, which only allocates a new
+ * string header sharing the characters of the original until either
+ * is modified.  Backends may therefore still modify the strings they
+ * are given destructively (e.g. with string-downcase!) without
+ * affecting what later calls return.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! Maps C strings to indexes into #interned. */
+static GHashTable *intern_table = NULL;
+
+/*! Scheme vector holding the interned strings, protected from the
+ *  garbage collector while the table exists. */
+static SCM interned = SCM_UNDEFINED;
+static guint n_interned = 0;
+
+/*! \brief Get a Scheme string for a C string.
+ *  \par Function Description
+ *  Returns a copy-on-write copy of the Scheme string interned for
+ *  \a str, creating it on first use.  Strings that were not interned
+ *  by s_intern_build() (e.g. attribute values) are added to the table
+ *  too, and are shared from then on.
+ *
+ *  \param [in] str  String to look up, or NULL.
+ *  \return A new Scheme string, or #f if \a str is NULL.
+ */
+SCM
+s_intern_string (const char *str)
+{
+  gpointer index;
+  SCM s;
+
+  if (str == NULL) return SCM_BOOL_F;
+
+  if (intern_table == NULL) {
+    intern_table = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free, NULL);
+    interned = scm_gc_protect_object (scm_c_make_vector (1024, SCM_BOOL_F));
+    n_interned = 0;
+  }
+
+  if (g_hash_table_lookup_extended (intern_table, str, NULL, &index)) {
+    return scm_string_copy (scm_c_vector_ref (interned,
+                                              GPOINTER_TO_UINT (index)));
+  }
+
+  if (n_interned == scm_c_vector_length (interned)) {
+    SCM bigger = scm_c_make_vector (2 * n_interned, SCM_BOOL_F);
+    guint i;
+
+    for (i = 0; i < n_interned; i++) {
+      scm_c_vector_set_x (bigger, i, scm_c_vector_ref (interned, i));
+    }
+    scm_gc_protect_object (bigger);
+    scm_gc_unprotect_object (interned);
+    interned = bigger;
+  }
+
+  s = scm_from_utf8_string (str);
+  scm_c_vector_set_x (interned, n_interned, s);
+  g_hash_table_insert (intern_table, g_strdup (str),
+                       GUINT_TO_POINTER (n_interned));
+  n_interned++;
+
+  return scm_string_copy (s);
+}
+
+/*! \brief Copy a cached list of interned strings.
+ *  \par Function Description
+ *  Lists built once and kept between calls hold the same string
+ *  objects on every call.  This copies the pairs of \a tree and makes
+ *  a copy-on-write copy of every string in it, so that a caller may
+ *  modify the result without changing what later calls return.
+ *
+ *  \param [in] tree  A list, possibly nested, of strings and other
+ *                    immediate values.
+ *  \return A copy of \a tree.
+ */
+SCM
+s_intern_copy_tree (SCM tree)
+{
+  SCM copy = SCM_EOL;
+
+  if (scm_is_string (tree)) {
+    return scm_string_copy (tree);
+  }
+
+  /* Walk down the spine iteratively, since lists can be long */
+  for (; scm_is_pair (tree); tree = scm_cdr (tree)) {
+    copy = scm_cons (s_intern_copy_tree (scm_car (tree)), copy);
+  }
+
+  return scm_reverse_x (copy, s_intern_copy_tree (tree));
+}
+
+/*! \brief Intern the names used in a netlist.
+ *  \par Function Description
+ *  Creates the shared Scheme strings for every refdes, pin number,
+ *  net name and pin label in \a head, so that the primitives only
+ *  ever look them up.
+ *
+ *  \param [in] head  Head of the netlist.
+ */
+void
+s_intern_build (NETLIST *head)
+{
+  NETLIST *nl_current;
+  CPINLIST *pl_current;
+
+  for (nl_current = head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+
+    s_intern_string (nl_current->component_uref);
+
+    for (pl_current = nl_current->cpins;
+         pl_current != NULL;
+         pl_current = pl_current->next) {
+      s_intern_string (pl_current->pin_number);
+      s_intern_string (pl_current->net_name);
+      s_intern_string (pl_current->pin_label);
+    }
+  }
+
+  s_stats_add ("interned-strings", n_interned);
+}
+
+/*! \brief Forget the interned strings.
+ *  \par Function Description
+ *  Must be called whenever #netlist_head is rebuilt.  Strings already
+ *  handed out to Scheme stay valid; they are just no longer shared
+ *  with later calls.
+ */
+void
+s_intern_destroy (void)
+{
+  if (intern_table != NULL) {
+    g_hash_table_destroy (intern_table);
+    intern_table = NULL;
+  }
+
+  if (interned != SCM_UNDEFINED) {
+    scm_gc_unprotect_object (interned);
+    interned = SCM_UNDEFINED;
+  }
+  n_interned = 0;
+}
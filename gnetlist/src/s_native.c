@@ -0,0 +1,648 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_native.c
+ * \brief Built-in backends written in C.
+ *
+ * The most used netlist formats are also available as backends
+ * written in C, which run straight over the net index and the package
+ * table instead of going through the `gnetlist:' primitives, and
+ * write through a large stdio buffer.  They are selected with
+ * <tt>-g native-PCB</tt>, <tt>-g native-geda</tt> and
+ * <tt>-g native-pads</tt>, and produce exactly the same output as the
+ * gnet-PCB.scm, gnet-geda.scm and gnet-pads.scm backends.
+ *
+ * Being C, they ignore any Scheme redefinitions of the helpers the
+ * Scheme backends use (e.g. \c unique-attribute); use the Scheme
+ * backend when those are needed.
+ *
+ * The \c json backend has no Scheme counterpart.  It writes the
+ * netlist for other programs as JSON Lines, one JSON object per line,
+ * each with a \c record member saying what it describes:
+ *
+ * <pre>
+ * {"record":"header","format":"gnetlist-json","version":1,
+ *  "files":["power.sch"]}
+ * {"record":"component","refdes":"U1","hierarchy-tag":null,
+ *  "attributes":{"device":"7805","footprint":"TO220"},
+ *  "pins":[{"number":"1","net":"Vin","label":"IN"}]}
+ * {"record":"net","name":"Vin","connections":[["U1","1"],["C1","1"]]}
+ * {"record":"renamed-net","from":"unnamed_net3","to":"Vin"}
+ * {"record":"end","components":1,"nets":1}
+ * </pre>
+ *
+ * (shown wrapped here; each record is on a single line).  There is one
+ * \c component record per symbol instance, in netlist order, so a
+ * slotted package appears once per slot.  Its attributes are the
+ * attached and inherited ones, first value only; a pin's \c net and
+ * \c label, and the \c hierarchy-tag, are null when unknown.  \c net
+ * records follow in the order of gnetlist:get-all-unique-nets, with
+ * connections in the order of gnetlist:get-all-connections, and then
+ * the \c renamed-net records in the order of gnetlist:get-renamed-nets.
+ * Records of other types may be added in later versions and should be
+ * skipped by readers that do not know them.  The format is documented
+ * for users in docs/README.json, and tests/powersupply.json is its
+ * reference output; keep both in step with this writer.
+ *
+ * Component records are written straight from the netlist as it is
+ * walked, so apart from the net index the backend needs no memory
+ * proportional to the size of the design.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! Size of the output buffer of a native backend. */
+#define NATIVE_BUFFER_SIZE (256 * 1024)
+
+typedef void (*NATIVE_WRITER) (FILE *fp);
+
+/*! A built-in backend. */
+typedef struct {
+  const char *name;
+  NATIVE_WRITER writer;
+} NATIVE_BACKEND;
+
+/*! \brief Write a string wrapped like gnetlist:wrap would.
+ *  \par Function Description
+ *  Breaks \a str at the last space before \a wrap_length characters,
+ *  replacing the space with \a wrap_char, a newline and a space, for
+ *  as long as the rest is not shorter than \a wrap_length characters.
+ *  A piece with no space to break at is replaced by " Wrap error!".
+ *
+ *  \param [in] fp           Where to write.
+ *  \param [in] str          UTF-8 string to wrap.
+ *  \param [in] wrap_length  Maximum line length, in characters.
+ *  \param [in] wrap_char    String to put at the end of wrapped lines.
+ */
+static void
+s_native_write_wrapped (FILE *fp, const char *str, glong wrap_length,
+                        const char *wrap_char)
+{
+  glong n_chars = g_utf8_strlen (str, -1);
+
+  while (wrap_length <= n_chars) {
+    const char *end = g_utf8_offset_to_pointer (str, wrap_length);
+    const char *space = NULL;
+    const char *p;
+
+    for (p = end - 1; p >= str; p--) {
+      if (*p == ' ') {
+        space = p;
+        break;
+      }
+    }
+
+    if (space == NULL) {
+      printf ("Couldn't wrap string  at requested position\n");
+      fputs (" Wrap error!", fp);
+      return;
+    }
+
+    fwrite (str, 1, space - str, fp);
+    fputs (wrap_char, fp);
+    fputs ("\n ", fp);
+
+    n_chars -= g_utf8_pointer_to_offset (str, space) + 1;
+    str = space + 1;
+  }
+
+  fputs (str, fp);
+}
+
+/*! \brief Write the PCB netlist format (see gnet-PCB.scm). */
+static void
+s_native_write_pcb (FILE *fp)
+{
+  GString *line = g_string_new (NULL);
+  int i, j;
+
+  /* Nets and connections go out in the order of
+   * gnetlist:get-all-unique-nets and gnetlist:get-all-connections,
+   * which is the reverse of the index order */
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+
+    g_string_truncate (line, 0);
+    for (j = s_netindex_connection_count (net_name) - 1; j >= 0; j--) {
+      const char *uref;
+      const char *pin;
+
+      s_netindex_nth_connection (net_name, j, &uref, &pin);
+      g_string_append (line, uref);
+      g_string_append_c (line, '-');
+      g_string_append (line, pin);
+      g_string_append_c (line, ' ');
+    }
+    g_string_append_c (line, '\n');
+
+    fputs (net_name, fp);
+    fputc ('\t', fp);
+    s_native_write_wrapped (fp, line->str, 200, " \\");
+  }
+
+  g_string_free (line, TRUE);
+}
+
+static void
+s_native_collect_rename (const char *src, const char *dest, gpointer user_data)
+{
+  g_ptr_array_add ((GPtrArray *) user_data, (gpointer) src);
+  g_ptr_array_add ((GPtrArray *) user_data, (gpointer) dest);
+}
+
+/*! \brief Write the gEDA test netlist format (see gnet-geda.scm). */
+static void
+s_native_write_geda (FILE *fp)
+{
+  GPtrArray *renames;
+  guint n;
+  int i, j;
+
+  fputs ("START header\n\n"
+         "gEDA's netlist format\n"
+         "Created specifically for testing of gnetlist\n\n"
+         "END header\n\n", fp);
+
+  fputs ("START components\n\n", fp);
+  n = s_package_count ();
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+
+    fprintf (fp, "%s device=%s\n", refdes,
+             s_package_unique_attribute (refdes, "device"));
+  }
+  fputs ("\nEND components\n\n", fp);
+
+  /* gnetlist:get-renamed-nets lists the renames last first */
+  fputs ("START renamed-nets\n\n", fp);
+  renames = g_ptr_array_new ();
+  s_rename_foreach (s_native_collect_rename, renames);
+  for (i = (int) renames->len - 2; i >= 0; i -= 2) {
+    fprintf (fp, "%s -> %s\n", (char *) g_ptr_array_index (renames, i),
+             (char *) g_ptr_array_index (renames, i + 1));
+  }
+  g_ptr_array_free (renames, TRUE);
+  fputs ("\nEND renamed-nets\n\n", fp);
+
+  fputs ("START nets\n\n", fp);
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+
+    fputs (net_name, fp);
+    fputs (" : ", fp);
+    for (j = s_netindex_connection_count (net_name) - 1; j >= 0; j--) {
+      const char *uref;
+      const char *pin;
+
+      s_netindex_nth_connection (net_name, j, &uref, &pin);
+      fprintf (fp, "%s %s%s", uref, pin, (j > 0) ? ", " : "");
+    }
+    fputs (" \n", fp);
+  }
+  fputs ("\nEND nets\n\n", fp);
+}
+
+/*! \brief Convert a string to upper case, like string-upcase. */
+static char *
+s_native_upcase (const char *str)
+{
+  GString *result = g_string_sized_new (strlen (str));
+  const char *p;
+
+  for (p = str; *p != '\0'; p = g_utf8_next_char (p)) {
+    g_string_append_unichar (result, g_unichar_toupper (g_utf8_get_char (p)));
+  }
+
+  return g_string_free (result, FALSE);
+}
+
+/*! \brief Build an upper case alias table, like gnetlist:build-net-aliases.
+ *  \par Function Description
+ *  Maps each name returned by \a nth_name to its upper case alias.  If
+ *  two names get the same alias, prints the same message as
+ *  gnetlist-post.scm and returns NULL.
+ *
+ *  \param [in] n_names   Number of names.
+ *  \param [in] nth_name  Returns the names, by position.
+ *  \param [in] reverse   Visit the names last first.
+ *  \param [in] what      Either "net" or "refdes", for the message.
+ *  \return A table from name to alias, or NULL.
+ */
+static GHashTable *
+s_native_build_aliases (guint n_names, const char *(*nth_name) (guint),
+                        gboolean reverse, const char *what)
+{
+  GHashTable *forward;
+  GHashTable *backward;
+  guint i;
+
+  forward = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+  backward = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (i = 0; i < n_names; i++) {
+    const char *name = nth_name (reverse ? n_names - 1 - i : i);
+    char *alias = s_native_upcase (name);
+    const char *other = g_hash_table_lookup (backward, alias);
+
+    if (other != NULL) {
+      printf ("***** ERROR *****\n");
+      if (strcmp (what, "net") == 0) {
+        printf ("There is a net name collision!\n"
+                "The net called \"%s\" will be remapped\n"
+                "to \"%s\" which is already used\n"
+                "by the net called \"%s\".\n"
+                "This may be caused by netname attributes colliding with "
+                "other netnames\n", name, alias, other);
+      } else {
+        printf ("There is a refdes name collision!\n"
+                "The refdes \"%s\" will be mapped\n"
+                "to \"%s\" which is already used\n"
+                "by \"%s\".\n"
+                "This may be caused by refdes attributes colliding with "
+                "others\n", name, alias, other);
+      }
+      printf ("due to truncation of the %s, case insensitivity, or\n"
+              "other limitations imposed by this netlist format.\n",
+              (strcmp (what, "net") == 0) ? "name" : "refdes");
+      g_free (alias);
+      g_hash_table_destroy (backward);
+      g_hash_table_destroy (forward);
+      return NULL;
+    }
+
+    g_hash_table_insert (forward, (gpointer) name, alias);
+    g_hash_table_insert (backward, alias, (gpointer) name);
+  }
+
+  g_hash_table_destroy (backward);
+  return forward;
+}
+
+/*! \brief Write the PADS PowerPCB netlist format (see gnet-pads.scm). */
+static void
+s_native_write_pads (FILE *fp)
+{
+  GHashTable *net_aliases;
+  GHashTable *refdes_aliases;
+  GString *line;
+  guint n;
+  int i, j;
+
+  /* all-unique-nets is gnetlist:get-all-unique-nets, last net first */
+  net_aliases = s_native_build_aliases (s_netindex_net_count (),
+                                        s_netindex_nth_net, TRUE, "net");
+  if (net_aliases == NULL) {
+    fclose (fp);
+    scm_misc_error ("pads", "net name collision", SCM_EOL);
+  }
+
+  refdes_aliases = s_native_build_aliases (s_package_count (),
+                                           s_package_nth_refdes, FALSE,
+                                           "refdes");
+  if (refdes_aliases == NULL) {
+    g_hash_table_destroy (net_aliases);
+    fclose (fp);
+    scm_misc_error ("pads", "refdes name collision", SCM_EOL);
+  }
+
+  fputs ("!PADS-POWERPCB-V3.0-MILS!\r\n", fp);
+  fputs ("\r\n*PART*\r\n", fp);
+
+  n = s_package_count ();
+  for (i = 0; i < n; i++) {
+    const char *refdes = s_package_nth_refdes (i);
+    const char *pattern = s_package_unique_attribute (refdes, "pattern");
+
+    if (strcmp (pattern, "unknown") != 0) {
+      fputs (pattern, fp);
+    }
+    fprintf (fp, "%s\t%s\r\n",
+             (char *) g_hash_table_lookup (refdes_aliases, refdes),
+             s_package_unique_attribute (refdes, "footprint"));
+  }
+
+  fputs ("\r\n*NET*\r\n", fp);
+
+  line = g_string_new (NULL);
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+
+    fprintf (fp, "*SIGNAL* %s\r\n",
+             (char *) g_hash_table_lookup (net_aliases, net_name));
+
+    g_string_truncate (line, 0);
+    for (j = s_netindex_connection_count (net_name) - 1; j >= 0; j--) {
+      const char *uref;
+      const char *pin;
+      const char *alias;
+
+      s_netindex_nth_connection (net_name, j, &uref, &pin);
+      alias = g_hash_table_lookup (refdes_aliases, uref);
+      g_string_append_c (line, ' ');
+      g_string_append (line, (alias != NULL) ? alias : "#f");
+      g_string_append_c (line, '.');
+      g_string_append (line, pin);
+    }
+    g_string_append (line, "\r\n");
+
+    s_native_write_wrapped (fp, line->str, 78, "");
+  }
+  g_string_free (line, TRUE);
+
+  fputs ("\r\n*END*\r\n", fp);
+
+  g_hash_table_destroy (refdes_aliases);
+  g_hash_table_destroy (net_aliases);
+}
+
+/*! \brief Write a string as a JSON string, or null for NULL. */
+static void
+s_native_write_json_string (FILE *fp, const char *str)
+{
+  const char *p;
+
+  if (str == NULL) {
+    fputs ("null", fp);
+    return;
+  }
+
+  fputc ('"', fp);
+  for (p = str; *p != '\0'; p++) {
+    unsigned char c = *p;
+
+    switch (c) {
+      case '"':  fputs ("\\\"", fp); break;
+      case '\\': fputs ("\\\\", fp); break;
+      case '\n': fputs ("\\n", fp); break;
+      case '\r': fputs ("\\r", fp); break;
+      case '\t': fputs ("\\t", fp); break;
+      default:
+        if (c < 0x20) {
+          fprintf (fp, "\\u%04x", c);
+        } else {
+          fputc (c, fp);
+        }
+    }
+  }
+  fputc ('"', fp);
+}
+
+/*! \brief Write the attributes of a symbol instance as a JSON object.
+ *  \par Function Description
+ *  Writes the attached and inherited attributes of \a object, keeping
+ *  only the first value of each name, as the package table does.
+ *  Symbols carry few attributes, so repeated names are looked for in
+ *  the list itself rather than in a table.
+ */
+static void
+s_native_write_json_attribs (FILE *fp, OBJECT *object)
+{
+  GList *attribs;
+  GList *iter;
+  int first = TRUE;
+
+  fputc ('{', fp);
+
+  attribs = (object != NULL) ? o_attrib_return_attribs (object) : NULL;
+  for (iter = attribs; iter != NULL; iter = g_list_next (iter)) {
+    GList *prev;
+    char *name;
+    char *value;
+    int seen = FALSE;
+
+    if (!o_attrib_get_name_value (iter->data, &name, &value)) continue;
+
+    for (prev = attribs; prev != iter && !seen; prev = g_list_next (prev)) {
+      char *prev_name;
+
+      if (o_attrib_get_name_value (prev->data, &prev_name, NULL)) {
+        seen = (strcmp (prev_name, name) == 0);
+        g_free (prev_name);
+      }
+    }
+
+    if (!seen) {
+      if (!first) fputc (',', fp);
+      s_native_write_json_string (fp, name);
+      fputc (':', fp);
+      s_native_write_json_string (fp, value);
+      first = FALSE;
+    }
+
+    g_free (name);
+    g_free (value);
+  }
+  g_list_free (attribs);
+
+  fputc ('}', fp);
+}
+
+static void
+s_native_write_json_rename (const char *src, const char *dest,
+                            gpointer user_data)
+{
+  g_ptr_array_add ((GPtrArray *) user_data, (gpointer) src);
+  g_ptr_array_add ((GPtrArray *) user_data, (gpointer) dest);
+}
+
+/*! \brief Write the netlist as JSON Lines (see the top of this file). */
+static void
+s_native_write_json (FILE *fp)
+{
+  NETLIST *nl_current;
+  CPINLIST *pl_current;
+  GSList *iter;
+  GPtrArray *renames;
+  guint n_components = 0;
+  int i, j;
+
+  fputs ("{\"record\":\"header\",\"format\":\"gnetlist-json\","
+         "\"version\":1,\"files\":[", fp);
+  for (iter = input_files; iter != NULL; iter = g_slist_next (iter)) {
+    char *utf8 = g_filename_to_utf8 (iter->data, -1, NULL, NULL, NULL);
+
+    if (iter != input_files) fputc (',', fp);
+    s_native_write_json_string (fp, (utf8 != NULL) ? utf8 : iter->data);
+    g_free (utf8);
+  }
+  fputs ("]}\n", fp);
+
+  for (nl_current = netlist_head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+    int first = TRUE;
+
+    if (nl_current->component_uref == NULL) continue;
+
+    fputs ("{\"record\":\"component\",\"refdes\":", fp);
+    s_native_write_json_string (fp, nl_current->component_uref);
+    fputs (",\"hierarchy-tag\":", fp);
+    s_native_write_json_string (fp, nl_current->hierarchy_tag);
+    fputs (",\"attributes\":", fp);
+    s_native_write_json_attribs (fp, nl_current->object_ptr);
+    fputs (",\"pins\":[", fp);
+    for (pl_current = nl_current->cpins;
+         pl_current != NULL;
+         pl_current = pl_current->next) {
+      if (pl_current->pin_number == NULL) continue;
+
+      if (!first) fputc (',', fp);
+      fputs ("{\"number\":", fp);
+      s_native_write_json_string (fp, pl_current->pin_number);
+      fputs (",\"net\":", fp);
+      s_native_write_json_string (fp, pl_current->net_name);
+      fputs (",\"label\":", fp);
+      s_native_write_json_string (fp, pl_current->pin_label);
+      fputc ('}', fp);
+      first = FALSE;
+    }
+    fputs ("]}\n", fp);
+    n_components++;
+  }
+
+  for (i = s_netindex_net_count () - 1; i >= 0; i--) {
+    const char *net_name = s_netindex_nth_net (i);
+    int n = s_netindex_connection_count (net_name);
+
+    fputs ("{\"record\":\"net\",\"name\":", fp);
+    s_native_write_json_string (fp, net_name);
+    fputs (",\"connections\":[", fp);
+    for (j = n - 1; j >= 0; j--) {
+      const char *uref;
+      const char *pin;
+
+      s_netindex_nth_connection (net_name, j, &uref, &pin);
+      fputs ((j < n - 1) ? ",[" : "[", fp);
+      s_native_write_json_string (fp, uref);
+      fputc (',', fp);
+      s_native_write_json_string (fp, pin);
+      fputc (']', fp);
+    }
+    fputs ("]}\n", fp);
+  }
+
+  renames = g_ptr_array_new ();
+  s_rename_foreach (s_native_write_json_rename, renames);
+  for (i = (int) renames->len - 2; i >= 0; i -= 2) {
+    fputs ("{\"record\":\"renamed-net\",\"from\":", fp);
+    s_native_write_json_string (fp, g_ptr_array_index (renames, i));
+    fputs (",\"to\":", fp);
+    s_native_write_json_string (fp, g_ptr_array_index (renames, i + 1));
+    fputs ("}\n", fp);
+  }
+  g_ptr_array_free (renames, TRUE);
+
+  fprintf (fp, "{\"record\":\"end\",\"components\":%u,\"nets\":%u}\n",
+           n_components, s_netindex_net_count ());
+}
+
+static const NATIVE_BACKEND native_backends[] = {
+  { "native-PCB",  s_native_write_pcb },
+  { "native-geda", s_native_write_geda },
+  { "native-pads", s_native_write_pads },
+  { "json",        s_native_write_json },
+  { NULL, NULL }
+};
+
+static const NATIVE_BACKEND *
+s_native_lookup (const char *name)
+{
+  const NATIVE_BACKEND *backend;
+
+  for (backend = native_backends; backend->name != NULL; backend++) {
+    if (strcmp (backend->name, name) == 0) return backend;
+  }
+
+  return NULL;
+}
+
+/*! \brief Check whether a backend is built in.
+ *  \param [in] name  Backend name.
+ *  \return TRUE if \a name is the name of a native backend.
+ */
+int
+s_native_is_backend (const char *name)
+{
+  return s_native_lookup (name) != NULL;
+}
+
+/*! \brief Add the names of the built-in backends to a list.
+ *  \param [in] names  List of newly allocated backend names.
+ *  \return The list with a newly allocated copy of each native
+ *          backend name prepended.
+ */
+GList *
+s_native_backend_names (GList *names)
+{
+  const NATIVE_BACKEND *backend;
+
+  for (backend = native_backends; backend->name != NULL; backend++) {
+    names = g_list_prepend (names, g_strdup (backend->name));
+  }
+
+  return names;
+}
+
+/*! \brief Run a built-in backend.
+ *  \par Function Description
+ *  Writes the post-processed netlist to \a filename in the format of
+ *  the native backend \a name.  Errors are raised as Scheme errors, so
+ *  that they are handled like those of Scheme backends.
+ *
+ *  \param [in] name      Backend name.
+ *  \param [in] filename  Output filename.
+ */
+void
+s_native_run (const char *name, const char *filename)
+{
+  const NATIVE_BACKEND *backend = s_native_lookup (name);
+  FILE *fp;
+
+  g_return_if_fail (backend != NULL);
+
+  fp = fopen (filename, "wb");
+  if (fp == NULL) {
+    scm_misc_error (name, "Could not open [~A] for writing",
+                    scm_list_1 (scm_from_locale_string (filename)));
+  }
+  setvbuf (fp, NULL, _IOFBF, NATIVE_BUFFER_SIZE);
+
+  backend->writer (fp);
+
+  if (ferror (fp) | fclose (fp)) {
+    scm_misc_error (name, "Error writing [~A]",
+                    scm_list_1 (scm_from_locale_string (filename)));
+  }
+}
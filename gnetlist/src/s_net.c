@@ -49,6 +49,18 @@ static int unnamed_pin_counter = 1;
 #define MAX_UNNAMED_NETS 99999999
 #define MAX_UNNAMED_PINS 99999999
 
+/*! \brief Restart the numbering of unnamed nets, buses and pins.
+ *  \par Function Description
+ *  Must be called before traversing the design again, so that the
+ *  second netlist names its unnamed nets the same way as the first.
+ */
+void s_net_reset_unnamed(void)
+{
+    unnamed_net_counter = 1;
+    unnamed_bus_counter = 1;
+    unnamed_pin_counter = 1;
+}
+
 /* hack rename this to be s_return_tail */
 /* update object_tail or any list of that matter */
 NET *s_net_return_tail(NET * head)
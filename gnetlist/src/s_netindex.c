@@ -0,0 +1,396 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_netindex.c
+ * \brief Per-net index of the post-processed netlist.
+ *
+ * Backends ask for the unique net names and for the connections of
+ * each net over and over again.  Answering those questions by walking
+ * #netlist_head every time (and deduplicating with scm_member()) is
+ * quadratic in the size of the design, so instead the answers are
+ * computed once, the first time they are needed after traversal, and
+ * the resulting Scheme lists are cached until the index is destroyed.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! One `(uref pin)' connection of a net. */
+typedef struct {
+  char *uref;
+  char *pin;
+} NETINDEX_CONN;
+
+/*! Everything known about a single net name. */
+typedef struct {
+  char *net_name;
+  GPtrArray *connections;   /* NETINDEX_CONN, in first-seen order */
+  GHashTable *seen;         /* "uref pin" keys, only used while building */
+  SCM scm_connections;      /* cached Scheme list, or SCM_UNDEFINED */
+} NETINDEX_NET;
+
+/*! Maps net names to #NETINDEX_NET structures. */
+static GHashTable *net_table = NULL;
+
+/*! Connected nets (i.e. not "unconnected_pin-N") in first-seen order. */
+static GPtrArray *unique_nets = NULL;
+
+/*! Cached result of s_netindex_unique_nets_list(). */
+static SCM scm_unique_nets = SCM_UNDEFINED;
+
+static void
+s_netindex_conn_free (NETINDEX_CONN *conn)
+{
+  g_free (conn->uref);
+  g_free (conn->pin);
+  g_free (conn);
+}
+
+static void
+s_netindex_net_free (NETINDEX_NET *net)
+{
+  guint i;
+
+  for (i = 0; i < net->connections->len; i++) {
+    s_netindex_conn_free (g_ptr_array_index (net->connections, i));
+  }
+  g_ptr_array_free (net->connections, TRUE);
+
+  if (net->seen != NULL) {
+    g_hash_table_destroy (net->seen);
+  }
+
+  if (net->scm_connections != SCM_UNDEFINED) {
+    scm_gc_unprotect_object (net->scm_connections);
+  }
+
+  g_free (net->net_name);
+  g_free (net);
+}
+
+/*! \brief Split a connected_to string into refdes and pin number.
+ *  \par Function Description
+ *  Splits a "uref pin" string the same way sscanf(s, "%s %s") would,
+ *  i.e. into the first two whitespace separated words.  A missing
+ *  word is returned as an empty string.
+ *
+ *  \param [in]  connected_to  String to split.
+ *  \param [out] uref          Newly allocated refdes.
+ *  \param [out] pin           Newly allocated pin number.
+ */
+void
+s_netindex_split_connected_to (const char *connected_to,
+                               char **uref, char **pin)
+{
+  const char *start;
+  const char *end;
+
+  start = connected_to;
+  while (*start != '\0' && g_ascii_isspace (*start)) start++;
+  end = start;
+  while (*end != '\0' && !g_ascii_isspace (*end)) end++;
+  *uref = g_strndup (start, end - start);
+
+  start = end;
+  while (*start != '\0' && g_ascii_isspace (*start)) start++;
+  end = start;
+  while (*end != '\0' && !g_ascii_isspace (*end)) end++;
+  *pin = g_strndup (start, end - start);
+}
+
+static NETINDEX_NET *
+s_netindex_lookup_or_add (const char *net_name)
+{
+  NETINDEX_NET *net = g_hash_table_lookup (net_table, net_name);
+
+  if (net != NULL) return net;
+
+  net = g_new0 (NETINDEX_NET, 1);
+  net->net_name = g_strdup (net_name);
+  net->connections = g_ptr_array_new ();
+  net->seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  net->scm_connections = SCM_UNDEFINED;
+  g_hash_table_insert (net_table, net->net_name, net);
+
+  /* filter off unconnected pins */
+  if (strncmp (net_name, "unconnected_pin", 15) != 0) {
+    g_ptr_array_add (unique_nets, net);
+  }
+
+  return net;
+}
+
+static void
+s_netindex_add_connection (NETINDEX_NET *net, const char *connected_to)
+{
+  NETINDEX_CONN *conn;
+  char *uref;
+  char *pin;
+  char *key;
+
+  s_netindex_split_connected_to (connected_to, &uref, &pin);
+
+  key = g_strconcat (uref, " ", pin, NULL);
+  if (g_hash_table_lookup (net->seen, key) != NULL) {
+    g_free (key);
+    g_free (uref);
+    g_free (pin);
+    return;
+  }
+  g_hash_table_insert (net->seen, key, key);
+
+  conn = g_new (NETINDEX_CONN, 1);
+  conn->uref = uref;
+  conn->pin = pin;
+  g_ptr_array_add (net->connections, conn);
+}
+
+static void
+s_netindex_drop_seen (gpointer key, gpointer value, gpointer user_data)
+{
+  NETINDEX_NET *net = value;
+
+  g_hash_table_destroy (net->seen);
+  net->seen = NULL;
+}
+
+/*! \brief Build the net index from a post-processed netlist.
+ *  \par Function Description
+ *  Walks every pin of every component in \a head once, recording
+ *  each net name and the unique `(uref pin)' connections found on
+ *  it.  Does nothing if the index has already been built; call
+ *  s_netindex_destroy() first to force a rebuild.
+ *
+ *  \param [in] head  Head of the netlist to index.
+ */
+void
+s_netindex_build (NETLIST *head)
+{
+  NETLIST *nl_current;
+  CPINLIST *pl_current;
+  NET *n_current;
+  NETINDEX_NET *net;
+
+  if (net_table != NULL) return;
+
+  net_table = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                     (GDestroyNotify) s_netindex_net_free);
+  unique_nets = g_ptr_array_new ();
+
+  for (nl_current = head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+
+    for (pl_current = nl_current->cpins;
+         pl_current != NULL;
+         pl_current = pl_current->next) {
+
+      if (pl_current->net_name == NULL) continue;
+
+      net = s_netindex_lookup_or_add (pl_current->net_name);
+
+      for (n_current = pl_current->nets;
+           n_current != NULL;
+           n_current = n_current->next) {
+        if (n_current->connected_to != NULL) {
+          s_netindex_add_connection (net, n_current->connected_to);
+        }
+      }
+    }
+  }
+
+  /* The duplicate filters are only needed while building */
+  g_hash_table_foreach (net_table, s_netindex_drop_seen, NULL);
+}
+
+/*! \brief Destroy the net index.
+ *  \par Function Description
+ *  Frees the index and releases any cached Scheme lists.  Must be
+ *  called whenever #netlist_head is rebuilt.
+ */
+void
+s_netindex_destroy (void)
+{
+  if (scm_unique_nets != SCM_UNDEFINED) {
+    scm_gc_unprotect_object (scm_unique_nets);
+    scm_unique_nets = SCM_UNDEFINED;
+  }
+
+  if (unique_nets != NULL) {
+    g_ptr_array_free (unique_nets, TRUE);
+    unique_nets = NULL;
+  }
+
+  if (net_table != NULL) {
+    g_hash_table_destroy (net_table);
+    net_table = NULL;
+  }
+}
+
+/*! \brief Get the list of unique connected net names.
+ *  \par Function Description
+ *  Returns the names of all nets in the design, excluding unconnected
+ *  pins, in the same order as the historical implementation of
+ *  gnetlist:get-all-unique-nets (i.e. reverse order of first
+ *  appearance).
+ *
+ *  \return A Scheme list of net name strings.
+ */
+SCM
+s_netindex_unique_nets_list (void)
+{
+  SCM list = SCM_EOL;
+  guint i;
+
+  s_netindex_build (netlist_head);
+
+  if (scm_unique_nets != SCM_UNDEFINED) {
+    return s_intern_copy_tree (scm_unique_nets);
+  }
+
+  for (i = 0; i < unique_nets->len; i++) {
+    NETINDEX_NET *net = g_ptr_array_index (unique_nets, i);
+    list = scm_cons (s_intern_string (net->net_name), list);
+  }
+
+  scm_unique_nets = scm_gc_protect_object (list);
+  return s_intern_copy_tree (scm_unique_nets);
+}
+
+/*! \brief Get the connections of a net.
+ *  \par Function Description
+ *  Returns the unique `(uref pin)' pairs connected to the net called
+ *  \a net_name, in the same order as the historical implementation of
+ *  gnetlist:get-all-connections.
+ *
+ *  \param [in] net_name  Name of the net.
+ *  \return A Scheme list of two-element lists, or the empty list if
+ *          there is no such net.
+ */
+SCM
+s_netindex_connections_list (const char *net_name)
+{
+  NETINDEX_NET *net;
+  SCM list = SCM_EOL;
+  guint i;
+
+  s_netindex_build (netlist_head);
+
+  net = g_hash_table_lookup (net_table, net_name);
+  if (net == NULL) return SCM_EOL;
+
+  if (net->scm_connections != SCM_UNDEFINED) {
+    return s_intern_copy_tree (net->scm_connections);
+  }
+
+  for (i = 0; i < net->connections->len; i++) {
+    NETINDEX_CONN *conn = g_ptr_array_index (net->connections, i);
+    list = scm_cons (scm_list_2 (s_intern_string (conn->uref),
+                                 s_intern_string (conn->pin)),
+                     list);
+  }
+
+  net->scm_connections = scm_gc_protect_object (list);
+  return s_intern_copy_tree (net->scm_connections);
+}
+
+/*! \brief Get the number of connected nets in the index.
+ *  \return The number of unique net names, excluding unconnected pins.
+ */
+guint
+s_netindex_net_count (void)
+{
+  s_netindex_build (netlist_head);
+  return unique_nets->len;
+}
+
+/*! \brief Get a connected net name by position.
+ *  \par Function Description
+ *  Nets are numbered in order of first appearance in the netlist,
+ *  which is the reverse of the order of s_netindex_unique_nets_list().
+ *
+ *  \param [in] n  Index of the net, less than s_netindex_net_count().
+ *  \return The net name, owned by the index.
+ */
+const char *
+s_netindex_nth_net (guint n)
+{
+  s_netindex_build (netlist_head);
+  g_return_val_if_fail (n < unique_nets->len, NULL);
+
+  return ((NETINDEX_NET *) g_ptr_array_index (unique_nets, n))->net_name;
+}
+
+/*! \brief Get the number of unique connections of a net.
+ *  \param [in] net_name  Name of the net.
+ *  \return The number of unique `(uref pin)' connections, zero if
+ *          there is no such net.
+ */
+guint
+s_netindex_connection_count (const char *net_name)
+{
+  NETINDEX_NET *net;
+
+  s_netindex_build (netlist_head);
+
+  net = g_hash_table_lookup (net_table, net_name);
+  return (net != NULL) ? net->connections->len : 0;
+}
+
+/*! \brief Get a connection of a net by position.
+ *  \par Function Description
+ *  Connections are numbered in order of first appearance, which is
+ *  the reverse of the order of s_netindex_connections_list().
+ *
+ *  \param [in]  net_name  Name of the net.
+ *  \param [in]  n         Index, less than s_netindex_connection_count().
+ *  \param [out] uref      The refdes, owned by the index.
+ *  \param [out] pin       The pin number, owned by the index.
+ */
+void
+s_netindex_nth_connection (const char *net_name, guint n,
+                           const char **uref, const char **pin)
+{
+  NETINDEX_NET *net;
+  NETINDEX_CONN *conn;
+
+  s_netindex_build (netlist_head);
+
+  net = g_hash_table_lookup (net_table, net_name);
+  g_return_if_fail (net != NULL && n < net->connections->len);
+
+  conn = g_ptr_array_index (net->connections, n);
+  *uref = conn->uref;
+  *pin = conn->pin;
+}
@@ -102,6 +102,138 @@ NETLIST *s_netlist_add(NETLIST * ptr)
     }
 }
 
+static void s_netlist_free_nets(NET *n_current)
+{
+    NET *next;
+
+    while (n_current != NULL) {
+	next = n_current->next;
+	g_free(n_current->net_name);
+	g_free(n_current->pin_label);
+	g_free(n_current->connected_to);
+	g_free(n_current);
+	n_current = next;
+    }
+}
+
+/*! \brief Free a netlist.
+ *  \par Function Description
+ *  Frees every node from \a nl_current to the end of the list, with
+ *  their pins and nets.  Post processing names a pin after one of the
+ *  nets it finds (see s_net_name()) without copying the name, so the
+ *  names of all the nets are collected first and such a pin name is
+ *  only freed with its net.
+ */
+void s_netlist_free(NETLIST *nl_current)
+{
+    NETLIST *nl_next;
+    CPINLIST *pl_current;
+    CPINLIST *pl_next;
+    NET *n_current;
+    GHashTable *net_names;
+
+    net_names = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (nl_next = nl_current; nl_next != NULL; nl_next = nl_next->next) {
+	for (pl_current = nl_next->cpins; pl_current != NULL;
+	     pl_current = pl_current->next) {
+	    for (n_current = pl_current->nets; n_current != NULL;
+		 n_current = n_current->next) {
+		if (n_current->net_name != NULL) {
+		    g_hash_table_insert(net_names, n_current->net_name,
+					n_current->net_name);
+		}
+	    }
+	}
+    }
+
+    while (nl_current != NULL) {
+	nl_next = nl_current->next;
+
+	pl_current = nl_current->cpins;
+	while (pl_current != NULL) {
+	    pl_next = pl_current->next;
+	    if (pl_current->net_name != NULL &&
+		g_hash_table_lookup(net_names, pl_current->net_name) == NULL) {
+		g_free(pl_current->net_name);
+	    }
+	    s_netlist_free_nets(pl_current->nets);
+	    g_free(pl_current->pin_number);
+	    g_free(pl_current->pin_label);
+	    g_free(pl_current);
+	    pl_current = pl_next;
+	}
+
+	g_free(nl_current->component_uref);
+	g_free(nl_current->hierarchy_tag);
+	g_free(nl_current);
+	nl_current = nl_next;
+    }
+
+    g_hash_table_destroy(net_names);
+}
+
+/*! \brief Append a copy of a netlist.
+ *  \par Function Description
+ *  Appends a deep copy of every node from \a fragment to the end of
+ *  its list after \a tail.
+ *
+ *  \return The new tail.
+ */
+NETLIST *s_netlist_copy(NETLIST *tail, NETLIST *fragment)
+{
+    NETLIST *nl_current;
+    CPINLIST *pl_current;
+    CPINLIST *pl_new;
+    NET *n_current;
+    NET *n_new;
+
+    for (nl_current = fragment; nl_current != NULL;
+	 nl_current = nl_current->next) {
+
+	tail = s_netlist_add(tail);
+	tail->nlid = nl_current->nlid;
+	tail->component_uref = g_strdup(nl_current->component_uref);
+	tail->object_ptr = nl_current->object_ptr;
+	tail->hierarchy_tag = g_strdup(nl_current->hierarchy_tag);
+	tail->composite_component = nl_current->composite_component;
+
+	pl_new = NULL;
+	for (pl_current = nl_current->cpins; pl_current != NULL;
+	     pl_current = pl_current->next) {
+
+	    pl_new = s_cpinlist_add(pl_new);
+	    if (tail->cpins == NULL) {
+		tail->cpins = pl_new;
+	    }
+
+	    pl_new->plid = pl_current->plid;
+	    pl_new->type = pl_current->type;
+	    pl_new->pin_number = g_strdup(pl_current->pin_number);
+	    pl_new->net_name = g_strdup(pl_current->net_name);
+	    pl_new->pin_label = g_strdup(pl_current->pin_label);
+
+	    n_new = NULL;
+	    for (n_current = pl_current->nets; n_current != NULL;
+		 n_current = n_current->next) {
+
+		n_new = s_net_add(n_new);
+		if (pl_new->nets == NULL) {
+		    pl_new->nets = n_new;
+		}
+
+		n_new->nid = n_current->nid;
+		n_new->net_name_has_priority =
+		    n_current->net_name_has_priority;
+		n_new->net_name = g_strdup(n_current->net_name);
+		n_new->pin_label = g_strdup(n_current->pin_label);
+		n_new->connected_to = g_strdup(n_current->connected_to);
+	    }
+	}
+    }
+
+    return (tail);
+}
+
 void s_netlist_print(NETLIST * ptr)
 {
     NETLIST *nl_current = NULL;
@@ -200,7 +332,11 @@ void s_netlist_post_process(TOPLEVEL * pr_current, NETLIST * head)
 	printf("- Renaming nets:\n");
     }
 
+    /* Phases do not nest: renaming ends the caller's post-process
+     * phase and is reported as a phase of its own */
+    s_stats_phase_begin("rename", NULL);
     s_rename_all(pr_current, head);
+    s_stats_phase_end();
 
     verbose_done();
     if (verbose_mode) {
@@ -0,0 +1,490 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_package.c
+ * \brief Package attribute table.
+ *
+ * Maps each refdes in the post-processed netlist to the symbol
+ * instances carrying it, and each instance to its attributes.  The
+ * table is built once, the first time a package attribute is asked
+ * for after traversal, so that looking up `device', `value',
+ * `footprint' etc. for every package no longer rescans the whole
+ * netlist and every attribute list on each call.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! All symbol instances sharing a refdes. */
+typedef struct {
+  char *refdes;
+  OBJECT *object;           /* the first instance */
+  GPtrArray *instances;     /* GHashTable per instance: name -> value */
+  SCM scm_slotdefs;         /* cached s_package_slotdefs(), or SCM_UNDEFINED */
+} PACKAGE_INFO;
+
+/*! Maps refdes strings to #PACKAGE_INFO structures. */
+static GHashTable *package_table = NULL;
+
+/*! Packages in the same order as gnetlist:get-packages returns them. */
+static GPtrArray *package_order = NULL;
+
+static void
+s_package_free (PACKAGE_INFO *package)
+{
+  guint i;
+
+  for (i = 0; i < package->instances->len; i++) {
+    g_hash_table_destroy (g_ptr_array_index (package->instances, i));
+  }
+  g_ptr_array_free (package->instances, TRUE);
+
+  if (package->scm_slotdefs != SCM_UNDEFINED) {
+    scm_gc_unprotect_object (package->scm_slotdefs);
+  }
+
+  g_free (package->refdes);
+  g_free (package);
+}
+
+/*! \brief Collect the attributes of a symbol instance.
+ *  \par Function Description
+ *  Returns a table of the attached and inherited attributes of
+ *  \a object.  Where an attribute name occurs more than once, only the
+ *  first value is kept, matching o_attrib_search_object_attribs_by_name()
+ *  with a counter of zero.
+ */
+static GHashTable *
+s_package_instance_attribs (OBJECT *object)
+{
+  GHashTable *attribs;
+  GList *list;
+  GList *iter;
+  char *name;
+  char *value;
+
+  attribs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  list = o_attrib_return_attribs (object);
+  for (iter = list; iter != NULL; iter = g_list_next (iter)) {
+    if (!o_attrib_get_name_value (iter->data, &name, &value))
+      continue;
+
+    if (g_hash_table_lookup_extended (attribs, name, NULL, NULL)) {
+      g_free (name);
+      g_free (value);
+      continue;
+    }
+    g_hash_table_insert (attribs, name, value);
+  }
+  g_list_free (list);
+
+  return attribs;
+}
+
+/*! \brief Build the package table from a post-processed netlist.
+ *  \par Function Description
+ *  Does nothing if the table has already been built; call
+ *  s_package_destroy() first to force a rebuild.
+ *
+ *  \param [in] head  Head of the netlist to index.
+ */
+void
+s_package_build (NETLIST *head)
+{
+  NETLIST *nl_current;
+  PACKAGE_INFO *package;
+  guint i;
+
+  if (package_table != NULL) return;
+
+  package_table = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                         (GDestroyNotify) s_package_free);
+  package_order = g_ptr_array_new ();
+
+  for (nl_current = head;
+       nl_current != NULL;
+       nl_current = nl_current->next) {
+
+    if (nl_current->component_uref == NULL) continue;
+
+    package = g_hash_table_lookup (package_table, nl_current->component_uref);
+    if (package == NULL) {
+      package = g_new0 (PACKAGE_INFO, 1);
+      package->refdes = g_strdup (nl_current->component_uref);
+      package->object = nl_current->object_ptr;
+      package->instances = g_ptr_array_new ();
+      package->scm_slotdefs = SCM_UNDEFINED;
+      g_hash_table_insert (package_table, package->refdes, package);
+      g_ptr_array_add (package_order, package);
+    }
+
+    g_ptr_array_add (package->instances,
+                     s_package_instance_attribs (nl_current->object_ptr));
+  }
+
+  /* gnetlist:get-packages conses as it goes, so it yields the
+   * packages in reverse order of first appearance */
+  for (i = 0; i < package_order->len / 2; i++) {
+    gpointer tmp = package_order->pdata[i];
+    package_order->pdata[i] = package_order->pdata[package_order->len - 1 - i];
+    package_order->pdata[package_order->len - 1 - i] = tmp;
+  }
+}
+
+/*! \brief Destroy the package table.
+ *  \par Function Description
+ *  Frees the table and releases any cached Scheme lists.  Must be
+ *  called whenever #netlist_head is rebuilt.
+ */
+void
+s_package_destroy (void)
+{
+  if (package_order != NULL) {
+    g_ptr_array_free (package_order, TRUE);
+    package_order = NULL;
+  }
+
+  if (package_table != NULL) {
+    g_hash_table_destroy (package_table);
+    package_table = NULL;
+  }
+}
+
+/*! \brief Build the list of values of an attribute on a package.
+ *  \par Function Description
+ *  The list is built afresh on every call, since backends are free to
+ *  modify what they are given; the values themselves have already been
+ *  looked up when the table was built, and the strings come from
+ *  s_intern_string(), so this only costs a cons per instance.
+ */
+static SCM
+s_package_values_list (PACKAGE_INFO *package, const char *name)
+{
+  SCM values = SCM_EOL;
+  int i;
+
+  for (i = package->instances->len - 1; i >= 0; i--) {
+    char *value = g_hash_table_lookup (g_ptr_array_index (package->instances, i),
+                                       name);
+    values = scm_cons (s_intern_string (value), values);
+  }
+
+  return values;
+}
+
+/*! \brief Get the values of an attribute on every instance of a package.
+ *  \par Function Description
+ *  Returns the first value of attribute \a name on each symbol instance
+ *  with refdes \a refdes, in netlist order, with #f for instances that
+ *  do not have the attribute.
+ *
+ *  \param [in] refdes  Package reference.
+ *  \param [in] name    Attribute name.
+ *  \return A Scheme list of strings and #f, empty if there is no such
+ *          package.
+ */
+SCM
+s_package_attribute_values (const char *refdes, const char *name)
+{
+  PACKAGE_INFO *package;
+
+  s_package_build (netlist_head);
+
+  package = g_hash_table_lookup (package_table, refdes);
+  if (package == NULL) return SCM_EOL;
+
+  return s_package_values_list (package, name);
+}
+
+/*! \brief Get the values of an attribute for all packages.
+ *  \par Function Description
+ *  Returns an association list mapping each refdes to the list that
+ *  s_package_attribute_values() would return for it.  Packages appear
+ *  in the same order as gnetlist:get-packages returns them.
+ *
+ *  \param [in] name  Attribute name.
+ *  \return A Scheme association list.
+ */
+SCM
+s_package_all_attribute_values (const char *name)
+{
+  SCM alist = SCM_EOL;
+  int i;
+
+  s_package_build (netlist_head);
+
+  for (i = package_order->len - 1; i >= 0; i--) {
+    PACKAGE_INFO *package = g_ptr_array_index (package_order, i);
+    alist = scm_cons (scm_cons (s_intern_string (package->refdes),
+                                s_package_values_list (package, name)),
+                      alist);
+  }
+
+  return alist;
+}
+
+/*! \brief Get the number of packages in the table.
+ *  \return The number of unique refdes values in the netlist.
+ */
+guint
+s_package_count (void)
+{
+  s_package_build (netlist_head);
+  return package_order->len;
+}
+
+/*! \brief Get a package refdes by position.
+ *  \par Function Description
+ *  Packages are numbered in the same order as gnetlist:get-packages
+ *  returns them.
+ *
+ *  \param [in] n  Index of the package, less than s_package_count().
+ *  \return The refdes, owned by the table.
+ */
+const char *
+s_package_nth_refdes (guint n)
+{
+  s_package_build (netlist_head);
+  g_return_val_if_fail (n < package_order->len, NULL);
+
+  return ((PACKAGE_INFO *) g_ptr_array_index (package_order, n))->refdes;
+}
+
+/*! \brief Get the number of symbol instances of a package.
+ *  \param [in] refdes  Package reference.
+ *  \return The number of instances, zero if there is no such package.
+ */
+guint
+s_package_instance_count (const char *refdes)
+{
+  PACKAGE_INFO *package;
+
+  s_package_build (netlist_head);
+
+  package = g_hash_table_lookup (package_table, refdes);
+  return (package != NULL) ? package->instances->len : 0;
+}
+
+/*! \brief Get an attribute value of one instance of a package.
+ *  \param [in] refdes    Package reference.
+ *  \param [in] instance  Index of the instance, in netlist order.
+ *  \param [in] name      Attribute name.
+ *  \return The first value of the attribute, owned by the table, or
+ *          NULL if the instance does not have it.
+ */
+const char *
+s_package_instance_attribute (const char *refdes, guint instance,
+                              const char *name)
+{
+  PACKAGE_INFO *package;
+
+  s_package_build (netlist_head);
+
+  package = g_hash_table_lookup (package_table, refdes);
+  if (package == NULL || instance >= package->instances->len) return NULL;
+
+  return g_hash_table_lookup (g_ptr_array_index (package->instances, instance),
+                              name);
+}
+
+/*! \brief Get the value of an attribute of a package.
+ *  \par Function Description
+ *  Does what the default gnetlist:get-package-attribute does: returns
+ *  the value on the first symbol instance of the package, or "unknown"
+ *  if it has none, and warns on standard error if the instances do not
+ *  all have the same value.
+ *
+ *  \param [in] refdes  Package reference.
+ *  \param [in] name    Attribute name.
+ *  \return The value, owned by the table, or "unknown".
+ */
+const char *
+s_package_unique_attribute (const char *refdes, const char *name)
+{
+  const char *value;
+  guint n_instances;
+  guint i;
+
+  n_instances = s_package_instance_count (refdes);
+  if (n_instances == 0) return "unknown";
+
+  value = s_package_instance_attribute (refdes, 0, name);
+
+  for (i = 1; i < n_instances; i++) {
+    const char *other = s_package_instance_attribute (refdes, i, name);
+
+    if ((value == NULL) != (other == NULL)
+        || (value != NULL && strcmp (value, other) != 0)) {
+      break;
+    }
+  }
+
+  if (i < n_instances) {
+    fprintf (stderr,
+             "Possible attribute conflict for refdes: %s\n"
+             "name: %s\n"
+             "values: (", refdes, name);
+    for (i = 0; i < n_instances; i++) {
+      const char *other = s_package_instance_attribute (refdes, i, name);
+      fprintf (stderr, "%s%s", (i > 0) ? " " : "",
+               (other != NULL) ? other : "#f");
+    }
+    fprintf (stderr, ")\n");
+  }
+
+  return (value != NULL) ? value : "unknown";
+}
+
+static void
+s_package_collect_name (gpointer key, gpointer value, gpointer user_data)
+{
+  g_hash_table_insert ((GHashTable *) user_data, key, key);
+}
+
+/*! \brief Get the names of all attributes of a package.
+ *  \par Function Description
+ *  Returns the union of the attribute names found on any instance of
+ *  \a refdes, sorted alphabetically.
+ *
+ *  \param [in] refdes  Package reference.
+ *  \return A GList of names owned by the table; the caller must
+ *          g_list_free() the list itself.
+ */
+GList *
+s_package_attribute_names (const char *refdes)
+{
+  PACKAGE_INFO *package;
+  GHashTable *names;
+  GList *result;
+  guint i;
+
+  s_package_build (netlist_head);
+
+  package = g_hash_table_lookup (package_table, refdes);
+  if (package == NULL) return NULL;
+
+  names = g_hash_table_new (g_str_hash, g_str_equal);
+  for (i = 0; i < package->instances->len; i++) {
+    g_hash_table_foreach (g_ptr_array_index (package->instances, i),
+                          s_package_collect_name, names);
+  }
+  result = g_list_sort (g_hash_table_get_keys (names), (GCompareFunc) strcmp);
+  g_hash_table_destroy (names);
+
+  return result;
+}
+
+/*! One slot of a package, while sorting slotdefs. */
+typedef struct {
+  long slot;
+  gchar **pins;
+} PACKAGE_SLOT;
+
+static gint
+s_package_compare_slots (gconstpointer a, gconstpointer b)
+{
+  long slot_a = ((const PACKAGE_SLOT *) a)->slot;
+  long slot_b = ((const PACKAGE_SLOT *) b)->slot;
+
+  return (slot_a > slot_b) - (slot_a < slot_b);
+}
+
+/*! \brief Get the slot table of a package.
+ *  \par Function Description
+ *  Returns the slotdef= attributes of the first instance of \a refdes,
+ *  parsed once and cached, as an association list from slot number to
+ *  the list of pin numbers of that slot, in pinseq order.  Slots are
+ *  sorted by number.  Slot numbers that are not integers are left out.
+ *
+ *  \param [in] refdes  Package reference.
+ *  \return A Scheme association list, empty if the package has no
+ *          slotdefs or does not exist.
+ */
+SCM
+s_package_slotdefs (const char *refdes)
+{
+  PACKAGE_INFO *package;
+  GHashTable *slotdefs;
+  GHashTableIter iter;
+  gpointer key, value;
+  GArray *slots;
+  SCM alist = SCM_EOL;
+  int i;
+
+  s_package_build (netlist_head);
+
+  package = g_hash_table_lookup (package_table, refdes);
+  if (package == NULL || package->object == NULL) return SCM_EOL;
+
+  if (package->scm_slotdefs != SCM_UNDEFINED) {
+    return s_intern_copy_tree (package->scm_slotdefs);
+  }
+
+  slotdefs = s_slot_parse_slotdefs (package->object);
+
+  slots = g_array_new (FALSE, FALSE, sizeof (PACKAGE_SLOT));
+  g_hash_table_iter_init (&iter, slotdefs);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    PACKAGE_SLOT slot;
+    char *end;
+
+    slot.slot = strtol (key, &end, 10);
+    if (*(char *) key == '\0' || *end != '\0') continue;
+
+    slot.pins = value;
+    g_array_append_val (slots, slot);
+  }
+  g_array_sort (slots, s_package_compare_slots);
+
+  for (i = slots->len - 1; i >= 0; i--) {
+    PACKAGE_SLOT *slot = &g_array_index (slots, PACKAGE_SLOT, i);
+    SCM pins = SCM_EOL;
+    int j;
+
+    for (j = g_strv_length (slot->pins) - 1; j >= 0; j--) {
+      pins = scm_cons (s_intern_string (slot->pins[j]), pins);
+    }
+    alist = scm_cons (scm_cons (scm_from_long (slot->slot), pins), alist);
+  }
+
+  g_array_free (slots, TRUE);
+  g_hash_table_destroy (slotdefs);
+
+  package->scm_slotdefs = scm_gc_protect_object (alist);
+  return s_intern_copy_tree (alist);
+}
@@ -52,17 +52,48 @@ typedef struct {
     void * next;
     char * src;
     char * dest;
+    guint index;              /* position within its set */
 } RENAME;
 
 typedef struct {
     void * next_set;
     RENAME * first_rename;
     RENAME * last_rename;
+    guint n_renames;
+    GHashTable * by_src;      /* src -> GPtrArray of RENAME, in order */
 } SET;
 
 static SET * first_set = NULL;
 static SET * last_set = NULL;
 
+static void s_rename_free_array(gpointer array)
+{
+    g_ptr_array_free(array, TRUE);
+}
+
+static SET *s_rename_new_set(void)
+{
+    SET * new_set;
+
+    new_set = g_malloc(sizeof(SET));
+    memset(new_set,0,sizeof(SET));
+    new_set->by_src = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                            s_rename_free_array);
+    return new_set;
+}
+
+/*! \brief Get the renames of the current set with a given source.
+ *  \return A GPtrArray of RENAME in the order they were added, or NULL.
+ */
+static GPtrArray *s_rename_lookup_src(const char *src)
+{
+    if (last_set == NULL)
+    {
+        return NULL;
+    }
+    return g_hash_table_lookup(last_set->by_src, src);
+}
+
 void s_rename_init(void)
 {
     if (first_set)
@@ -79,6 +110,7 @@ void s_rename_destroy_all(void)
     
     for (; first_set;)
     {
+        g_hash_table_destroy(first_set->by_src);
         for (temp = first_set->first_rename; temp;)
         {
             g_free(temp->src);
@@ -98,8 +130,7 @@ void s_rename_next_set(void)
 {
     SET * new_set;
     
-    new_set = g_malloc(sizeof(SET));
-    memset(new_set,0,sizeof(SET));
+    new_set = s_rename_new_set();
     if (first_set)
     {
         last_set->next_set = new_set;
@@ -132,27 +163,35 @@ void s_rename_print(void)
 /* If quiet_flag is true than don't print anything */
 int s_rename_search(char *src, char *dest, int quiet_flag)
 {
-    RENAME * temp;
+    GPtrArray * renames;
+    RENAME * by_src = NULL;
+    RENAME * by_dest = NULL;
 
-    if (last_set)
+    renames = s_rename_lookup_src(src);
+    if (renames != NULL)
     {
-        for (temp = last_set->first_rename; temp; temp = temp->next)
-        {
-            if (strcmp(src, temp->src) == 0) 
-            {
-                return (TRUE);
-            }
+        by_src = g_ptr_array_index(renames, 0);
+    }
+    renames = s_rename_lookup_src(dest);
+    if (renames != NULL)
+    {
+        by_dest = g_ptr_array_index(renames, 0);
+    }
 
-            if (strcmp(dest, temp->src) == 0) 
-	    {
-                if (!quiet_flag) 
-	        {
-                    fprintf(stderr,"WARNING: Trying to rename something twice:\n\t%s and %s\nare both a src and dest name\n", dest, temp->src);
-                    fprintf(stderr,"This warning is okay if you have multiple levels of hierarchy!\n");
-                }
-                return (TRUE);
-            }
-	}
+    /* whichever was added first decides, as when scanning the list */
+    if (by_src != NULL && (by_dest == NULL || by_src->index <= by_dest->index))
+    {
+        return (TRUE);
+    }
+
+    if (by_dest != NULL)
+    {
+        if (!quiet_flag) 
+        {
+            fprintf(stderr,"WARNING: Trying to rename something twice:\n\t%s and %s\nare both a src and dest name\n", dest, by_dest->src);
+            fprintf(stderr,"This warning is okay if you have multiple levels of hierarchy!\n");
+        }
+        return (TRUE);
     }
     return (FALSE);
 }
@@ -160,6 +199,7 @@ int s_rename_search(char *src, char *dest, int quiet_flag)
 static void s_rename_add_lowlevel (const char *src, const char *dest)
 {
     RENAME *new_rename;
+    GPtrArray *renames;
 
     g_return_if_fail(last_set != NULL);
 
@@ -170,6 +210,7 @@ static void s_rename_add_lowlevel (const char *src, const char *dest)
     new_rename->next = NULL;
     new_rename->src = g_strdup(src);
     new_rename->dest = g_strdup(dest);
+    new_rename->index = last_set->n_renames++;
 
     if (last_set->first_rename == NULL)
     {
@@ -180,29 +221,58 @@ static void s_rename_add_lowlevel (const char *src, const char *dest)
         last_set->last_rename->next = new_rename;
         last_set->last_rename = new_rename;
     }
+
+    renames = g_hash_table_lookup(last_set->by_src, new_rename->src);
+    if (renames == NULL)
+    {
+        renames = g_ptr_array_new();
+        g_hash_table_insert(last_set->by_src, new_rename->src, renames);
+    }
+    g_ptr_array_add(renames, new_rename);
 }
 
 void s_rename_add(char *src, char *dest)
 {
     int flag;
-    RENAME * last;
+    GPtrArray * with_dest;
+    GPtrArray * with_src;
+    guint n_dest, n_src;
+    guint i, j;
     RENAME * temp;
-    RENAME * new_rename;
-    SET * new_set;
 
     if (src == NULL || dest == NULL) 
     {
         return;
     }
 
+    s_stats_add("rename-operations", 1);
+
     flag = s_rename_search(src, dest, FALSE);
 
     if (flag) 
     {
-        /* If found follow the original behaviour, limiting the operation to the current end-of-list */
-	last = last_set->last_rename;
-	for (temp = last_set->first_rename; ; temp = temp->next)
-	{
+        /* If found follow the original behaviour, limiting the operation to the current end-of-list.
+         * Only renames whose src is dest or src can match, so visit just
+         * those, merged back into the order they were added in. */
+        with_dest = s_rename_lookup_src(dest);
+        with_src = (strcmp(src, dest) == 0) ? NULL : s_rename_lookup_src(src);
+        n_dest = with_dest ? with_dest->len : 0;
+        n_src = with_src ? with_src->len : 0;
+
+        for (i = 0, j = 0; i < n_dest || j < n_src; )
+        {
+            if (j == n_src
+                || (i < n_dest
+                    && ((RENAME *) g_ptr_array_index(with_dest, i))->index
+                       < ((RENAME *) g_ptr_array_index(with_src, j))->index))
+            {
+                temp = g_ptr_array_index(with_dest, i++);
+            }
+            else
+            {
+                temp = g_ptr_array_index(with_src, j++);
+            }
+
         if ((strcmp(dest, temp->src) == 0)
             && (strcmp(src, temp->dest) != 0))
         {
@@ -232,10 +302,6 @@ void s_rename_add(char *src, char *dest)
 #endif
             s_rename_add_lowlevel(dest, temp->dest);
         }
-            if (temp == last)
-            {
-                break;
-            }
         }
     } 
     else 
@@ -243,23 +309,9 @@ void s_rename_add(char *src, char *dest)
         /* Check for a valid set */
 	if (first_set == NULL)
 	{
-	    new_set = g_malloc(sizeof(SET));
-	        memset(new_set,0,sizeof(SET));
-		first_set = last_set = new_set;
+	    first_set = last_set = s_rename_new_set();
 	}    
-        new_rename = g_malloc(sizeof(RENAME));
-	     new_rename->next = NULL;
-             new_rename->src = g_strdup(src);
-             new_rename->dest = g_strdup(dest);
-	     if (last_set->first_rename == NULL)
-	     {
-	         last_set->first_rename = last_set->last_rename = new_rename;
-	     }
-	     else
-	     {
-	         last_set->last_rename->next = new_rename;
-		 last_set->last_rename = new_rename;
-	     } 
+        s_rename_add_lowlevel(src, dest);
     }
 }
 
@@ -294,18 +346,105 @@ void s_rename_all_lowlevel(NETLIST * netlist_head, char *src, char *dest)
 void s_rename_all(TOPLEVEL * pr_current, NETLIST * netlist_head)
 {
     RENAME * temp;
+    GHashTable * pins_by_net;
+    GPtrArray * pins;
+    GPtrArray * dest_pins;
+    gpointer key;
+    NETLIST * nl_current;
+    CPINLIST * pl_current;
+    guint i;
     
 #if DEBUG
     s_rename_print();
 #endif
 
-    if (last_set)
+    if (last_set == NULL || last_set->first_rename == NULL)
+    {
+        return;
+    }
+
+    /* Index the pins by net name once, then move them from net to net
+     * as the renames are applied in order, rather than scanning the
+     * whole netlist for every rename. */
+    pins_by_net = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                        s_rename_free_array);
+
+    for (nl_current = netlist_head; nl_current; nl_current = nl_current->next)
     {
-        for (temp = last_set->first_rename; temp; temp = temp->next)
+        for (pl_current = nl_current->cpins; pl_current; pl_current = pl_current->next)
         {
-            verbose_print("R");
-            s_rename_all_lowlevel(netlist_head, temp->src, temp->dest);
-	}
+            if (pl_current->net_name == NULL)
+            {
+                continue;
+            }
+            pins = g_hash_table_lookup(pins_by_net, pl_current->net_name);
+            if (pins == NULL)
+            {
+                pins = g_ptr_array_new();
+                g_hash_table_insert(pins_by_net, g_strdup(pl_current->net_name), pins);
+            }
+            g_ptr_array_add(pins, pl_current);
+        }
+    }
+
+    for (temp = last_set->first_rename; temp; temp = temp->next)
+    {
+        verbose_print("R");
+
+        if (!g_hash_table_lookup_extended(pins_by_net, temp->src, &key,
+                                          (gpointer *) &pins))
+        {
+            continue;
+        }
+        g_hash_table_steal(pins_by_net, temp->src);
+        g_free(key);
+
+        for (i = 0; i < pins->len; i++)
+        {
+            pl_current = g_ptr_array_index(pins, i);
+            pl_current->net_name = g_strdup(temp->dest);
+        }
+
+        dest_pins = g_hash_table_lookup(pins_by_net, temp->dest);
+        if (dest_pins == NULL)
+        {
+            g_hash_table_insert(pins_by_net, g_strdup(temp->dest), pins);
+        }
+        else
+        {
+            for (i = 0; i < pins->len; i++)
+            {
+                g_ptr_array_add(dest_pins, g_ptr_array_index(pins, i));
+            }
+            g_ptr_array_free(pins, TRUE);
+        }
+    }
+
+    g_hash_table_destroy(pins_by_net);
+}
+
+
+/*! \brief Call a function for every rename.
+ *  \par Function Description
+ *  Calls \a func with the source and destination net names of every
+ *  rename of every set, in the order they were added.
+ *
+ *  \param [in] func       Function to call.
+ *  \param [in] user_data  Passed on to \a func.
+ */
+void s_rename_foreach(void (*func) (const char *src, const char *dest,
+                                    gpointer user_data),
+                      gpointer user_data)
+{
+    SET * temp_set;
+    RENAME * temp_rename;
+
+    for (temp_set = first_set; temp_set; temp_set = temp_set->next_set)
+    {
+        for (temp_rename = temp_set->first_rename; temp_rename; temp_rename = temp_rename->next)
+        {
+            func (temp_rename->src, temp_rename->dest, user_data);
+        }
     }
 }
 
@@ -324,8 +463,8 @@ SCM g_get_renamed_nets(SCM scm_level)
     {
         for (temp_rename = temp_set->first_rename; temp_rename; temp_rename = temp_rename->next)
         {
-            pairlist = scm_list_n (scm_from_utf8_string (temp_rename->src),
-                                   scm_from_utf8_string (temp_rename->dest),
+            pairlist = scm_list_n (s_intern_string (temp_rename->src),
+                                   s_intern_string (temp_rename->dest),
                                    SCM_UNDEFINED);
             outerlist = scm_cons (pairlist, outerlist);
         }
@@ -0,0 +1,735 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_server.c
+ * \brief gnetlist server mode.
+ *
+ * In server mode (<tt>--server</tt>) gnetlist reads its rc files and
+ * scans the component libraries once, and then answers netlist
+ * requests read from standard input, or from clients of a UNIX domain
+ * socket (<tt>--server=SOCKET</tt>).
+ *
+ * Each request is a single line holding a gnetlist command line,
+ * quoted as for a shell:
+ *
+ * <pre>
+ *   -g BACKEND[:OUTFILE] ... [-o OUTFILE] [-O STRING ...] [--] FILE ...
+ * </pre>
+ *
+ * Relative filenames are taken relative to the directory the server
+ * was started in.  The server answers each request with a single line,
+ * either <tt>OK</tt> or <tt>ERROR</tt> followed by a message.  The
+ * line <tt>quit</tt> ends the session, and <tt>shutdown</tt> stops the
+ * server.
+ *
+ * Schematics stay loaded between requests, and are only read again
+ * when the file, or the file of one of the symbols it uses, has been
+ * modified.  Likewise the traversal result of each schematic is kept,
+ * and only schematics which have changed, or whose sub-sheets or
+ * symbols have changed, are traversed again (see
+ * s_traverse_set_incremental()).  Post processing and the backends run
+ * in a child process forked for each request, so that nothing they do
+ * (including any definitions made by backends) outlives the request.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+#include <signal.h>
+#ifdef HAVE_SYS_UN_H
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+#if defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+
+/*! What a file looked like when it was read. */
+typedef struct {
+  time_t mtime;
+  off_t size;
+} FILE_STAMP;
+
+/*! A schematic kept loaded by the server. */
+typedef struct {
+  PAGE *page;
+  FILE_STAMP stamp;
+  char *hash;           /* SHA-1 of the file as it was loaded */
+  GPtrArray *symbols;   /* filenames of the library symbols it uses */
+} SERVER_PAGE;
+
+/*! Loaded schematics, by absolute filename. */
+static GHashTable *server_pages = NULL;
+
+/*! Library symbol files used by loaded schematics, by filename. */
+static GHashTable *symbol_stamps = NULL;
+
+/*! Library symbols by filename, so their cached data can be dropped. */
+static GHashTable *symbol_by_file = NULL;
+
+/*! Ids of the sub-sheet pages whose symbols have been recorded. */
+static GHashTable *subsheet_pids = NULL;
+
+static void
+s_server_page_free (SERVER_PAGE *spage)
+{
+  g_ptr_array_foreach (spage->symbols, (GFunc) g_free, NULL);
+  g_ptr_array_free (spage->symbols, TRUE);
+  g_free (spage->hash);
+  g_free (spage);
+}
+
+/*! \brief Read the modification stamp of a file.
+ *  \return FALSE if the file cannot be examined.
+ */
+static int
+s_server_stamp (const char *filename, FILE_STAMP *stamp)
+{
+  struct stat buf;
+
+  if (stat (filename, &buf) != 0) {
+    return FALSE;
+  }
+
+  stamp->mtime = buf.st_mtime;
+  stamp->size = buf.st_size;
+  return TRUE;
+}
+
+/*! \brief Compute the SHA-1 of the contents of a file.
+ *  \return A newly allocated string, or NULL if the file cannot be read.
+ */
+static char *
+s_server_hash (const char *filename)
+{
+  gchar *contents;
+  gsize length;
+  char *hash;
+
+  if (!g_file_get_contents (filename, &contents, &length, NULL)) {
+    return NULL;
+  }
+
+  hash = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+                                      (const guchar *) contents, length);
+  g_free (contents);
+  return hash;
+}
+
+/*! \brief Remember which library symbols a page uses.
+ *  \par Function Description
+ *  Starts watching the file of every library symbol used on \a page,
+ *  so that s_server_changed_symbols() notices when it is modified.
+ *
+ *  \param [in]  page     The page.
+ *  \param [out] symbols  Array to add the symbol filenames to, or NULL.
+ */
+static void
+s_server_record_symbols (PAGE *page, GPtrArray *symbols)
+{
+  const GList *iter;
+  GHashTable *seen;
+
+  seen = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                (symbols == NULL) ? g_free : NULL, NULL);
+
+  for (iter = s_page_objects (page); iter != NULL;
+       iter = g_list_next (iter)) {
+    OBJECT *o_current = iter->data;
+    const CLibSymbol *symbol;
+    FILE_STAMP *stamp;
+    char *filename;
+
+    if (o_current->type != OBJ_COMPLEX || o_current->complex_embedded
+        || o_current->complex_basename == NULL) {
+      continue;
+    }
+
+    symbol = s_clib_get_symbol_by_name (o_current->complex_basename);
+    if (symbol == NULL) continue;
+
+    /* Symbols from commands or Scheme procedures have no file */
+    filename = s_clib_symbol_get_filename (symbol);
+    if (filename == NULL) continue;
+
+    if (g_hash_table_lookup (seen, filename) != NULL) {
+      g_free (filename);
+      continue;
+    }
+    g_hash_table_insert (seen, filename, filename);
+    if (symbols != NULL) {
+      g_ptr_array_add (symbols, filename);
+    }
+
+    if (g_hash_table_lookup (symbol_stamps, filename) == NULL) {
+      stamp = g_new (FILE_STAMP, 1);
+      if (!s_server_stamp (filename, stamp)) {
+        stamp->mtime = 0;
+        stamp->size = -1;
+      }
+      g_hash_table_insert (symbol_stamps, g_strdup (filename), stamp);
+      g_hash_table_insert (symbol_by_file, g_strdup (filename),
+                           (gpointer) symbol);
+    }
+  }
+
+  g_hash_table_destroy (seen);
+}
+
+/*! \brief Remember which library symbols the loaded sub-sheets use.
+ *  \par Function Description
+ *  Sub-sheets are loaded by traversal rather than by the server, but
+ *  the symbols they use have to be watched all the same: otherwise a
+ *  modified symbol used only in a sub-sheet would keep its cached
+ *  data, and the sub-sheet would be read again with the old symbol.
+ */
+static void
+s_server_record_subsheets (TOPLEVEL *pr_current)
+{
+  GList *iter;
+
+  for (iter = geda_list_get_glist (pr_current->pages); iter != NULL;
+       iter = g_list_next (iter)) {
+    PAGE *page = iter->data;
+
+    if (page->page_control == 0
+        || g_hash_table_lookup (subsheet_pids,
+                                GINT_TO_POINTER (page->pid)) != NULL) {
+      continue;
+    }
+
+    s_server_record_symbols (page, NULL);
+    g_hash_table_insert (subsheet_pids, GINT_TO_POINTER (page->pid),
+                         GINT_TO_POINTER (TRUE));
+  }
+}
+
+/*! \brief Find library symbols modified since they were read.
+ *  \par Function Description
+ *  Drops the cached data of every modified symbol, so that it is read
+ *  again, and updates its stamp.
+ *
+ *  \return A table of the filenames of the modified symbols.
+ */
+static GHashTable *
+s_server_changed_symbols (void)
+{
+  GHashTable *changed;
+  GHashTableIter iter;
+  gpointer key, value;
+
+  changed = g_hash_table_new (g_str_hash, g_str_equal);
+
+  g_hash_table_iter_init (&iter, symbol_stamps);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    FILE_STAMP *stamp = value;
+    FILE_STAMP now;
+
+    if (!s_server_stamp (key, &now)) {
+      now.mtime = 0;
+      now.size = -1;
+    }
+
+    if (now.mtime != stamp->mtime || now.size != stamp->size) {
+      *stamp = now;
+      s_clib_symbol_invalidate_data (g_hash_table_lookup (symbol_by_file, key));
+      g_hash_table_insert (changed, key, key);
+    }
+  }
+
+  return changed;
+}
+
+/*! \brief Check whether a loaded schematic needs to be read again.
+ *  \par Function Description
+ *  The contents of the file are compared as well as its stamp: a file
+ *  can be changed without changing its modification time or size, and
+ *  the traversal cache, which goes by content, would then store the
+ *  result of the old page under the hash of the new file.
+ */
+static int
+s_server_page_stale (SERVER_PAGE *spage, const char *filename,
+                     GHashTable *changed_symbols)
+{
+  FILE_STAMP now;
+  char *hash;
+  int stale;
+  guint i;
+
+  if (!s_server_stamp (filename, &now)
+      || now.mtime != spage->stamp.mtime
+      || now.size != spage->stamp.size) {
+    return TRUE;
+  }
+
+  hash = s_server_hash (filename);
+  stale = (hash == NULL || spage->hash == NULL
+           || strcmp (hash, spage->hash) != 0);
+  g_free (hash);
+  if (stale) {
+    return TRUE;
+  }
+
+  for (i = 0; i < spage->symbols->len; i++) {
+    if (g_hash_table_lookup (changed_symbols,
+                             g_ptr_array_index (spage->symbols, i)) != NULL) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/*! \brief Get a loaded schematic, reading it if necessary.
+ *  \param [in]  pr_current       The current #TOPLEVEL structure.
+ *  \param [in]  filename         Absolute filename of the schematic.
+ *  \param [in]  changed_symbols  Symbol files modified since last time.
+ *  \param [out] err              Set if the schematic could not be read.
+ *  \return The page, or NULL on error.
+ */
+static PAGE *
+s_server_get_page (TOPLEVEL *pr_current, const char *filename,
+                   GHashTable *changed_symbols, GError **err)
+{
+  SERVER_PAGE *spage;
+  FILE_STAMP stamp;
+  char *hash;
+
+  spage = g_hash_table_lookup (server_pages, filename);
+  if (spage != NULL) {
+    if (!s_server_page_stale (spage, filename, changed_symbols)) {
+      return spage->page;
+    }
+
+    s_page_delete (pr_current, spage->page);
+    g_hash_table_remove (server_pages, filename);
+  }
+
+  if (!s_server_stamp (filename, &stamp)) {
+    g_set_error (err, G_FILE_ERROR, G_FILE_ERROR_NOENT,
+                 "Could not find '%s'", filename);
+    return NULL;
+  }
+  hash = s_server_hash (filename);
+
+  if (!quiet_mode) {
+    s_log_message ("Loading schematic [%s]\n", filename);
+    fprintf (stderr, "Loading schematic [%s]\n", filename);
+  }
+
+  s_page_goto (pr_current, s_page_new (pr_current, filename));
+  if (!f_open (pr_current, pr_current->page_current, filename, err)) {
+    s_page_delete (pr_current, pr_current->page_current);
+    g_free (hash);
+    return NULL;
+  }
+
+  spage = g_new0 (SERVER_PAGE, 1);
+  spage->page = pr_current->page_current;
+  spage->stamp = stamp;
+  spage->hash = hash;
+  spage->symbols = g_ptr_array_new ();
+  s_server_record_symbols (spage->page, spage->symbols);
+  g_hash_table_insert (server_pages, g_strdup (filename), spage);
+
+  return spage->page;
+}
+
+/*! \brief Traverse and run the backends of a request.
+ *  \par Function Description
+ *  Runs in the child process forked for the request, and never
+ *  returns.
+ */
+static void
+s_server_netlist (TOPLEVEL *pr_current, const char *argv0, const char *cwd,
+                  GList *pages, GSList *files, GSList *params,
+                  const char *output)
+{
+  int failed;
+
+  /* Standard output may be the protocol channel */
+  dup2 (2, 1);
+
+  s_traverse_set_pages (pages);
+
+  g_slist_free (input_files);
+  input_files = files;
+  backend_params = g_slist_concat (backend_params, params);
+  if (output != NULL) {
+    g_free (output_filename);
+    output_filename = g_strdup (output);
+  }
+
+  g_backend_load_all (argv0);
+  failed = g_backend_run_all (pr_current, cwd);
+
+  scm_flush_all_ports ();
+  fflush (NULL);
+  _exit (failed > 0 ? 1 : 0);
+}
+
+/*! \brief Handle one request.
+ *  \return An error message, or NULL if the request succeeded.
+ */
+static char *
+s_server_request (TOPLEVEL *pr_current, const char *argv0, const char *cwd,
+                  int argc, char **argv)
+{
+  GSList *files = NULL;
+  GSList *params = NULL;
+  GList *pages = NULL;
+  GSList *iter;
+  GHashTable *changed_symbols;
+  const char *output = NULL;
+  char *message = NULL;
+  int n_backends = 0;
+  int only_files = FALSE;
+  pid_t pid;
+  int saved_stdout;
+  int status;
+  int i;
+
+  g_backend_free_all ();
+
+  for (i = 0; i < argc; i++) {
+    if (!only_files && strcmp (argv[i], "--") == 0) {
+      only_files = TRUE;
+    } else if (!only_files && argv[i][0] == '-') {
+      if (i + 1 >= argc) {
+        message = g_strdup_printf ("Option %s requires an argument", argv[i]);
+        break;
+      }
+      if (strcmp (argv[i], "-g") == 0) {
+        g_backend_add (argv[++i]);
+        n_backends++;
+      } else if (strcmp (argv[i], "-o") == 0) {
+        output = argv[++i];
+      } else if (strcmp (argv[i], "-O") == 0) {
+        params = g_slist_append (params, argv[++i]);
+      } else {
+        message = g_strdup_printf ("Unknown option %s", argv[i]);
+        break;
+      }
+    } else {
+      files = g_slist_append (files, argv[i]);
+    }
+  }
+
+  if (message == NULL && n_backends == 0) {
+    message = g_strdup ("No backend given");
+  }
+  if (message == NULL && files == NULL) {
+    message = g_strdup ("No schematic files given");
+  }
+
+  if (message == NULL) {
+    changed_symbols = s_server_changed_symbols ();
+
+    for (iter = files; iter != NULL; iter = g_slist_next (iter)) {
+      GError *err = NULL;
+      char *filename;
+      PAGE *page;
+
+      if (g_path_is_absolute (iter->data)) {
+        filename = g_strdup (iter->data);
+      } else {
+        filename = g_build_filename (cwd, iter->data, NULL);
+      }
+
+      page = s_server_get_page (pr_current, filename, changed_symbols, &err);
+      g_free (filename);
+
+      if (page == NULL) {
+        message = g_strdup_printf ("Failed to load '%s': %s",
+                                   (char *) iter->data,
+                                   err != NULL ? err->message : "");
+        g_clear_error (&err);
+        break;
+      }
+      pages = g_list_append (pages, page);
+    }
+
+    g_hash_table_destroy (changed_symbols);
+
+    if (chdir (cwd) != 0) {
+      fprintf (stderr, "ERROR: Could not change back to directory [%s]\n",
+               cwd);
+    }
+  }
+
+  if (message == NULL) {
+    /* Bring the traversal cache up to date here, so that it survives
+     * the request.  Anything traversal prints goes to stderr, since
+     * standard output may be the protocol channel. */
+    scm_flush_all_ports ();
+    fflush (NULL);
+    saved_stdout = dup (1);
+    dup2 (2, 1);
+
+    s_traverse_set_pages (pages);
+    s_traverse_update_cache (pr_current);
+    s_server_record_subsheets (pr_current);
+
+    scm_flush_all_ports ();
+    fflush (NULL);
+    dup2 (saved_stdout, 1);
+    close (saved_stdout);
+
+    if (chdir (cwd) != 0) {
+      fprintf (stderr, "ERROR: Could not change back to directory [%s]\n",
+               cwd);
+    }
+
+    pid = fork ();
+    if (pid == 0) {
+      s_server_netlist (pr_current, argv0, cwd, pages, files, params, output);
+    }
+
+    if (pid < 0) {
+      message = g_strdup ("Could not fork");
+    } else if (waitpid (pid, &status, 0) < 0
+               || !WIFEXITED (status) || WEXITSTATUS (status) != 0) {
+      message = g_strdup ("Netlisting failed");
+    }
+  }
+
+  g_list_free (pages);
+  g_slist_free (files);
+  g_slist_free (params);
+
+  return message;
+}
+
+/*! \brief Read a line of any length.
+ *  \return The line without its terminator, or NULL at end of file.
+ */
+static char *
+s_server_read_line (FILE *in)
+{
+  GString *line = g_string_new (NULL);
+  int c;
+
+  while ((c = getc (in)) != EOF && c != '\n') {
+    g_string_append_c (line, c);
+  }
+
+  if (c == EOF && line->len == 0) {
+    g_string_free (line, TRUE);
+    return NULL;
+  }
+
+  return g_string_free (line, FALSE);
+}
+
+/*! \brief Answer requests until the end of a session.
+ *  \return TRUE if the server should shut down.
+ */
+static int
+s_server_session (TOPLEVEL *pr_current, const char *argv0, const char *cwd,
+                  FILE *in, FILE *out)
+{
+  char *line;
+
+  while ((line = s_server_read_line (in)) != NULL) {
+    GError *err = NULL;
+    char **argv = NULL;
+    char *message;
+    int argc;
+
+    g_strstrip (line);
+
+    if (line[0] == '\0') {
+      g_free (line);
+      continue;
+    }
+
+    if (strcmp (line, "quit") == 0) {
+      g_free (line);
+      return FALSE;
+    }
+
+    if (strcmp (line, "shutdown") == 0) {
+      g_free (line);
+      fprintf (out, "OK\n");
+      fflush (out);
+      return TRUE;
+    }
+
+    if (g_shell_parse_argv (line, &argc, &argv, &err)) {
+      message = s_server_request (pr_current, argv0, cwd, argc, argv);
+      g_strfreev (argv);
+    } else {
+      message = g_strdup (err->message);
+      g_error_free (err);
+    }
+
+    if (message == NULL) {
+      fprintf (out, "OK\n");
+    } else {
+      fprintf (out, "ERROR %s\n", message);
+      g_free (message);
+    }
+    fflush (out);
+
+    g_free (line);
+  }
+
+  return FALSE;
+}
+
+#ifdef HAVE_SYS_UN_H
+/*! \brief Answer requests from clients of a UNIX domain socket. */
+static int
+s_server_listen (TOPLEVEL *pr_current, const char *argv0, const char *cwd,
+                 const char *path)
+{
+  struct sockaddr_un addr;
+  int fd;
+  int done = FALSE;
+
+  if (strlen (path) >= sizeof (addr.sun_path)) {
+    fprintf (stderr, "ERROR: Socket path [%s] is too long.\n", path);
+    return FALSE;
+  }
+
+  fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror ("socket");
+    return FALSE;
+  }
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, path);
+
+  unlink (path);
+  if (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) != 0
+      || listen (fd, 5) != 0) {
+    perror (path);
+    close (fd);
+    return FALSE;
+  }
+
+  /* A client going away must not kill the server */
+  signal (SIGPIPE, SIG_IGN);
+
+  while (!done) {
+    int client = accept (fd, NULL, NULL);
+    FILE *in, *out;
+
+    if (client < 0) continue;
+
+    in = fdopen (client, "r");
+    out = fdopen (dup (client), "w");
+    if (in != NULL && out != NULL) {
+      done = s_server_session (pr_current, argv0, cwd, in, out);
+    }
+    if (in != NULL) fclose (in);
+    if (out != NULL) fclose (out);
+  }
+
+  close (fd);
+  unlink (path);
+
+  return TRUE;
+}
+#endif
+
+#endif /* HAVE_FORK && HAVE_SYS_WAIT_H */
+
+/*! \brief Run gnetlist as a server.
+ *  \par Function Description
+ *  Answers netlist requests, as described at the top of this file,
+ *  until told to shut down or until standard input is closed.  Must be
+ *  called once the rc files and gnetlist.scm have been loaded.
+ *
+ *  \param [in] pr_current  The current #TOPLEVEL structure.
+ *  \param [in] argv0       Program name, for error messages.
+ *  \param [in] cwd         Directory relative filenames are relative to.
+ *  \param [in] socket_path UNIX socket to listen on, or NULL to read
+ *                          requests from standard input.
+ *  \return FALSE if the server could not be started.
+ */
+int
+s_server_run (TOPLEVEL *pr_current, const char *argv0, const char *cwd,
+              const char *socket_path)
+{
+#if defined(HAVE_FORK) && defined(HAVE_SYS_WAIT_H)
+  int result = TRUE;
+
+  server_pages = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                        (GDestroyNotify) s_server_page_free);
+  symbol_stamps = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                         g_free, g_free);
+  symbol_by_file = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free, NULL);
+  subsheet_pids = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  s_traverse_set_incremental (TRUE);
+
+  if (socket_path == NULL) {
+    s_server_session (pr_current, argv0, cwd, stdin, stdout);
+  } else {
+#ifdef HAVE_SYS_UN_H
+    result = s_server_listen (pr_current, argv0, cwd, socket_path);
+#else
+    fprintf (stderr, "ERROR: UNIX domain sockets are not supported.\n");
+    result = FALSE;
+#endif
+  }
+
+  s_traverse_set_incremental (FALSE);
+
+  g_hash_table_destroy (server_pages);
+  g_hash_table_destroy (symbol_stamps);
+  g_hash_table_destroy (symbol_by_file);
+  g_hash_table_destroy (subsheet_pids);
+  server_pages = symbol_stamps = symbol_by_file = NULL;
+  subsheet_pids = NULL;
+
+  return result;
+#else
+  fprintf (stderr, "ERROR: Server mode is not supported on this platform.\n");
+  return FALSE;
+#endif
+}
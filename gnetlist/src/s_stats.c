@@ -0,0 +1,370 @@
+/* gEDA - GPL Electronic Design Automation
+ * gnetlist - gEDA Netlist
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*! \file s_stats.c
+ * \brief Run statistics (<tt>--stats</tt>).
+ *
+ * Records the wall clock time, CPU time and peak resident set size of
+ * each phase of a gnetlist run, and a set of named counters, and
+ * writes them out as a JSON document at the end of the run:
+ *
+ * <pre>
+ * {
+ *   "phases": [
+ *     { "name": "rc-parse", "detail": null,
+ *       "wall": 0.012, "cpu": 0.011, "peak-rss": 10240 },
+ *     ...
+ *   ],
+ *   "counters": { "objects-loaded": 1234, ... },
+ *   "primitive-calls": { "gnetlist:get-pins": 56, ... }
+ * }
+ * </pre>
+ *
+ * Times are in seconds and the peak resident set size in kilobytes
+ * (null where the platform cannot report it).  Phases appear in the
+ * order they ran, and a phase may appear more than once.
+ *
+ * Everything here does nothing unless statistics were asked for.
+ */
+
+#include <config.h>
+#include <missing.h>
+
+#include <stdio.h>
+#include <time.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#include <libgeda/libgeda.h>
+
+#include "../include/globals.h"
+#include "../include/prototype.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! One finished phase. */
+typedef struct {
+  char *name;
+  char *detail;       /* e.g. the file loaded, or NULL */
+  double wall;        /* seconds */
+  double cpu;         /* seconds */
+  long peak_rss;      /* kilobytes, or -1 if unknown */
+} STATS_PHASE;
+
+/*! Finished phases, in order. */
+static GPtrArray *phases = NULL;
+
+/*! The running phase, or NULL. */
+static STATS_PHASE *current_phase = NULL;
+static GTimeVal current_start;
+static double current_cpu_start;
+
+/*! Counters, by name. */
+static GHashTable *counters = NULL;
+
+/*! Calls of each gnetlist:* primitive, by name. */
+static GHashTable *primitive_calls = NULL;
+
+/*! \brief Get the CPU time used by the process so far, in seconds. */
+static double
+s_stats_cpu_time (void)
+{
+#if defined(HAVE_SYS_RESOURCE_H) && defined(HAVE_GETRUSAGE)
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+      + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+  }
+#endif
+  return (double) clock () / CLOCKS_PER_SEC;
+}
+
+/*! \brief Get the peak resident set size so far, in kilobytes.
+ *  \return The size, or -1 if it cannot be determined.
+ */
+static long
+s_stats_peak_rss (void)
+{
+#if defined(HAVE_SYS_RESOURCE_H) && defined(HAVE_GETRUSAGE)
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;    /* bytes on Mac OS X */
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+
+/*! \brief Start a phase.
+ *  \par Function Description
+ *  Ends the running phase, if any, and starts timing a new one.
+ *
+ *  \param [in] name    Name of the phase.
+ *  \param [in] detail  What the phase works on (e.g. a filename), or
+ *                      NULL.
+ */
+void
+s_stats_phase_begin (const char *name, const char *detail)
+{
+  if (!stats_mode) return;
+
+  s_stats_phase_end ();
+
+  current_phase = g_new0 (STATS_PHASE, 1);
+  current_phase->name = g_strdup (name);
+  current_phase->detail = g_strdup (detail);
+  g_get_current_time (&current_start);
+  current_cpu_start = s_stats_cpu_time ();
+}
+
+/*! \brief End the running phase, if any. */
+void
+s_stats_phase_end (void)
+{
+  GTimeVal now;
+
+  if (!stats_mode || current_phase == NULL) return;
+
+  g_get_current_time (&now);
+  current_phase->wall = (now.tv_sec - current_start.tv_sec)
+    + (now.tv_usec - current_start.tv_usec) / 1e6;
+  current_phase->cpu = s_stats_cpu_time () - current_cpu_start;
+  current_phase->peak_rss = s_stats_peak_rss ();
+
+  if (phases == NULL) {
+    phases = g_ptr_array_new ();
+  }
+  g_ptr_array_add (phases, current_phase);
+  current_phase = NULL;
+}
+
+static void
+s_stats_add_to (GHashTable **table, const char *name, guint n)
+{
+  gpointer value;
+
+  if (*table == NULL) {
+    *table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  }
+
+  value = g_hash_table_lookup (*table, name);
+  if (value == NULL) {
+    g_hash_table_insert (*table, g_strdup (name), GUINT_TO_POINTER (n));
+  } else {
+    g_hash_table_replace (*table, g_strdup (name),
+                          GUINT_TO_POINTER (GPOINTER_TO_UINT (value) + n));
+  }
+}
+
+/*! \brief Add to a counter.
+ *  \param [in] name  Name of the counter.
+ *  \param [in] n     Amount to add.
+ */
+void
+s_stats_add (const char *name, guint n)
+{
+  if (!stats_mode) return;
+
+  s_stats_add_to (&counters, name, n);
+}
+
+/*! \brief Count a call of a gnetlist primitive.
+ *  \par Function Description
+ *  Called from the wrappers that g_register_funcs() puts around each
+ *  \c gnetlist: procedure when statistics were asked for.
+ *
+ *  \param [in] scm_name  Name of the procedure, as a string.
+ *  \return Unspecified.
+ */
+SCM
+g_stats_count_call (SCM scm_name)
+{
+  char *name;
+
+  SCM_ASSERT (scm_is_string (scm_name), scm_name, SCM_ARG1,
+              "%gnetlist-count-call");
+
+  name = scm_to_utf8_string (scm_name);
+  s_stats_add_to (&primitive_calls, name, 1);
+  free (name);
+
+  return SCM_UNSPECIFIED;
+}
+
+/*! \brief Count objects, including the objects inside symbols. */
+static guint
+s_stats_count_objects (const GList *objects)
+{
+  const GList *iter;
+  guint n = 0;
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *o_current = iter->data;
+
+    n++;
+    if ((o_current->type == OBJ_COMPLEX || o_current->type == OBJ_PLACEHOLDER)
+        && o_current->complex != NULL) {
+      n += s_stats_count_objects (o_current->complex->prim_objs);
+    }
+  }
+
+  return n;
+}
+
+static void
+s_stats_write_string (FILE *fp, const char *str)
+{
+  const char *p;
+
+  if (str == NULL) {
+    fputs ("null", fp);
+    return;
+  }
+
+  fputc ('"', fp);
+  for (p = str; *p != '\0'; p++) {
+    unsigned char c = *p;
+
+    switch (c) {
+      case '"':  fputs ("\\\"", fp); break;
+      case '\\': fputs ("\\\\", fp); break;
+      case '\n': fputs ("\\n", fp); break;
+      case '\t': fputs ("\\t", fp); break;
+      default:
+        if (c < 0x20) {
+          fprintf (fp, "\\u%04x", c);
+        } else {
+          fputc (c, fp);
+        }
+    }
+  }
+  fputc ('"', fp);
+}
+
+static void
+s_stats_write_table (FILE *fp, GHashTable *table)
+{
+  GList *names;
+  GList *iter;
+
+  fputs ("{", fp);
+  if (table != NULL) {
+    names = g_list_sort (g_hash_table_get_keys (table), (GCompareFunc) strcmp);
+    for (iter = names; iter != NULL; iter = g_list_next (iter)) {
+      fputs ((iter == names) ? "\n    " : ",\n    ", fp);
+      s_stats_write_string (fp, iter->data);
+      fprintf (fp, ": %u",
+               GPOINTER_TO_UINT (g_hash_table_lookup (table, iter->data)));
+    }
+    g_list_free (names);
+    if (names != NULL) fputs ("\n  ", fp);
+  }
+  fputs ("}", fp);
+}
+
+/*! \brief Write the statistics of the run.
+ *  \par Function Description
+ *  Ends the running phase, works out the counters that are taken from
+ *  the loaded pages and the component library, and writes everything
+ *  as JSON to #stats_filename, or to standard error if that is NULL.
+ *
+ *  \param [in] pr_current  The current #TOPLEVEL structure.
+ */
+void
+s_stats_report (TOPLEVEL *pr_current)
+{
+  const GList *iter;
+  guint n_objects = 0;
+  guint hits, misses;
+  FILE *fp;
+  guint i;
+
+  if (!stats_mode) return;
+
+  s_stats_phase_end ();
+
+  /* Sub-sheets loaded during traversal are pages too */
+  for (iter = geda_list_get_glist (pr_current->pages);
+       iter != NULL; iter = g_list_next (iter)) {
+    n_objects += s_stats_count_objects (s_page_objects (iter->data));
+  }
+  s_stats_add ("objects-loaded", n_objects);
+
+  /* Every symbol fetched from the library is parsed, whether or not
+   * its data came from the cache */
+  s_clib_get_cache_stats (&hits, &misses);
+  s_stats_add ("symbols-parsed", hits + misses);
+  s_stats_add ("symbol-cache-hits", hits);
+
+  if (stats_filename != NULL) {
+    fp = fopen (stats_filename, "w");
+    if (fp == NULL) {
+      fprintf (stderr, "ERROR: Could not open [%s] for writing statistics\n",
+               stats_filename);
+      return;
+    }
+  } else {
+    fp = stderr;
+  }
+
+  fputs ("{\n  \"phases\": [", fp);
+  for (i = 0; phases != NULL && i < phases->len; i++) {
+    STATS_PHASE *phase = g_ptr_array_index (phases, i);
+
+    fputs ((i == 0) ? "\n    { \"name\": " : ",\n    { \"name\": ", fp);
+    s_stats_write_string (fp, phase->name);
+    fputs (", \"detail\": ", fp);
+    s_stats_write_string (fp, phase->detail);
+    fprintf (fp, ", \"wall\": %.6f, \"cpu\": %.6f, \"peak-rss\": ",
+             phase->wall, phase->cpu);
+    if (phase->peak_rss >= 0) {
+      fprintf (fp, "%ld }", phase->peak_rss);
+    } else {
+      fputs ("null }", fp);
+    }
+  }
+  if (phases != NULL && phases->len > 0) fputs ("\n  ", fp);
+  fputs ("],\n  \"counters\": ", fp);
+  s_stats_write_table (fp, counters);
+  fputs (",\n  \"primitive-calls\": ", fp);
+  s_stats_write_table (fp, primitive_calls);
+  fputs ("\n}\n", fp);
+
+  if (fp != stderr) {
+    fclose (fp);
+  } else {
+    fflush (fp);
+  }
+}
@@ -28,6 +28,7 @@
 #include <math.h>
 
 #include <libgeda/libgeda.h>
+#include <libgeda/libgedaguile.h>
 
 #include "../include/globals.h"
 #include "../include/prototype.h"
@@ -36,14 +37,80 @@
 #include <dmalloc.h>
 #endif
 
-/*! Tracks which OBJECTs have been visited so far, and how many times.
+/*! Where a traversal puts its results.
  *
- * The keys of the table are the OBJECT pointers, and the visit count
- * is stored directly in the value pointers.
+ * The serial traversal works directly on #netlist_head and
+ * #graphical_netlist_head.  When sheets are traversed on worker threads
+ * each sheet is traversed into its own lists, which are appended to the
+ * global ones in page order once all workers have finished.
  */
-static GHashTable *visit_table = NULL;
+typedef struct {
+  NETLIST *netlist_head;
+  NETLIST *graphical_netlist_head;
+
+  /*! Tracks which OBJECTs have been visited so far, and how many times.
+   *
+   * The keys of the table are the OBJECT pointers, and the visit count
+   * is stored directly in the value pointers.
+   */
+  GHashTable *visit_table;
+  guint n_visits;           /* for --stats */
+
+  /*! What the sheet being traversed depends on, as #TRAVERSE_DEPEND
+   *  records, or NULL if dependencies are not being tracked. */
+  GPtrArray *depends;
+} TRAVERSE_STATE;
+
+#define DEPEND_FILE    0
+#define DEPEND_SYMBOL  1
+
+/*! A file or library symbol the traversal of a sheet depends on. */
+typedef struct {
+  int kind;           /* DEPEND_FILE or DEPEND_SYMBOL */
+  char *name;         /* filename or symbol basename */
+  PAGE *page;         /* sub-sheet page the netlist refers to, or NULL */
+  char *hash;         /* content hash, once the fragment is cached */
+} TRAVERSE_DEPEND;
+
+/*! The traversal result of a toplevel page, kept for incremental
+ *  traversal. */
+typedef struct {
+  SCM *get_uref;        /* get-uref procedure it was traversed with */
+  GPtrArray *depends;   /* #TRAVERSE_DEPEND records, with hashes */
+  NETLIST *netlist;     /* components, before post processing */
+  NETLIST *graphical;   /* graphical components, likewise */
+} PAGE_FRAGMENT;
+
+/*! Toplevel pages to traverse, or NULL to traverse all of them. */
+static GList *traverse_pages = NULL;
+
+/*! State of the serial traversal. */
+static TRAVERSE_STATE serial_state = { NULL, NULL, NULL, 0, NULL };
+
+/*! Whether traversal results are kept and reused. */
+static int incremental = FALSE;
+
+/*! Maps page ids to the #PAGE_FRAGMENT of the page. */
+static GHashTable *fragment_cache = NULL;
+
+#ifdef HAVE_GTHREAD
+/*! State of the traversal running on the current worker thread. */
+static GStaticPrivate worker_state = G_STATIC_PRIVATE_INIT;
+#endif
+
+/*! Return the state of the traversal running on the current thread. */
+static inline TRAVERSE_STATE *
+current_state (void)
+{
+#ifdef HAVE_GTHREAD
+  TRAVERSE_STATE *state = g_static_private_get (&worker_state);
 
-/*! Trivial function used when clearing #visit_table. */
+  if (state != NULL) return state;
+#endif
+  return &serial_state;
+}
+
+/*! Trivial function used when clearing the visit table. */
 static gboolean
 returns_true (gpointer key, gpointer value, gpointer user_data)
 {
@@ -56,7 +123,7 @@ is_visited(OBJECT *obj)
 {
   gpointer val;
   gpointer orig_key;
-  gboolean exist = g_hash_table_lookup_extended (visit_table,
+  gboolean exist = g_hash_table_lookup_extended (current_state ()->visit_table,
                                                  obj,
                                                  &orig_key,
                                                  &val);
@@ -67,20 +134,42 @@ is_visited(OBJECT *obj)
 static inline gint
 visit(OBJECT *obj)
 {
+  TRAVERSE_STATE *state = current_state ();
   gpointer val = GINT_TO_POINTER(is_visited (obj) + 1);
-  g_hash_table_replace (visit_table, obj, val);
+  g_hash_table_replace (state->visit_table, obj, val);
+  state->n_visits++;
   return GPOINTER_TO_INT (val);
 }
 
 /*! Reset all visit counts. Simply clears the hashtable completely. */
 static inline void
-s_traverse_clear_all_visited (const GList *obj_list)
+s_traverse_clear_all_visited (void)
 {
-  g_hash_table_foreach_remove (visit_table,
+  g_hash_table_foreach_remove (current_state ()->visit_table,
                                (GHRFunc) returns_true,
                                NULL);
 }
 
+/*! \brief Get the netlist the current traversal appends to.
+ *  \par Function Description
+ *  This is #netlist_head, except while a sheet is being traversed on a
+ *  worker thread.
+ */
+NETLIST *s_traverse_netlist_head (void)
+{
+  return current_state ()->netlist_head;
+}
+
+/*! \brief Get the graphical netlist the current traversal appends to.
+ *  \par Function Description
+ *  This is #graphical_netlist_head, except while a sheet is being
+ *  traversed on a worker thread.
+ */
+NETLIST *s_traverse_graphical_netlist_head (void)
+{
+  return current_state ()->graphical_netlist_head;
+}
+
 void s_traverse_init(void)
 {
     netlist_head = s_netlist_add(NULL);
@@ -111,35 +200,734 @@ void s_traverse_init(void)
 
     /* Initialise the hashtable which contains the visit
        count. N.b. no free functions are required. */
-    visit_table = g_hash_table_new (g_direct_hash,
-                                    g_direct_equal);
+    serial_state.netlist_head = netlist_head;
+    serial_state.graphical_netlist_head = graphical_netlist_head;
+    serial_state.visit_table = g_hash_table_new (g_direct_hash,
+                                                 g_direct_equal);
+}
+
+#ifdef HAVE_GTHREAD
+/*! Work shared by the traversal worker threads. */
+typedef struct {
+  TOPLEVEL *pr_current;
+  SCM module;               /* module to look up get-uref in */
+  GPtrArray *pages;         /* toplevel pages, in page order */
+  TRAVERSE_STATE *states;   /* one per page */
+  guint next_page;          /* next page to hand out */
+  GMutex *lock;             /* protects next_page */
+} TRAVERSE_JOBS;
+
+static void *
+s_traverse_worker_body (void *data)
+{
+  TRAVERSE_JOBS *jobs = data;
+  guint i;
+
+  scm_dynwind_begin (0);
+  edascm_dynwind_toplevel (jobs->pr_current);
+  scm_set_current_module (jobs->module);
+
+  for (;;) {
+    g_mutex_lock (jobs->lock);
+    i = jobs->next_page++;
+    g_mutex_unlock (jobs->lock);
+
+    if (i >= jobs->pages->len) break;
+
+    g_static_private_set (&worker_state, &jobs->states[i], NULL);
+    s_traverse_sheet (jobs->pr_current,
+                      s_page_objects (g_ptr_array_index (jobs->pages, i)),
+                      NULL);
+  }
+
+  g_static_private_set (&worker_state, NULL, NULL);
+  scm_dynwind_end ();
+
+  return NULL;
+}
+
+static gpointer
+s_traverse_worker (gpointer data)
+{
+  return scm_with_guile (s_traverse_worker_body, data);
+}
+
+/*! Wait for the workers.  Called outside Guile mode so that the
+ *  workers are not held up by the garbage collector waiting for us. */
+static void *
+s_traverse_join_workers (void *data)
+{
+  GPtrArray *threads = data;
+  guint i;
+
+  for (i = 0; i < threads->len; i++) {
+    g_thread_join (g_ptr_array_index (threads, i));
+  }
+
+  return NULL;
+}
+
+/*! Move the nodes of \a fragment (without its head) to the end of
+ *  \a head, and free the head node of \a fragment. */
+static void
+s_traverse_append_fragment (NETLIST *head, NETLIST *fragment)
+{
+  NETLIST *tail = s_netlist_return_tail (head);
+
+  if (fragment->next != NULL) {
+    tail->next = fragment->next;
+    fragment->next->prev = tail;
+  }
+
+  g_free (fragment);
+}
+#endif
+
+/*! \brief Traverse toplevel pages on worker threads.
+ *  \par Function Description
+ *  When more than one job was requested, traverses each page in
+ *  \a pages into a netlist of its own on a pool of worker threads, and
+ *  then appends the results to #netlist_head and
+ *  #graphical_netlist_head in page order, so that the result is the
+ *  same as that of a serial traversal.
+ *
+ *  Loading of sub-sheets is serialised by s_hierarchy_traverse(), and
+ *  libgeda serialises the weak references of the object smobs that
+ *  get-uref is called with.
+ *
+ *  \param [in] pr_current  The current #TOPLEVEL structure.
+ *  \param [in] pages       The toplevel pages, in page order.
+ *  \return FALSE if the pages were not traversed and the caller should
+ *          fall back to a serial traversal.
+ */
+static int
+s_traverse_pages_parallel (TOPLEVEL *pr_current, GPtrArray *pages)
+{
+#ifdef HAVE_GTHREAD
+  TRAVERSE_JOBS jobs;
+  GPtrArray *threads;
+  guint n_threads;
+  guint i;
+
+  /* The verbose progress output only makes sense in page order */
+  if (traverse_jobs <= 1 || verbose_mode || pages->len < 2 ||
+      !g_thread_supported ()) {
+    return FALSE;
+  }
+
+  jobs.pr_current = pr_current;
+  jobs.module = scm_current_module ();
+  jobs.pages = pages;
+  jobs.states = g_new0 (TRAVERSE_STATE, pages->len);
+  jobs.next_page = 0;
+  jobs.lock = g_mutex_new ();
+
+  for (i = 0; i < pages->len; i++) {
+    jobs.states[i].netlist_head = s_netlist_add (NULL);
+    jobs.states[i].netlist_head->nlid = -1;
+    jobs.states[i].graphical_netlist_head = s_netlist_add (NULL);
+    jobs.states[i].graphical_netlist_head->nlid = -1;
+    jobs.states[i].visit_table = g_hash_table_new (g_direct_hash,
+                                                   g_direct_equal);
+  }
+
+  n_threads = MIN ((guint) traverse_jobs, pages->len);
+  threads = g_ptr_array_new ();
+  for (i = 0; i < n_threads; i++) {
+    GThread *thread = g_thread_create (s_traverse_worker, &jobs, TRUE, NULL);
+    if (thread == NULL) break;
+    g_ptr_array_add (threads, thread);
+  }
+
+  /* If not a single worker could be started, nothing has been
+   * traversed yet and the caller can still do it serially */
+  if (threads->len == 0) {
+    for (i = 0; i < pages->len; i++) {
+      g_free (jobs.states[i].netlist_head);
+      g_free (jobs.states[i].graphical_netlist_head);
+      g_hash_table_destroy (jobs.states[i].visit_table);
+    }
+    g_ptr_array_free (threads, TRUE);
+    g_mutex_free (jobs.lock);
+    g_free (jobs.states);
+    return FALSE;
+  }
+
+  scm_without_guile (s_traverse_join_workers, threads);
+
+  for (i = 0; i < pages->len; i++) {
+    serial_state.n_visits += jobs.states[i].n_visits;
+    s_traverse_append_fragment (netlist_head, jobs.states[i].netlist_head);
+    s_traverse_append_fragment (graphical_netlist_head,
+                                jobs.states[i].graphical_netlist_head);
+    g_hash_table_destroy (jobs.states[i].visit_table);
+  }
+
+  g_ptr_array_free (threads, TRUE);
+  g_mutex_free (jobs.lock);
+  g_free (jobs.states);
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+static TRAVERSE_DEPEND *
+s_traverse_depend_new (int kind, const char *name, PAGE *page)
+{
+  TRAVERSE_DEPEND *depend = g_new0 (TRAVERSE_DEPEND, 1);
+
+  depend->kind = kind;
+  depend->name = g_strdup (name);
+  depend->page = page;
+  return depend;
+}
+
+static void
+s_traverse_depend_destroy (TRAVERSE_DEPEND *depend)
+{
+  g_free (depend->name);
+  g_free (depend->hash);
+  g_free (depend);
+}
+
+/*! \brief Note a library symbol the current sheet depends on. */
+static void
+s_traverse_depend_symbol (const char *basename)
+{
+  GPtrArray *depends = current_state ()->depends;
+
+  if (depends != NULL && basename != NULL) {
+    g_ptr_array_add (depends,
+                     s_traverse_depend_new (DEPEND_SYMBOL, basename, NULL));
+  }
+}
+
+/*! \brief Note a sub-sheet the current sheet depends on.
+ *  \par Function Description
+ *  Called by the hierarchy code for each sub-sheet it traverses, so
+ *  that incremental traversal can tell when a sheet has to be
+ *  traversed again because one of its sub-sheets changed.  Does
+ *  nothing unless dependencies are being tracked.
+ *
+ *  \param [in] filename  Filename of the sub-sheet.
+ *  \param [in] page      The page it was loaded into.
+ */
+void s_traverse_depend_page(const char *filename, PAGE *page)
+{
+  GPtrArray *depends = current_state ()->depends;
+
+  if (depends != NULL) {
+    g_ptr_array_add (depends,
+                     s_traverse_depend_new (DEPEND_FILE, filename, page));
+  }
+}
+
+/*! \brief Mark the dependencies noted so far.
+ *  \return A mark to pass to s_traverse_depend_slice().
+ */
+guint s_traverse_depend_mark(void)
+{
+  GPtrArray *depends = current_state ()->depends;
+
+  return (depends != NULL) ? depends->len : 0;
+}
+
+/*! \brief Copy the dependencies noted since a mark.
+ *  \par Function Description
+ *  Lets the hierarchy code remember what a sub-sheet template depends
+ *  on, to replay it with s_traverse_depend_replay() for every instance.
+ *
+ *  \param [in] mark  Value returned by s_traverse_depend_mark().
+ *  \return A list to free with s_traverse_depend_free(), or NULL if
+ *          dependencies are not being tracked.
+ */
+GPtrArray *s_traverse_depend_slice(guint mark)
+{
+  GPtrArray *depends = current_state ()->depends;
+  GPtrArray *slice;
+  guint i;
+
+  if (depends == NULL) return NULL;
+
+  slice = g_ptr_array_new ();
+  for (i = mark; i < depends->len; i++) {
+    TRAVERSE_DEPEND *depend = g_ptr_array_index (depends, i);
+    g_ptr_array_add (slice, s_traverse_depend_new (depend->kind, depend->name,
+                                                   depend->page));
+  }
+
+  return slice;
+}
+
+/*! \brief Note again the dependencies returned by s_traverse_depend_slice(). */
+void s_traverse_depend_replay(GPtrArray *slice)
+{
+  GPtrArray *depends = current_state ()->depends;
+  guint i;
+
+  if (depends == NULL || slice == NULL) return;
+
+  for (i = 0; i < slice->len; i++) {
+    TRAVERSE_DEPEND *depend = g_ptr_array_index (slice, i);
+    g_ptr_array_add (depends, s_traverse_depend_new (depend->kind, depend->name,
+                                                     depend->page));
+  }
+}
+
+/*! \brief Free a list returned by s_traverse_depend_slice(). */
+void s_traverse_depend_free(GPtrArray *depends)
+{
+  if (depends == NULL) return;
+
+  g_ptr_array_foreach (depends, (GFunc) s_traverse_depend_destroy, NULL);
+  g_ptr_array_free (depends, TRUE);
+}
+
+static char *
+s_traverse_hash_file (const char *filename)
+{
+  gchar *contents;
+  gsize length;
+  char *hash;
+
+  if (!g_file_get_contents (filename, &contents, &length, NULL)) {
+    return g_strdup ("");
+  }
+
+  hash = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+                                      (const guchar *) contents, length);
+  g_free (contents);
+  return hash;
+}
+
+/*! \brief Compute the content hash of a dependency.
+ *  \par Function Description
+ *  Files are hashed by their contents.  Library symbols are hashed by
+ *  the contents of the file they come from, or by their data if they
+ *  do not come from a file.  Results are remembered in \a memo, so
+ *  that a file shared by many sheets is only read once.
+ *
+ *  \return A newly allocated hash string, empty if the dependency
+ *          cannot be found.
+ */
+static char *
+s_traverse_depend_hash (TRAVERSE_DEPEND *depend, GHashTable *memo)
+{
+  const CLibSymbol *symbol;
+  GList *symbols;
+  char *key;
+  char *hash;
+  char *filename;
+  char *data;
+
+  key = g_strdup_printf ("%d:%s", depend->kind, depend->name);
+  hash = g_hash_table_lookup (memo, key);
+  if (hash != NULL) {
+    g_free (key);
+    return g_strdup (hash);
+  }
+
+  if (depend->kind == DEPEND_FILE) {
+    hash = s_traverse_hash_file (depend->name);
+  } else {
+    symbols = s_clib_search (depend->name, CLIB_EXACT);
+    symbol = (symbols != NULL) ? symbols->data : NULL;
+    g_list_free (symbols);
+
+    filename = (symbol != NULL) ? s_clib_symbol_get_filename (symbol) : NULL;
+    if (filename != NULL) {
+      hash = s_traverse_hash_file (filename);
+      g_free (filename);
+    } else if (symbol != NULL
+               && (data = s_clib_symbol_get_data (symbol)) != NULL) {
+      hash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, data, -1);
+      g_free (data);
+    } else {
+      hash = g_strdup ("");
+    }
+  }
+
+  g_hash_table_insert (memo, key, g_strdup (hash));
+  return hash;
+}
+
+static void
+s_traverse_fragment_free (PAGE_FRAGMENT *fragment)
+{
+  scm_gc_unprotect_object (*fragment->get_uref);
+  g_free (fragment->get_uref);
+  s_traverse_depend_free (fragment->depends);
+  s_netlist_free (fragment->netlist);
+  s_netlist_free (fragment->graphical);
+  g_free (fragment);
+}
+
+static SCM
+s_traverse_get_uref_proc (void)
+{
+  return scm_variable_ref (scm_c_lookup ("get-uref"));
+}
+
+/*! \brief Drop the cached data of a library symbol.
+ *  \par Function Description
+ *  Makes sure that the next sheet loaded which uses the symbol reads
+ *  it again, rather than using the data read before it changed.
+ */
+static void
+s_traverse_symbol_invalidate (const char *basename)
+{
+  GList *symbols = s_clib_search (basename, CLIB_EXACT);
+
+  if (symbols != NULL) {
+    s_clib_symbol_invalidate_data (symbols->data);
+  }
+  g_list_free (symbols);
+}
+
+/*! \brief Look up the cached traversal result of a page.
+ *  \par Function Description
+ *  Every dependency of the fragment is checked, from the toplevel
+ *  page down through all of its sub-sheets and the symbols they use.
+ *  The cached data of each changed symbol is dropped on the way, so
+ *  that traversing the page again loads its sub-sheets with the new
+ *  symbols.
+ *
+ *  \return The fragment, or NULL if there is none or the page, one of
+ *          its sub-sheets or one of the symbols they use has changed.
+ */
+static PAGE_FRAGMENT *
+s_traverse_cache_lookup (PAGE *page, GHashTable *memo)
+{
+  PAGE_FRAGMENT *fragment;
+  int changed = FALSE;
+  guint i;
+
+  fragment = g_hash_table_lookup (fragment_cache, GINT_TO_POINTER (page->pid));
+  if (fragment == NULL) return NULL;
+
+  if (!scm_is_eq (*fragment->get_uref, s_traverse_get_uref_proc ())) {
+    return NULL;
+  }
+
+  for (i = 0; i < fragment->depends->len; i++) {
+    TRAVERSE_DEPEND *depend = g_ptr_array_index (fragment->depends, i);
+    char *hash = s_traverse_depend_hash (depend, memo);
+
+    if (strcmp (hash, depend->hash) != 0) {
+      changed = TRUE;
+      if (depend->kind == DEPEND_SYMBOL) {
+        s_traverse_symbol_invalidate (depend->name);
+      }
+    }
+    g_free (hash);
+  }
+
+  return changed ? NULL : fragment;
+}
+
+/*! \brief Traverse a toplevel page, keeping a copy of the result.
+ *  \par Function Description
+ *  Traverses \a page onto the end of #netlist_head and
+ *  #graphical_netlist_head while noting everything the result depends
+ *  on, and stores a copy of the result in the fragment cache.
+ */
+static void
+s_traverse_page_cached (TOPLEVEL *pr_current, PAGE *page, GHashTable *memo)
+{
+  PAGE_FRAGMENT *fragment;
+  NETLIST *tail;
+  NETLIST *graphical_tail;
+  GHashTable *seen;
+  GPtrArray *depends;
+  guint i;
+
+  tail = s_netlist_return_tail (netlist_head);
+  graphical_tail = s_netlist_return_tail (graphical_netlist_head);
+
+  serial_state.depends = g_ptr_array_new ();
+  s_traverse_depend_page (page->page_filename, NULL);
+
+  pr_current->page_current = page;
+  s_traverse_sheet (pr_current, s_page_objects (page), NULL);
+
+  /* Hash every dependency once */
+  depends = g_ptr_array_new ();
+  seen = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  for (i = 0; i < serial_state.depends->len; i++) {
+    TRAVERSE_DEPEND *depend = g_ptr_array_index (serial_state.depends, i);
+    char *key = g_strdup_printf ("%d:%s:%p", depend->kind, depend->name,
+                                 (void *) depend->page);
+
+    if (g_hash_table_lookup (seen, key) != NULL) {
+      g_free (key);
+      s_traverse_depend_destroy (depend);
+      continue;
+    }
+    g_hash_table_insert (seen, key, key);
+
+    depend->hash = s_traverse_depend_hash (depend, memo);
+    g_ptr_array_add (depends, depend);
+  }
+  g_hash_table_destroy (seen);
+  g_ptr_array_free (serial_state.depends, TRUE);
+  serial_state.depends = NULL;
+
+  fragment = g_new0 (PAGE_FRAGMENT, 1);
+  fragment->get_uref = g_new (SCM, 1);
+  *fragment->get_uref = scm_gc_protect_object (s_traverse_get_uref_proc ());
+  fragment->depends = depends;
+
+  /* Copy the sheet's nodes out of the netlist before post processing
+   * makes them share strings */
+  fragment->netlist = s_netlist_add (NULL);
+  s_netlist_copy (fragment->netlist, tail->next);
+  fragment->graphical = s_netlist_add (NULL);
+  s_netlist_copy (fragment->graphical, graphical_tail->next);
+
+  g_hash_table_replace (fragment_cache, GINT_TO_POINTER (page->pid), fragment);
+}
+
+/*! \brief Traverse toplevel pages, reusing cached results.
+ *  \par Function Description
+ *  Appends the cached result of every page in \a pages that is
+ *  unchanged since it was last traversed, and traverses the others.
+ *  A page is unchanged if it has not been reloaded, it is traversed
+ *  with the same get-uref procedure, and neither its file nor the
+ *  files of its sub-sheets and of the symbols they use have
+ *  different contents.
+ *
+ *  The cached results are copies taken before post processing, so the
+ *  netlist is the same as that of a full traversal.
+ */
+static void
+s_traverse_pages_incremental (TOPLEVEL *pr_current, GPtrArray *pages)
+{
+  GHashTable *memo;
+  guint i;
+
+  if (fragment_cache == NULL) {
+    fragment_cache = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                            (GDestroyNotify) s_traverse_fragment_free);
+  }
+
+  memo = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  for (i = 0; i < pages->len; i++) {
+    PAGE *page = g_ptr_array_index (pages, i);
+    PAGE_FRAGMENT *fragment = s_traverse_cache_lookup (page, memo);
+
+    if (fragment != NULL) {
+      s_netlist_copy (s_netlist_return_tail (netlist_head),
+                      fragment->netlist->next);
+      s_netlist_copy (s_netlist_return_tail (graphical_netlist_head),
+                      fragment->graphical->next);
+    } else {
+      s_traverse_page_cached (pr_current, page, memo);
+    }
+  }
+
+  g_hash_table_destroy (memo);
+}
+
+/*! \brief Keep traversal results for incremental traversal.
+ *  \par Function Description
+ *  When enabled, s_traverse_start() keeps the traversal result of each
+ *  toplevel page, and later traversals reuse the results of the pages
+ *  which have not changed; see s_traverse_pages_incremental().  Pages
+ *  are then traversed serially.
+ *
+ *  \param [in] enable  TRUE to enable incremental traversal.
+ */
+void s_traverse_set_incremental(int enable)
+{
+  incremental = enable;
+  if (!enable) {
+    s_traverse_cache_destroy ();
+  }
+}
+
+/*! \brief Traverse changed pages ahead of time.
+ *  \par Function Description
+ *  Brings the cached traversal results of the toplevel pages up to
+ *  date without building a netlist, then forgets the results of pages
+ *  which are no longer loaded and deletes the sub-sheet pages that no
+ *  remaining result refers to.  A program can call this before forking
+ *  so that traversals in its child processes find every page in the
+ *  cache.
+ *
+ *  \param [in] pr_current  The current #TOPLEVEL structure.
+ */
+void s_traverse_update_cache(TOPLEVEL *pr_current)
+{
+  GHashTable *used;
+  GHashTableIter iter;
+  gpointer key, value;
+  GList *page_iter;
+  GList *unused = NULL;
+  GPtrArray *pages;
+  guint i;
+
+  s_traverse_init ();
+
+  pages = g_ptr_array_new ();
+  for (page_iter = (traverse_pages != NULL) ? traverse_pages
+                   : geda_list_get_glist (pr_current->pages);
+       page_iter != NULL; page_iter = g_list_next (page_iter)) {
+    PAGE *page = page_iter->data;
+
+    if (page->page_control == 0) {
+      g_ptr_array_add (pages, page);
+    }
+  }
+  s_traverse_pages_incremental (pr_current, pages);
+  g_ptr_array_free (pages, TRUE);
+
+  s_traverse_reset ();
+
+  /* Forget pages which have been deleted */
+  used = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_hash_table_iter_init (&iter, fragment_cache);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    PAGE_FRAGMENT *fragment = value;
+
+    if (s_page_search_by_page_id (pr_current->pages,
+                                  GPOINTER_TO_INT (key)) == NULL) {
+      g_hash_table_iter_remove (&iter);
+      continue;
+    }
+
+    for (i = 0; i < fragment->depends->len; i++) {
+      TRAVERSE_DEPEND *depend = g_ptr_array_index (fragment->depends, i);
+      if (depend->page != NULL) {
+        g_hash_table_insert (used, depend->page, depend->page);
+      }
+    }
+  }
+
+  /* Delete sub-sheets nothing refers to any more */
+  for (page_iter = geda_list_get_glist (pr_current->pages);
+       page_iter != NULL; page_iter = g_list_next (page_iter)) {
+    PAGE *page = page_iter->data;
+
+    if (page->page_control != 0 && g_hash_table_lookup (used, page) == NULL) {
+      unused = g_list_prepend (unused, page);
+    }
+  }
+  for (page_iter = unused; page_iter != NULL; page_iter = g_list_next (page_iter)) {
+    s_page_delete (pr_current, page_iter->data);
+  }
+  g_list_free (unused);
+  g_hash_table_destroy (used);
+}
+
+/*! \brief Discard all cached traversal results. */
+void s_traverse_cache_destroy(void)
+{
+  if (fragment_cache != NULL) {
+    g_hash_table_destroy (fragment_cache);
+    fragment_cache = NULL;
+  }
+}
+
+/*! \brief Choose the toplevel pages to traverse.
+ *  \par Function Description
+ *  By default s_traverse_start() traverses every toplevel page that
+ *  is loaded.  A program which keeps more pages loaded than it wants
+ *  to netlist can restrict it to \a pages, in the given order.
+ *
+ *  \param [in] pages  A list of PAGE pointers, or NULL for all pages.
+ *                     The list is copied.
+ */
+void s_traverse_set_pages(GList *pages)
+{
+  g_list_free (traverse_pages);
+  traverse_pages = g_list_copy (pages);
+}
+
+/*! \brief Forget the results of a previous traversal.
+ *  \par Function Description
+ *  Discards the state that a traversal leaves behind, so that the
+ *  design can be traversed again with s_traverse_init() and
+ *  s_traverse_start(), e.g. with a different netlist mode.
+ */
+void s_traverse_reset(void)
+{
+  s_netlist_free (netlist_head);
+  s_netlist_free (graphical_netlist_head);
+  netlist_head = graphical_netlist_head = NULL;
+
+  if (serial_state.visit_table != NULL) {
+    g_hash_table_destroy (serial_state.visit_table);
+    serial_state.visit_table = NULL;
+  }
+
+  s_rename_destroy_all();
+  s_net_reset_unnamed();
+  s_hierarchy_cache_destroy();
+  s_netindex_destroy();
+  s_package_destroy();
+  s_drc2_destroy();
+  s_intern_destroy();
+  g_snapshot_destroy();
 }
 
 void s_traverse_start(TOPLEVEL * pr_current)
 {
   GList *iter;
   PAGE *p_current;
+  GPtrArray *pages;
+  guint i;
+
+  s_stats_phase_begin ("traverse", NULL);
+  serial_state.n_visits = 0;
 
-  for ( iter = geda_list_get_glist( pr_current->pages );
+  /* only traverse pages which are toplevel, ie not underneath.  The
+   * list has to be taken first, since loading sub-sheets adds pages. */
+  pages = g_ptr_array_new ();
+  for ( iter = (traverse_pages != NULL) ? traverse_pages
+                                        : geda_list_get_glist( pr_current->pages );
         iter != NULL;
         iter = g_list_next( iter ) ) {
 
     p_current = (PAGE *)iter->data;
 
-    /* only traverse pages which are toplevel, ie not underneath */
     if (p_current->page_control == 0) {
+      g_ptr_array_add (pages, p_current);
+    }
+  }
+
+  if (incremental) {
+    s_traverse_pages_incremental (pr_current, pages);
+  } else if (!s_traverse_pages_parallel (pr_current, pages)) {
+    for (i = 0; i < pages->len; i++) {
+      p_current = g_ptr_array_index (pages, i);
       pr_current->page_current = p_current;
       s_traverse_sheet (pr_current, s_page_objects (p_current), NULL);
     }
   }
+  g_ptr_array_free (pages, TRUE);
+  s_stats_add ("traversal-visits", serial_state.n_visits);
 
   /* now that all the sheets have been read, go through and do the */
   /* post processing work */
+  s_stats_phase_begin ("post-process", NULL);
   s_netlist_post_process(pr_current, netlist_head);
 
   /* Now match the graphical netlist with the net names already assigned */
   s_netlist_name_named_nets(pr_current, netlist_head,
                             graphical_netlist_head);
+  s_stats_phase_end ();
+
+  /* Discard anything indexed before the netlist was complete */
+  s_netindex_destroy();
+  s_package_destroy();
+  s_drc2_destroy();
+  s_intern_destroy();
+  g_snapshot_destroy();
+
+  s_intern_build(netlist_head);
 
   if (verbose_mode) {
     printf("\nInternal netlist representation:\n\n");
@@ -165,7 +953,7 @@ s_traverse_sheet (TOPLEVEL * pr_current, const GList *obj_list, char *hierarchy_
   for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
     OBJECT *o_current = iter->data;
 
-    netlist = s_netlist_return_tail(netlist_head);
+    netlist = s_netlist_return_tail(s_traverse_netlist_head ());
 
     if (o_current->type == OBJ_PLACEHOLDER) {
       printf("WARNING: Found a placeholder/missing component, are you missing a symbol file? [%s]\n", o_current->complex_basename);
@@ -179,6 +967,10 @@ s_traverse_sheet (TOPLEVEL * pr_current, const GList *obj_list, char *hierarchy_
 
       verbose_print(" C");
 
+      if (!o_current->complex_embedded) {
+        s_traverse_depend_symbol (o_current->complex_basename);
+      }
+
       /* look for special tag */
       temp = o_attrib_search_object_attribs_by_name (o_current, "graphical", 0);
       if (temp) {
@@ -186,7 +978,7 @@ s_traverse_sheet (TOPLEVEL * pr_current, const GList *obj_list, char *hierarchy_
 	   graphical netlist */
         g_free(temp);
 	
-	netlist = s_netlist_return_tail(graphical_netlist_head);
+	netlist = s_netlist_return_tail(s_traverse_graphical_netlist_head ());
 	is_graphical = TRUE;
 	
     
@@ -302,7 +1094,7 @@ CPINLIST *s_traverse_component(TOPLEVEL * pr_current, OBJECT * component,
     if (o_current->conn_list != NULL) {
       (void) s_traverse_net (pr_current, nets, TRUE,
                              o_current, hierarchy_tag, cpins->type);
-      s_traverse_clear_all_visited (s_page_objects (pr_current->page_current));
+      s_traverse_clear_all_visited ();
     }
 
     cpins->nets = nets_head;
@@ -11,6 +11,10 @@ export TESTDIR
 
 schbasename=`basename $INPUT .sch`
 
+# Built-in backends must match the output of the Scheme backend
+# they replace
+REFERENCE=`echo $BACKEND | sed 's/^native-//'`
+
 SCMDIR=$SRCDIR/../scheme \
 SYMDIR=$SRCDIR/../../symbols \
 GEDADATARC=$BUILDDIR/../lib \
@@ -25,9 +29,13 @@ then
 	exit 1
 fi
 
-sed '/gnetlist.*-g/d' ${SRCDIR}/${schbasename}.$BACKEND > \
+# The json header record names the input files, which depend on where
+# the tests are run from
+sed -e '/gnetlist.*-g/d' -e '/^{"record":"header"/d' \
+	${SRCDIR}/${schbasename}.$REFERENCE > \
 	${BUILDDIR}/${schbasename}.${BACKEND}.filtered
-sed '/gnetlist.*-g/d' ${BUILDDIR}/new_${schbasename}.$BACKEND > \
+sed -e '/gnetlist.*-g/d' -e '/^{"record":"header"/d' \
+	${BUILDDIR}/new_${schbasename}.$BACKEND > \
 	${BUILDDIR}/new_${schbasename}.${BACKEND}.filtered
 diff $EXTRADIFF ${BUILDDIR}/${schbasename}.${BACKEND}.filtered \
 	 ${BUILDDIR}/new_${schbasename}.${BACKEND}.filtered
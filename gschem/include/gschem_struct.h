@@ -87,6 +87,23 @@ struct st_gschem_toplevel {
 
   int win_width, win_height;            /* Actual size of window (?) */
 
+  /* Backing store: the page as last drawn, without rubberbands, and
+   * the view it was drawn for (see o_redraw_exposed()) */
+  GdkPixmap *backing;
+  GdkRegion *backing_damage;            /* areas of backing out of date */
+  PAGE *backing_page;
+  int backing_left, backing_top, backing_right, backing_bottom;
+  int backing_width, backing_height;
+  int backing_draw_selected;
+
+  /* Symbols rendered at the current zoom (see o_complex_draw()) */
+  GHashTable *glyph_cache;
+  double glyph_cache_scale;
+
+  /* Text laid out at the current zoom (see o_text_draw()) */
+  GHashTable *text_layouts;
+  double text_layouts_scale;
+
   /* ------------- */
   /* Drawing state */
   /* ------------- */
@@ -208,6 +225,13 @@ struct st_gschem_toplevel {
   int zoom_gain;          /* Percentage increase in size for a zoom-in operation */
   int scrollpan_steps;    /* Number of scroll pan events required to traverse the viewed area */
 
+  /* Level of detail: sizes on screen, in pixels, below which things
+   * are simplified or not drawn (0 to always draw them in full) */
+  int text_lod_threshold;    /* text height, drawn as a box below this */
+  int symbol_lod_threshold;  /* component size, drawn as a box below this */
+  int fill_lod_threshold;    /* hatch/mesh pitch, not drawn below this */
+  int cue_lod_threshold;     /* cue size, not drawn below this */
+
   char *print_command;    /* The command to send postscript to when printing */
 
   SCM smob;               /* The Scheme representation of this window */
@@ -81,3 +81,7 @@ extern int default_keyboardpan_gain;
 extern int default_select_slack_pixels;
 extern int default_zoom_gain;
 extern int default_scrollpan_steps;
+extern int default_text_lod_threshold;
+extern int default_symbol_lod_threshold;
+extern int default_fill_lod_threshold;
+extern int default_cue_lod_threshold;
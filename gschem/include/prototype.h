@@ -261,6 +261,10 @@ SCM g_rc_print_command(SCM mode);
 SCM g_rc_select_slack_pixels(SCM pixels);
 SCM g_rc_zoom_gain(SCM gain);
 SCM g_rc_scrollpan_steps(SCM steps);
+SCM g_rc_text_lod_threshold(SCM pixels);
+SCM g_rc_symbol_lod_threshold(SCM pixels);
+SCM g_rc_fill_lod_threshold(SCM pixels);
+SCM g_rc_cue_lod_threshold(SCM pixels);
 SCM g_rc_display_color_map (SCM scm_map);
 SCM g_rc_display_outline_color_map (SCM scm_map);
 /* g_register.c */
@@ -489,8 +493,10 @@ void o_attrib_toggle_show_name_value(GSCHEM_TOPLEVEL *w_current, OBJECT *object,
 OBJECT *o_attrib_add_attrib(GSCHEM_TOPLEVEL *w_current, const char *text_string, int visibility, int show_name_value, OBJECT *object);
 /* o_basic.c */
 void o_redraw_rects(GSCHEM_TOPLEVEL *w_current, GdkRectangle *rectangles, int n_rectangles);
+void o_redraw_exposed(GSCHEM_TOPLEVEL *w_current, GdkRegion *region);
 void o_redraw(GSCHEM_TOPLEVEL *w_current, GList *object_list, gboolean draw_selected);
 void o_redraw_single(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current);
+gboolean o_fill_too_dense(GSCHEM_TOPLEVEL *w_current, int fill_type, int pitch1, int pitch2);
 int o_invalidate_rubber(GSCHEM_TOPLEVEL *w_current);
 int o_redraw_cleanstates(GSCHEM_TOPLEVEL *w_current);
 void o_draw_place(GSCHEM_TOPLEVEL *w_current, int dx, int dy, OBJECT *object);
@@ -535,6 +541,7 @@ void o_circle_draw_rubber(GSCHEM_TOPLEVEL *w_current);
 void o_circle_draw_grips(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current);
 /* o_complex.c */
 void o_complex_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current);
+void o_complex_glyph_cache_flush(GSCHEM_TOPLEVEL *w_current);
 void o_complex_draw_place(GSCHEM_TOPLEVEL *w_current, int dx, int dy, OBJECT *complex);
 void o_complex_prepare_place(GSCHEM_TOPLEVEL *w_current, const CLibSymbol *sym);
 void o_complex_place_changed_run_hook(GSCHEM_TOPLEVEL *w_current);
@@ -545,8 +552,6 @@ void o_copy_end(GSCHEM_TOPLEVEL *w_current);
 void o_copy_multiple_end(GSCHEM_TOPLEVEL *w_current);
 /* o_cue.c */
 void o_cue_redraw_all(GSCHEM_TOPLEVEL *w_current, GList *list, gboolean draw_selected);
-void o_cue_draw_lowlevel(GSCHEM_TOPLEVEL *w_current, OBJECT *object, int whichone);
-void o_cue_draw_lowlevel_midpoints(GSCHEM_TOPLEVEL *w_current, OBJECT *object);
 void o_cue_draw_single(GSCHEM_TOPLEVEL *w_current, OBJECT *object);
 void o_cue_draw_list(GSCHEM_TOPLEVEL *w_current, GList *object_list);
 /* o_delete.c */
@@ -593,6 +598,7 @@ int o_edit_find_text(GSCHEM_TOPLEVEL *w_current, const GList *o_list, char *stex
 void o_edit_hide_specific_text(GSCHEM_TOPLEVEL *w_current, const GList *o_list, char *stext);
 void o_edit_show_specific_text(GSCHEM_TOPLEVEL *w_current, const GList *o_list, char *stext);
 OBJECT *o_update_component(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current);
+void o_autosave_wait(PAGE *page);
 void o_autosave_backups(GSCHEM_TOPLEVEL *w_current);
 /* o_move.c */
 void o_move_start(GSCHEM_TOPLEVEL *w_current, int x, int y);
@@ -664,6 +670,7 @@ void o_place_rotate(GSCHEM_TOPLEVEL *w_current);
 /* o_select.c */
 void o_select_run_hooks(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current, int flag);
 void o_select_object(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current, int type, int count);
+void o_select_object_list(GSCHEM_TOPLEVEL *w_current, GList *objects);
 int o_select_box_start(GSCHEM_TOPLEVEL *w_current, int x, int y);
 void o_select_box_end(GSCHEM_TOPLEVEL *w_current, int x, int y);
 void o_select_box_motion(GSCHEM_TOPLEVEL *w_current, int x, int y);
@@ -681,6 +688,7 @@ void o_slot_start(GSCHEM_TOPLEVEL *w_current, OBJECT *object);
 void o_slot_end(GSCHEM_TOPLEVEL *w_current, OBJECT *object, const char *string);
 /* o_text.c */
 int o_text_get_rendered_bounds(void *user_data, OBJECT *object, int *min_x, int *min_y, int *max_x, int *max_y);
+void o_text_layout_cache_flush(GSCHEM_TOPLEVEL *w_current);
 void o_text_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current);
 void o_text_draw_place(GSCHEM_TOPLEVEL *w_current, int dx, int dy, OBJECT *o_current);
 void o_text_prepare_place(GSCHEM_TOPLEVEL *w_current, char *text);
@@ -691,10 +699,12 @@ void o_text_change(GSCHEM_TOPLEVEL *w_current, OBJECT *object, char *string, int
 void o_undo_init(void);
 void o_undo_savestate(GSCHEM_TOPLEVEL *w_current, int flag);
 char *o_undo_find_prev_filename(UNDO *start);
-GList *o_undo_find_prev_object_head(UNDO *start);
 void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type);
 void o_undo_cleanup(void);
 void o_undo_remove_last_undo(GSCHEM_TOPLEVEL *w_current);
+void o_undo_write_file(const gchar *filename, gchar *buffer, int mode);
+void o_undo_wait_for_file(const gchar *filename);
+void o_undo_wait_for_writes(void);
 /* parsecmd.c */
 int parse_commandline(int argc, char *argv[]);
 /* s_stretch.c */
@@ -80,6 +80,8 @@
 ; to disk).  The other mechanism uses only memory.  The disk mechanism is
 ; nice because you get undo-level number of backups of the schematic written
 ; to disk as backups so you should never lose a schematic due to a crash.
+; The memory mechanism only keeps the objects changed by each action, so
+; undo and redo stay quick on large schematics.
 ;
 (undo-type "disk")
 ;(undo-type "memory")
@@ -263,6 +265,28 @@
 ;(select-slack-pixels 0)
 ;(select-slack-pixels 1)
 
+; text-lod-threshold integer
+; symbol-lod-threshold integer
+; fill-lod-threshold integer
+; cue-lod-threshold integer
+;
+; Level of detail controls, to keep drawing fast when zoomed out.  Each
+; is a size on the screen in pixels:
+;
+;   text-lod-threshold    text smaller than this is drawn as a box
+;   symbol-lod-threshold  components smaller than this (both wide and
+;                         high) are drawn as their bounding box
+;   fill-lod-threshold    hatch and mesh fills with lines closer together
+;                         than this are not drawn
+;   cue-lod-threshold     net end and junction cues smaller than this
+;                         are not drawn
+;
+; Set any of them to 0 to always draw everything in full.
+(text-lod-threshold 3)
+(symbol-lod-threshold 4)
+(fill-lod-threshold 3)
+(cue-lod-threshold 2)
+
 
 ; action-feedback-mode string
 ;
@@ -1563,6 +1563,80 @@ SCM g_rc_scrollpan_steps(SCM steps)
   return SCM_BOOL_T;
 }
 
+/*! \brief Check a level of detail threshold from gschemrc.
+ *  \par Function Description
+ *  Thresholds are sizes on the screen in pixels.  Zero switches the
+ *  rule off; negative values are rejected.
+ */
+static int g_rc_lod_threshold (SCM pixels, const char *name, int fallback)
+{
+  int val;
+
+  SCM_ASSERT (scm_is_integer (pixels), pixels, SCM_ARG1, name);
+
+  val = scm_to_int (pixels);
+
+  if (val < 0) {
+    fprintf(stderr, _("Invalid number of pixels [%d] passed to %s\n"),
+            val, name);
+    val = fallback;
+  }
+
+  return val;
+}
+
+/*! \brief Set the size below which text is drawn as a box.
+ *  \par Function Description
+ *  Text less than \a pixels high on the screen is not laid out, but
+ *  drawn as its bounding box.
+ */
+SCM g_rc_text_lod_threshold(SCM pixels)
+{
+  default_text_lod_threshold =
+    g_rc_lod_threshold (pixels, "text-lod-threshold", 3);
+
+  return SCM_BOOL_T;
+}
+
+/*! \brief Set the size below which components are drawn as a box.
+ *  \par Function Description
+ *  Components less than \a pixels wide and high on the screen are
+ *  drawn as their bounding box.
+ */
+SCM g_rc_symbol_lod_threshold(SCM pixels)
+{
+  default_symbol_lod_threshold =
+    g_rc_lod_threshold (pixels, "symbol-lod-threshold", 4);
+
+  return SCM_BOOL_T;
+}
+
+/*! \brief Set the pitch below which hatch and mesh fills are skipped.
+ *  \par Function Description
+ *  Hatch and mesh fills whose lines are less than \a pixels apart on
+ *  the screen are not drawn.
+ */
+SCM g_rc_fill_lod_threshold(SCM pixels)
+{
+  default_fill_lod_threshold =
+    g_rc_lod_threshold (pixels, "fill-lod-threshold", 3);
+
+  return SCM_BOOL_T;
+}
+
+/*! \brief Set the size below which connection cues are skipped.
+ *  \par Function Description
+ *  Endpoint and junction cues less than \a pixels across on the
+ *  screen are not drawn.
+ */
+SCM g_rc_cue_lod_threshold(SCM pixels)
+{
+  default_cue_lod_threshold =
+    g_rc_lod_threshold (pixels, "cue-lod-threshold", 2);
+
+  return SCM_BOOL_T;
+}
+
 
 extern COLOR display_colors[MAX_COLORS];
 extern COLOR display_outline_colors[MAX_COLORS];
@@ -131,6 +131,10 @@ static struct gsubr_t gschem_funcs[] = {
   { "select-slack-pixels",       1, 0, 0, g_rc_select_slack_pixels },
   { "zoom-gain",                 1, 0, 0, g_rc_zoom_gain },
   { "scrollpan-steps",           1, 0, 0, g_rc_scrollpan_steps },
+  { "text-lod-threshold",        1, 0, 0, g_rc_text_lod_threshold },
+  { "symbol-lod-threshold",      1, 0, 0, g_rc_symbol_lod_threshold },
+  { "fill-lod-threshold",        1, 0, 0, g_rc_fill_lod_threshold },
+  { "cue-lod-threshold",         1, 0, 0, g_rc_cue_lod_threshold },
 
   /* backup functions */
   { "auto-save-interval",        1, 0, 0, g_rc_auto_save_interval },
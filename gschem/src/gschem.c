@@ -149,8 +149,9 @@ void main_prog(void *closure, int argc, char *argv[])
   SCM scm_tmp;
 
 #ifdef HAVE_GTHREAD
-  /* Gschem isn't threaded, but some of GTK's file chooser
-   * backends uses threading so we need to call g_thread_init().
+  /* Gschem writes undo files and backups on a thread of its own,
+   * and some of GTK's file chooser backends use threading too, so
+   * we need to call g_thread_init().
    * GLib requires threading be initialised before any other GLib
    * functions are called. Do it now if its not already setup.  */
   if (!g_thread_supported ()) g_thread_init (NULL);
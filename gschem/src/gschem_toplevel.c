@@ -100,6 +100,17 @@ GSCHEM_TOPLEVEL *gschem_toplevel_new ()
   w_current->pl = NULL;
   w_current->win_width = 0;
   w_current->win_height = 0;
+  w_current->backing = NULL;
+  w_current->backing_damage = NULL;
+  w_current->backing_page = NULL;
+  w_current->backing_left = w_current->backing_top = 0;
+  w_current->backing_right = w_current->backing_bottom = 0;
+  w_current->backing_width = w_current->backing_height = 0;
+  w_current->backing_draw_selected = FALSE;
+  w_current->glyph_cache = NULL;
+  w_current->glyph_cache_scale = 0;
+  w_current->text_layouts = NULL;
+  w_current->text_layouts_scale = 0;
 
   /* ------------- */
   /* Drawing state */
@@ -198,6 +209,10 @@ GSCHEM_TOPLEVEL *gschem_toplevel_new ()
   w_current->select_slack_pixels = 4;
   w_current->zoom_gain = 20;
   w_current->scrollpan_steps = 8;
+  w_current->text_lod_threshold = 3;
+  w_current->symbol_lod_threshold = 4;
+  w_current->fill_lod_threshold = 3;
+  w_current->cue_lod_threshold = 2;
   w_current->snap = SNAP_GRID;
   w_current->snap_size = 100;
 
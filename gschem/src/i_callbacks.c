@@ -1720,6 +1720,7 @@ DEFINE_I_CALLBACK(page_revert)
   up = w_current->toplevel->page_current->up;
 
   /* delete the page, then re-open the file as a new page */
+  o_autosave_wait (w_current->toplevel->page_current);
   s_page_delete (w_current->toplevel, w_current->toplevel->page_current);
 
   page = x_window_open_page (w_current, filename);
@@ -130,6 +130,12 @@ int default_select_slack_pixels = 4;
 int default_zoom_gain = 20;
 int default_scrollpan_steps = 8;
 
+/* level of detail thresholds, in pixels (see o_redraw_single()) */
+int default_text_lod_threshold = 3;
+int default_symbol_lod_threshold = 4;
+int default_fill_lod_threshold = 3;
+int default_cue_lod_threshold = 2;
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -241,6 +247,11 @@ void i_vars_set(GSCHEM_TOPLEVEL *w_current)
   w_current->zoom_gain = default_zoom_gain;
   w_current->scrollpan_steps = default_scrollpan_steps;
 
+  w_current->text_lod_threshold = default_text_lod_threshold;
+  w_current->symbol_lod_threshold = default_symbol_lod_threshold;
+  w_current->fill_lod_threshold = default_fill_lod_threshold;
+  w_current->cue_lod_threshold = default_cue_lod_threshold;
+
   toplevel->auto_save_interval = default_auto_save_interval;
 }
 
@@ -32,13 +32,25 @@
  * readability issues
  */
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Whether selected objects are drawn in place. */
+static gboolean o_redraw_draw_selected (GSCHEM_TOPLEVEL *w_current)
+{
+  return !(w_current->inside_action &&
+           ((w_current->event_state == MOVE) ||
+            (w_current->event_state == ENDMOVE)));
+}
+
+/*! \brief Redraw the page in some areas of the screen
  *  \par Function Description
+ *  Repaints the background and grid, and draws the objects and cues,
+ *  in \a rectangles.  Rubberbands are left to o_redraw_rubber().
  *
+ *  \param [in] w_current     The GSCHEM_TOPLEVEL object.
+ *  \param [in] rectangles    The areas to redraw, in screen coordinates.
+ *  \param [in] n_rectangles  The number of areas.
  */
-void o_redraw_rects (GSCHEM_TOPLEVEL *w_current,
-                     GdkRectangle *rectangles, int n_rectangles)
+static void o_redraw_page_rects (GSCHEM_TOPLEVEL *w_current,
+                                 GdkRectangle *rectangles, int n_rectangles)
 {
   TOPLEVEL *toplevel = w_current->toplevel;
   gboolean draw_selected;
@@ -82,9 +94,7 @@ void o_redraw_rects (GSCHEM_TOPLEVEL *w_current,
                                         world_rects, n_rectangles);
   g_free (world_rects);
 
-  draw_selected = !(w_current->inside_action &&
-                    ((w_current->event_state == MOVE) ||
-                     (w_current->event_state == ENDMOVE)));
+  draw_selected = o_redraw_draw_selected (w_current);
 
   for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
     OBJECT *o_current = iter->data;
@@ -98,6 +108,12 @@ void o_redraw_rects (GSCHEM_TOPLEVEL *w_current,
 
   o_cue_redraw_all (w_current, obj_list, draw_selected);
 
+  g_list_free (obj_list);
+}
+
+/*! \brief Redraw the rubberband of the current action. */
+static void o_redraw_rubber (GSCHEM_TOPLEVEL *w_current)
+{
   if (w_current->inside_action) {
     /* Redraw the rubberband objects (if they were previously visible) */
     switch (w_current->event_state) {
@@ -177,8 +193,140 @@ void o_redraw_rects (GSCHEM_TOPLEVEL *w_current,
         break;
     }
   }
+}
 
-  g_list_free (obj_list);
+/*! \todo Finish function documentation!!!
+ *  \brief
+ *  \par Function Description
+ *
+ */
+void o_redraw_rects (GSCHEM_TOPLEVEL *w_current,
+                     GdkRectangle *rectangles, int n_rectangles)
+{
+  o_redraw_page_rects (w_current, rectangles, n_rectangles);
+  o_redraw_rubber (w_current);
+}
+
+/*! \brief Mark the whole backing store out of date. */
+static void o_redraw_damage_all (GSCHEM_TOPLEVEL *w_current)
+{
+  GdkRectangle rect = { 0, 0, 0, 0 };
+
+  rect.width = w_current->backing_width;
+  rect.height = w_current->backing_height;
+
+  if (w_current->backing_damage != NULL)
+    gdk_region_destroy (w_current->backing_damage);
+  w_current->backing_damage = gdk_region_rectangle (&rect);
+}
+
+/*! \brief Redraw an exposed area of the drawing area
+ *  \par Function Description
+ *  The page is drawn into a backing store, and exposed areas are
+ *  copied from it.  Only the parts of the backing store that were
+ *  invalidated since (see o_invalidate_rect()) are drawn again, so
+ *  uncovering the window or moving a dialog over it costs a copy.
+ *  The whole backing store is redrawn when the window size, the page,
+ *  the view of the page or the way selected objects are drawn has
+ *  changed.  Rubberbands are drawn over the copy, on the window only.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] region     The exposed region of the window.
+ */
+void o_redraw_exposed (GSCHEM_TOPLEVEL *w_current, GdkRegion *region)
+{
+  PAGE *page = w_current->toplevel->page_current;
+  gboolean draw_selected = o_redraw_draw_selected (w_current);
+  GdkRectangle *rectangles;
+  int n_rectangles;
+  GdkRegion *update;
+  GdkPixmap *save_drawable;
+  cairo_t *save_cr;
+  PangoLayout *save_pl;
+  int i;
+
+  g_return_if_fail (page != NULL);
+
+  /* Not configured yet: draw directly */
+  if (w_current->win_width <= 0 || w_current->win_height <= 0) {
+    gdk_region_get_rectangles (region, &rectangles, &n_rectangles);
+    o_redraw_rects (w_current, rectangles, n_rectangles);
+    g_free (rectangles);
+    return;
+  }
+
+  if (w_current->backing == NULL ||
+      w_current->backing_width != w_current->win_width ||
+      w_current->backing_height != w_current->win_height) {
+    if (w_current->backing != NULL)
+      g_object_unref (w_current->backing);
+    w_current->backing = gdk_pixmap_new (w_current->window,
+                                         w_current->win_width,
+                                         w_current->win_height, -1);
+    w_current->backing_width = w_current->win_width;
+    w_current->backing_height = w_current->win_height;
+    o_redraw_damage_all (w_current);
+  }
+
+  if (w_current->backing_page != page ||
+      w_current->backing_left != page->left ||
+      w_current->backing_top != page->top ||
+      w_current->backing_right != page->right ||
+      w_current->backing_bottom != page->bottom ||
+      w_current->backing_draw_selected != draw_selected) {
+    w_current->backing_page = page;
+    w_current->backing_left = page->left;
+    w_current->backing_top = page->top;
+    w_current->backing_right = page->right;
+    w_current->backing_bottom = page->bottom;
+    w_current->backing_draw_selected = draw_selected;
+    o_redraw_damage_all (w_current);
+  }
+
+  /* Bring the exposed part of the backing store up to date */
+  update = gdk_region_copy (region);
+  gdk_region_intersect (update, w_current->backing_damage);
+
+  if (!gdk_region_empty (update)) {
+    gdk_region_subtract (w_current->backing_damage, update);
+    gdk_region_get_rectangles (update, &rectangles, &n_rectangles);
+
+    save_drawable = w_current->drawable;
+    save_cr = w_current->cr;
+    save_pl = w_current->pl;
+    w_current->drawable = w_current->backing;
+    w_current->cr = gdk_cairo_create (w_current->backing);
+    w_current->pl = pango_cairo_create_layout (w_current->cr);
+
+    /* Objects crossing the edge of the update must not be drawn over
+     * the parts that are still valid */
+    gdk_cairo_region (w_current->cr, update);
+    cairo_clip (w_current->cr);
+    gdk_gc_set_clip_region (w_current->gc, update);
+
+    o_redraw_page_rects (w_current, rectangles, n_rectangles);
+
+    gdk_gc_set_clip_region (w_current->gc, NULL);
+    g_object_unref (w_current->pl);
+    cairo_destroy (w_current->cr);
+    w_current->drawable = save_drawable;
+    w_current->cr = save_cr;
+    w_current->pl = save_pl;
+
+    g_free (rectangles);
+  }
+  gdk_region_destroy (update);
+
+  gdk_region_get_rectangles (region, &rectangles, &n_rectangles);
+  for (i = 0; i < n_rectangles; i++) {
+    gdk_draw_drawable (w_current->window, w_current->gc, w_current->backing,
+                       rectangles[i].x, rectangles[i].y,
+                       rectangles[i].x, rectangles[i].y,
+                       rectangles[i].width, rectangles[i].height);
+  }
+  g_free (rectangles);
+
+  o_redraw_rubber (w_current);
 }
 
 
@@ -203,9 +351,76 @@ void o_redraw (GSCHEM_TOPLEVEL *w_current, GList *object_list, gboolean draw_sel
   }
 }
 
+/*! \brief Draw a component too small to make out as a box.
+ *  \par Function Description
+ *  If \a o_current is smaller on the screen than the symbol level of
+ *  detail threshold in both directions, draws its bounding box instead
+ *  of its contents.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] o_current  The complex OBJECT.
+ *  \return TRUE if the box was drawn, FALSE if the complex must be
+ *          drawn in full.
+ */
+static gboolean o_redraw_tiny_complex (GSCHEM_TOPLEVEL *w_current,
+                                       OBJECT *o_current)
+{
+  int left, top, right, bottom;
+
+  if (w_current->symbol_lod_threshold <= 0)
+    return FALSE;
+
+  if (!world_get_single_object_bounds (w_current->toplevel, o_current,
+                                       &left, &top, &right, &bottom))
+    return FALSE;
+
+  if (SCREENabs (w_current, right - left) >= w_current->symbol_lod_threshold ||
+      SCREENabs (w_current, bottom - top) >= w_current->symbol_lod_threshold)
+    return FALSE;
+
+  gschem_cairo_box (w_current, 0, left, bottom, right, top);
+  gschem_cairo_set_source_color (w_current,
+                                 o_drawing_color (w_current, o_current));
+  gschem_cairo_stroke (w_current, TYPE_SOLID, END_NONE, 0, -1, -1);
+
+  return TRUE;
+}
+
+/*! \brief Check if a hatch or mesh fill is too dense to draw.
+ *  \par Function Description
+ *  Hatch and mesh fills whose lines are closer together on the screen
+ *  than the fill level of detail threshold are not worth drawing line
+ *  by line.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] fill_type  The fill type of the object.
+ *  \param [in] pitch1     The first pitch, in world units.
+ *  \param [in] pitch2     The second pitch, in world units (mesh only).
+ *  \return TRUE if the fill should be left out.
+ */
+gboolean o_fill_too_dense (GSCHEM_TOPLEVEL *w_current, int fill_type,
+                           int pitch1, int pitch2)
+{
+  int threshold = w_current->fill_lod_threshold;
+
+  if (threshold <= 0)
+    return FALSE;
+
+  switch (fill_type) {
+    case FILLING_HATCH:
+      return (SCREENabs (w_current, pitch1) < threshold);
+    case FILLING_MESH:
+      return (SCREENabs (w_current, pitch1) < threshold ||
+              SCREENabs (w_current, pitch2) < threshold);
+    default:
+      return FALSE;
+  }
+}
+
 /*! \brief Redraw an object on the screen.
  *  \par Function Description
  *  This function will redraw a single object on the screen.
+ *  Components too small to make out are drawn as their bounding box.
  *
  *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
  *  \param [in] o_current  The OBJECT to redraw.
@@ -218,6 +433,11 @@ void o_redraw_single(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
   if (o_current == NULL)
     return;
 
+  if ((o_current->type == OBJ_COMPLEX ||
+       o_current->type == OBJ_PLACEHOLDER) &&
+      o_redraw_tiny_complex (w_current, o_current))
+    return;
+
   switch (o_current->type) {
       case OBJ_LINE:    func = o_line_draw;    break;
       case OBJ_NET:     func = o_net_draw;     break;
@@ -513,6 +733,9 @@ void o_invalidate_rect (GSCHEM_TOPLEVEL *w_current,
   rect.width = 1 + abs( x1 - x2 ) + 2 * bloat;
   rect.height = 1 + abs( y1 - y2 ) + 2 * bloat;
   gdk_window_invalidate_rect( w_current->window, &rect, FALSE );
+
+  if (w_current->backing_damage != NULL)
+    gdk_region_union_with_rect (w_current->backing_damage, &rect);
 }
 
 
@@ -527,6 +750,9 @@ void o_invalidate_rect (GSCHEM_TOPLEVEL *w_current,
 void o_invalidate_all (GSCHEM_TOPLEVEL *w_current)
 {
   gdk_window_invalidate_rect (w_current->window, NULL, FALSE);
+
+  if (w_current->backing_damage != NULL)
+    o_redraw_damage_all (w_current);
 }
 
 
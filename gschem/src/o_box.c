@@ -294,6 +294,8 @@ void o_box_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
 
   if ((pitch1 <= 0) || (pitch2 <= 0))
     fill_func = o_box_fill_fill;
+  else if (o_fill_too_dense (w_current, o_current->fill_type, pitch1, pitch2))
+    fill_func = o_box_fill_hollow;
 
   (*fill_func) (w_current, o_drawing_color (w_current, o_current),
                 o_current->box, o_current->fill_width,
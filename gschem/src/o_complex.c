@@ -32,17 +32,340 @@
 #include <dmalloc.h>
 #endif
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/* Largest symbol, in pixels, that is drawn from the glyph cache.
+ * Bigger ones are few enough on the screen to draw directly. */
+#define GLYPH_MAX_AREA (200 * 200)
+
+/* Number of glyphs kept before the cache is emptied */
+#define GLYPH_CACHE_SIZE 256
+
+/* Margin around a glyph for antialiasing and line hinting, in pixels */
+#define GLYPH_MARGIN 2
+
+/*! A symbol rendered at the current zoom. */
+typedef struct {
+  cairo_surface_t *surface;
+  int dx, dy;         /* glyph corner relative to the symbol origin */
+} COMPLEX_GLYPH;
+
+static void o_complex_glyph_free (gpointer data)
+{
+  COMPLEX_GLYPH *glyph = data;
+
+  cairo_surface_destroy (glyph->surface);
+  g_free (glyph);
+}
+
+/*! \brief Forget the rendered symbols.
  *  \par Function Description
+ *  Empties the glyph cache of \a w_current.
  *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ */
+void o_complex_glyph_cache_flush (GSCHEM_TOPLEVEL *w_current)
+{
+  if (w_current->glyph_cache != NULL) {
+    g_hash_table_destroy (w_current->glyph_cache);
+    w_current->glyph_cache = NULL;
+  }
+}
+
+/*! \brief Work out the glyph cache key of a symbol.
+ *  \par Function Description
+ *  The key names the symbol, its orientation and the color it is
+ *  drawn in, and sums up the coordinates and style of its graphical
+ *  primitives relative to its origin, so that instances edited apart
+ *  from their symbol (see o_complex_unshare()) get their own glyphs.
+ *
+ *  \param [in]  w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in]  o_current  The complex.
+ *  \param [out] rleft      Left of the primitives' bounds.
+ *  \param [out] rtop       Top of the primitives' bounds.
+ *  \param [out] rright     Right of the primitives' bounds.
+ *  \param [out] rbottom    Bottom of the primitives' bounds.
+ *  \return A newly allocated key, or NULL if \a o_current must be
+ *          drawn directly.
+ */
+static gchar *o_complex_glyph_key (GSCHEM_TOPLEVEL *w_current,
+                                   OBJECT *o_current,
+                                   int *rleft, int *rtop,
+                                   int *rright, int *rbottom)
+{
+  TOPLEVEL *toplevel = w_current->toplevel;
+  OBJECT *temp;
+  GList *iter;
+  int color = -1;
+  gboolean found = FALSE;
+  guint hash = 5381;
+  int n = 0;
+  int cx, cy;
+  int i;
+
+  if (o_current->complex_basename == NULL)
+    return NULL;
+
+  for (temp = o_current; temp != NULL; temp = temp->parent) {
+    if (temp->selected) {
+      color = SELECT_COLOR;
+      break;
+    }
+  }
+  if (toplevel->override_color != -1)
+    color = toplevel->override_color;
+
+#define GLYPH_HASH(v) (hash = hash * 33 + (guint) (v))
+
+  cx = o_current->complex->x;
+  cy = o_current->complex->y;
+
+  for (iter = o_current->complex->prim_objs;
+       iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *prim = iter->data;
+    int left, top, right, bottom;
+
+    switch (prim->type) {
+      case OBJ_TEXT:
+        continue;
+      case OBJ_LINE:
+      case OBJ_BOX:
+      case OBJ_CIRCLE:
+      case OBJ_ARC:
+      case OBJ_PATH:
+      case OBJ_PIN:
+        break;
+      default:
+        return NULL;
+    }
+
+    if (prim->dont_redraw)
+      return NULL;
+
+    if (!world_get_single_object_bounds (toplevel, prim,
+                                         &left, &top, &right, &bottom))
+      continue;
+
+    GLYPH_HASH (prim->type);
+    GLYPH_HASH (prim->color);
+    GLYPH_HASH (prim->line_end);
+    GLYPH_HASH (prim->line_type);
+    GLYPH_HASH (prim->line_width);
+    GLYPH_HASH (prim->line_length);
+    GLYPH_HASH (prim->line_space);
+    GLYPH_HASH (prim->fill_type);
+    GLYPH_HASH (prim->fill_width);
+    GLYPH_HASH (prim->fill_angle1);
+    GLYPH_HASH (prim->fill_pitch1);
+    GLYPH_HASH (prim->fill_angle2);
+    GLYPH_HASH (prim->fill_pitch2);
+
+    /* The coordinates themselves, not just the bounds: a "/" and a
+     * "\" line, or arcs of different sweep, have the same bounds */
+    switch (prim->type) {
+      case OBJ_LINE:
+      case OBJ_PIN:
+        GLYPH_HASH (prim->line->x[0] - cx);
+        GLYPH_HASH (prim->line->y[0] - cy);
+        GLYPH_HASH (prim->line->x[1] - cx);
+        GLYPH_HASH (prim->line->y[1] - cy);
+        break;
+      case OBJ_BOX:
+        GLYPH_HASH (prim->box->upper_x - cx);
+        GLYPH_HASH (prim->box->upper_y - cy);
+        GLYPH_HASH (prim->box->lower_x - cx);
+        GLYPH_HASH (prim->box->lower_y - cy);
+        break;
+      case OBJ_CIRCLE:
+        GLYPH_HASH (prim->circle->center_x - cx);
+        GLYPH_HASH (prim->circle->center_y - cy);
+        GLYPH_HASH (prim->circle->radius);
+        break;
+      case OBJ_ARC:
+        GLYPH_HASH (prim->arc->x - cx);
+        GLYPH_HASH (prim->arc->y - cy);
+        GLYPH_HASH (prim->arc->width);
+        GLYPH_HASH (prim->arc->height);
+        GLYPH_HASH (prim->arc->start_angle);
+        GLYPH_HASH (prim->arc->end_angle);
+        break;
+      case OBJ_PATH:
+        for (i = 0; i < prim->path->num_sections; i++) {
+          PATH_SECTION *section = &prim->path->sections[i];
+
+          GLYPH_HASH (section->code);
+          GLYPH_HASH (section->x1 - cx);
+          GLYPH_HASH (section->y1 - cy);
+          GLYPH_HASH (section->x2 - cx);
+          GLYPH_HASH (section->y2 - cy);
+          GLYPH_HASH (section->x3 - cx);
+          GLYPH_HASH (section->y3 - cy);
+        }
+        break;
+    }
+    n++;
+
+    if (found) {
+      *rleft = MIN (*rleft, left);
+      *rtop = MIN (*rtop, top);
+      *rright = MAX (*rright, right);
+      *rbottom = MAX (*rbottom, bottom);
+    } else {
+      *rleft = left;
+      *rtop = top;
+      *rright = right;
+      *rbottom = bottom;
+      found = TRUE;
+    }
+  }
+
+#undef GLYPH_HASH
+
+  if (!found)
+    return NULL;
+
+  return g_strdup_printf ("%s %d %d %d %d %d %u",
+                          o_current->complex_basename,
+                          o_current->complex->angle,
+                          o_current->complex->mirror,
+                          o_current->color, color, n, hash);
+}
+
+/*! \brief Draw the graphics of a symbol from the glyph cache.
+ *  \par Function Description
+ *  Symbols are drawn many times over at the same orientation, so the
+ *  lines, boxes, circles, arcs, paths and pins of each symbol are
+ *  rendered once at the current zoom and the image is painted for
+ *  every instance.  The text in the symbol is left to the caller.
+ *
+ *  Symbols too big to be worth caching, or containing pictures or
+ *  other symbols, are not drawn.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] o_current  The complex to draw.
+ *  \return TRUE if the graphics were drawn, FALSE otherwise.
+ */
+static gboolean o_complex_draw_glyph (GSCHEM_TOPLEVEL *w_current,
+                                      OBJECT *o_current)
+{
+  PAGE *page = w_current->toplevel->page_current;
+  COMPLEX_GLYPH *glyph;
+  gchar *key;
+  int left, top, right, bottom;
+  int x, y;
+
+  WORLDtoSCREEN (w_current, o_current->complex->x, o_current->complex->y,
+                 &x, &y);
+
+  /* Coordinates this far out are clipped by WORLDtoSCREEN() */
+  if (ABS (x) > 16384 || ABS (y) > 16384)
+    return FALSE;
+
+  key = o_complex_glyph_key (w_current, o_current,
+                             &left, &top, &right, &bottom);
+  if (key == NULL)
+    return FALSE;
+
+  if (w_current->glyph_cache != NULL &&
+      (w_current->glyph_cache_scale != page->to_screen_x_constant ||
+       g_hash_table_size (w_current->glyph_cache) >= GLYPH_CACHE_SIZE)) {
+    o_complex_glyph_cache_flush (w_current);
+  }
+
+  if (w_current->glyph_cache == NULL) {
+    w_current->glyph_cache =
+      g_hash_table_new_full (g_str_hash, g_str_equal,
+                             g_free, o_complex_glyph_free);
+    w_current->glyph_cache_scale = page->to_screen_x_constant;
+  }
+
+  glyph = g_hash_table_lookup (w_current->glyph_cache, key);
+
+  if (glyph == NULL) {
+    cairo_t *save_cr = w_current->cr;
+    cairo_surface_t *surface;
+    GList *iter;
+    int x1, y1, x2, y2;
+    int width, height;
+
+    WORLDtoSCREEN (w_current, left, top, &x1, &y1);
+    WORLDtoSCREEN (w_current, right, bottom, &x2, &y2);
+    width = ABS (x2 - x1) + 2 * GLYPH_MARGIN + 1;
+    height = ABS (y2 - y1) + 2 * GLYPH_MARGIN + 1;
+    x1 = MIN (x1, x2) - GLYPH_MARGIN;
+    y1 = MIN (y1, y2) - GLYPH_MARGIN;
+
+    if (width * height > GLYPH_MAX_AREA) {
+      g_free (key);
+      return FALSE;
+    }
+
+    surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+    if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS) {
+      cairo_surface_destroy (surface);
+      g_free (key);
+      return FALSE;
+    }
+
+    /* Draw the primitives as usual, shifted into the glyph.  Pins are
+     * drawn without their cues, which depend on each instance's
+     * connections and are drawn by o_cue_redraw_all(). */
+    w_current->cr = cairo_create (surface);
+    cairo_translate (w_current->cr, -x1, -y1);
+    for (iter = o_current->complex->prim_objs;
+         iter != NULL; iter = g_list_next (iter)) {
+      OBJECT *prim = iter->data;
+
+      if (prim->type != OBJ_TEXT)
+        o_redraw_single (w_current, prim);
+    }
+    cairo_destroy (w_current->cr);
+    w_current->cr = save_cr;
+
+    glyph = g_new (COMPLEX_GLYPH, 1);
+    glyph->surface = surface;
+    glyph->dx = x1 - x;
+    glyph->dy = y1 - y;
+    g_hash_table_insert (w_current->glyph_cache, key, glyph);
+  } else {
+    g_free (key);
+  }
+
+  cairo_save (w_current->cr);
+  cairo_set_source_surface (w_current->cr, glyph->surface,
+                            x + glyph->dx, y + glyph->dy);
+  cairo_paint (w_current->cr);
+  cairo_restore (w_current->cr);
+
+  return TRUE;
+}
+
+/*! \brief Draw a complex on the screen.
+ *  \par Function Description
+ *  Draws the graphics of the complex from the glyph cache where
+ *  possible, and then the text in it, which may differ between
+ *  instances of the same symbol (e.g. slotted pin numbers).
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] o_current  The complex to draw.
  */
 void o_complex_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
 {
+  GList *iter;
+
   g_return_if_fail (o_current != NULL); 
   g_return_if_fail (o_current->complex != NULL);
 
-  o_redraw(w_current, o_current->complex->prim_objs, TRUE);
+  if (!o_complex_draw_glyph (w_current, o_current)) {
+    o_redraw(w_current, o_current->complex->prim_objs, TRUE);
+    return;
+  }
+
+  for (iter = o_current->complex->prim_objs;
+       iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *prim = iter->data;
+
+    if (prim->type == OBJ_TEXT && !prim->dont_redraw)
+      o_redraw_single (w_current, prim);
+  }
 }
 
 
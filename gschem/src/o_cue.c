@@ -29,47 +29,6 @@
 #include <dmalloc.h>
 #endif
 
-/*! \todo Finish function documentation!!!
- *  \brief
- *  \par Function Description
- *
- */
-void o_cue_redraw_all (GSCHEM_TOPLEVEL *w_current, GList *list, gboolean draw_selected)
-{
-  OBJECT *o_current;
-  GList *iter;
-
-  iter = list;
-  while (iter != NULL) {
-    o_current = (OBJECT *)iter->data;
-    switch(o_current->type) {
-      case(OBJ_NET):
-      case(OBJ_BUS):
-      case(OBJ_PIN):
-	if (!(o_current->dont_redraw ||
-              (o_current->selected && !draw_selected))) {
-          o_cue_draw_single(w_current, o_current);
-          if (o_current->selected && w_current->draw_grips) {
-            o_line_draw_grips (w_current, o_current);
-          }
-        }
-        break;
-
-      case(OBJ_COMPLEX):
-      case(OBJ_PLACEHOLDER):
-	if (!(o_current->dont_redraw ||
-              (o_current->selected && !draw_selected))) {
-          o_cue_redraw_all(w_current, o_current->complex->prim_objs, 
-                           draw_selected);
-        }
-        break;
-    }
-    
-    iter = g_list_next (iter);
-  }
-}
-
-
 /*! 
  *  \brief Set the color on the gc depending on the passed in color id
  */
@@ -118,111 +77,84 @@ static void draw_junction_cue (GSCHEM_TOPLEVEL *w_current,
 }
 
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Draw a list of cues
+ *
  *  \par Function Description
+ *  Draws the cues found by s_cue_append_cues(), unless they are too
+ *  small to make out at this zoom.
  *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object
+ *  \param [in] cues       A GArray of CUE to draw
  */
-void o_cue_draw_lowlevel(GSCHEM_TOPLEVEL *w_current, OBJECT *object, int whichone)
+static void o_cue_draw_cues (GSCHEM_TOPLEVEL *w_current, GArray *cues)
 {
-  int x, y;
-  GList *cl_current;
-  CONN *conn;
-  int type, count = 0;
-  int done = FALSE;
-  int size;
-  int bus_involved = FALSE;
-
-  g_return_if_fail (whichone == 0 || whichone == 1);
-  
-  x = object->line->x[whichone];
-  y = object->line->y[whichone];
-
-  type = CONN_ENDPOINT;
-
-  if (object->type == OBJ_BUS ||
-       (object->type == OBJ_PIN && object->pin_type == PIN_TYPE_BUS))
-    bus_involved = TRUE;
-
-  cl_current = object->conn_list;
-  while (cl_current != NULL && !done) {
-    conn = (CONN *) cl_current->data;
-   
-    if (conn->x == x && conn->y == y) {
-
-      if (conn->other_object &&
-           (conn->other_object->type == OBJ_BUS ||
-             (conn->other_object->type == OBJ_PIN &&
-              conn->other_object->pin_type == PIN_TYPE_BUS)))
-        bus_involved=TRUE;
-
-      switch(conn->type) {
-        
-        case(CONN_ENDPOINT):
-          count++;
-          break;
-
-        case(CONN_MIDPOINT):
-          type = CONN_MIDPOINT;
-          done = TRUE;
-          count = 0;
-          break;
-      }
+  guint i;
+
+  /* Skip cues too small to make out at this zoom */
+  if (SCREENabs (w_current, JUNCTION_CUE_SIZE_NET) <
+      w_current->cue_lod_threshold)
+    return;
+
+  for (i = 0; i < cues->len; i++) {
+    CUE *cue = &g_array_index (cues, CUE, i);
+
+    if (cue->type == CUE_UNCONNECTED) {
+      gschem_cairo_center_box (w_current, -1, -1, cue->x, cue->y,
+                               CUE_BOX_SIZE, CUE_BOX_SIZE);
+      o_cue_set_color (w_current, NET_ENDPOINT_COLOR);
+      cairo_fill (w_current->cr);
+    } else {
+      draw_junction_cue (w_current, cue->x, cue->y, cue->bus_involved);
     }
-
-    cl_current = g_list_next(cl_current);
   }
-
-#if DEBUG
-  printf("type: %d count: %d\n", type, count);
-#endif
-
-  switch(type) {
-
-    case(CONN_ENDPOINT):
-      if (object->type == OBJ_NET || object->type == OBJ_PIN) {
-        if (count < 1) { /* Didn't find anything connected there */
-          size = CUE_BOX_SIZE;
-          gschem_cairo_center_box (w_current, -1, -1, x, y, size, size);
-          o_cue_set_color (w_current, NET_ENDPOINT_COLOR);
-          cairo_fill (w_current->cr);
-        } else if (count >= 2) {
-          draw_junction_cue (w_current, x, y, bus_involved);
-        }
-      }
-      break;
-
-    case(CONN_MIDPOINT):
-      draw_junction_cue (w_current, x, y, bus_involved);
-      break;
-
-      /* here is where you draw bus rippers */
-      
-  }
-  
 }
 
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Redraw the cues of a list of objects
+ *
  *  \par Function Description
+ *  Draws the cues of the nets, buses and pins in \a list, including
+ *  the pins inside components, and the grips of selected nets, buses
+ *  and pins.  The cues come from the page's cue cache, so they are
+ *  only worked out again for objects whose connections changed.
  *
+ *  \param [in] w_current      The GSCHEM_TOPLEVEL object
+ *  \param [in] list           The OBJECTs to draw cues for
+ *  \param [in] draw_selected  Whether to draw selected objects' cues
  */
-void o_cue_draw_lowlevel_midpoints(GSCHEM_TOPLEVEL *w_current, OBJECT *object)
+void o_cue_redraw_all (GSCHEM_TOPLEVEL *w_current, GList *list, gboolean draw_selected)
 {
+  OBJECT *o_current;
   GList *iter;
-  int bus_involved;
+  GArray *cues;
+
+  cues = g_array_new (FALSE, FALSE, sizeof (CUE));
+
+  for (iter = list; iter != NULL; iter = g_list_next (iter)) {
+    o_current = (OBJECT *)iter->data;
 
-  for (iter = object->conn_list; iter != NULL; iter = g_list_next (iter)) {
-    CONN *conn = iter->data;
+    if (o_current->dont_redraw ||
+        (o_current->selected && !draw_selected))
+      continue;
 
-    if (conn->type == CONN_MIDPOINT) {
-      bus_involved = (object->type == OBJ_BUS ||
-                       (conn->other_object &&
-                        conn->other_object->type == OBJ_BUS));
-      draw_junction_cue (w_current, conn->x, conn->y, bus_involved);
+    switch(o_current->type) {
+      case(OBJ_NET):
+      case(OBJ_BUS):
+      case(OBJ_PIN):
+        if (o_current->selected && w_current->draw_grips) {
+          o_line_draw_grips (w_current, o_current);
+        }
+        /* fall through */
+
+      case(OBJ_COMPLEX):
+      case(OBJ_PLACEHOLDER):
+        s_cue_append_cues (w_current->toplevel, o_current, cues);
+        break;
     }
   }
+
+  o_cue_draw_cues (w_current, cues);
+  g_array_free (cues, TRUE);
 }
 
 
@@ -239,35 +171,14 @@ void o_cue_draw_lowlevel_midpoints(GSCHEM_TOPLEVEL *w_current, OBJECT *object)
  */
 void o_cue_draw_single(GSCHEM_TOPLEVEL *w_current, OBJECT *object)
 {
+  GArray *cues;
+
   g_return_if_fail (object != NULL);
 
-  switch (object->type) {
-    case(OBJ_NET):
-      /*
-       * o_cue_draw_lowlevel handles both endpoints and junctions.
-       * The intention of the check is to skip drawing endpoint cues on nets
-       * that are not "fully connected".
-       * Junctions will be drawn correctly, as:
-       *  - net-net junctions are handled by o_cue_draw_lowlevel_midpoints
-       *  - net-pin and pin-pin junctions are handled by case OBJ_PIN below
-       */
-      if (!o_net_is_fully_connected (w_current->toplevel, object)) {
-        o_cue_draw_lowlevel (w_current, object, 0);
-        o_cue_draw_lowlevel (w_current, object, 1);
-      }
-      o_cue_draw_lowlevel_midpoints (w_current, object);
-      break;
-    case(OBJ_BUS):
-      o_cue_draw_lowlevel (w_current, object, 0);
-      o_cue_draw_lowlevel (w_current, object, 1);
-      o_cue_draw_lowlevel_midpoints (w_current, object);
-      break;
-    case(OBJ_PIN):
-      o_cue_draw_lowlevel (w_current, object, object->whichend);
-      break;
-    default:
-      return;
-  }
+  cues = g_array_new (FALSE, FALSE, sizeof (CUE));
+  s_cue_append_cues (w_current->toplevel, object, cues);
+  o_cue_draw_cues (w_current, cues);
+  g_array_free (cues, TRUE);
 }
 
 
@@ -117,6 +117,9 @@ find_single_object (GSCHEM_TOPLEVEL *w_current, OBJECT *object,
  *  found, so multiple find operations at the same point will cycle
  *  through any objects on top of each other at this location.
  *
+ *  Only the objects near the point, as given by the page's spatial
+ *  index, are tested.
+ *
  *  \param [in] w_current         The GSCHEM_TOPLEVEL object.
  *  \param [in] w_x               The X coordinate to test (in world coords).
  *  \param [in] w_y               The Y coordinate to test (in world coords).
@@ -128,44 +131,46 @@ gboolean o_find_object (GSCHEM_TOPLEVEL *w_current, int w_x, int w_y,
                         gboolean change_selection)
 {
   TOPLEVEL *toplevel = w_current->toplevel;
+  OBJECT *lastplace = toplevel->page_current->object_lastplace;
+  OBJECT *found = NULL;
   int w_slack;
-  const GList *iter = NULL;
+  GList *candidates;
+  GList *hits = NULL;
+  GList *iter;
 
   w_slack = WORLDabs (w_current, w_current->select_slack_pixels);
 
-  /* Decide whether to iterate over all object or start at the last
-     found object. If there is more than one object below the
-     (w_x/w_y) position, this will select the next object below the
-     position point. You can change the selected object by clicking
-     at the same place multiple times. */
-  if (toplevel->page_current->object_lastplace != NULL) {
-    /* NB: g_list_find doesn't declare its input const, so we cast */
-    iter = g_list_find ((GList *)s_page_objects (toplevel->page_current),
-                        toplevel->page_current->object_lastplace);
-    iter = g_list_next (iter);
-  }
+  /* The objects whose bounds, grown by the slack, contain the point,
+   * in the order they are on the page */
+  candidates = s_page_objects_in_region (toplevel, toplevel->page_current,
+                                         w_x - w_slack, w_y - w_slack,
+                                         w_x + w_slack, w_y + w_slack);
 
-  /* do first search (if we found any objects after the last found object) */
-  while (iter != NULL) {
+  for (iter = candidates; iter != NULL; iter = g_list_next (iter)) {
     OBJECT *o_current = iter->data;
-    if (find_single_object (w_current, o_current,
-                            w_x, w_y, w_slack, change_selection)) {
-      return TRUE;
-    }
-    iter = g_list_next (iter);
+
+    if (is_object_hit (w_current, o_current, w_x, w_y, w_slack))
+      hits = g_list_prepend (hits, o_current);
   }
+  hits = g_list_reverse (hits);
+  g_list_free (candidates);
+
+  /* If there is more than one object below the (w_x/w_y) position,
+     take the one after the last found object. You can change the
+     selected object by clicking at the same place multiple times. */
+  if (hits != NULL) {
+    iter = g_list_find (hits, lastplace);
+    if (iter != NULL && g_list_next (iter) != NULL)
+      found = g_list_next (iter)->data;
+    else
+      found = hits->data;
+  }
+  g_list_free (hits);
 
-  /* now search from the beginning up until the object_lastplace */
-  for (iter = s_page_objects (toplevel->page_current);
-       iter != NULL; iter = g_list_next (iter)) {
-    OBJECT *o_current = iter->data;
-    if (find_single_object (w_current, o_current,
-                            w_x, w_y, w_slack, change_selection)) {
-      return TRUE;
-    }
-    /* break once we've inspected up to where we started the first loop */
-    if (o_current == toplevel->page_current->object_lastplace)
-      break;
+  if (found != NULL) {
+    find_single_object (w_current, found, w_x, w_y, w_slack,
+                        change_selection);
+    return TRUE;
   }
 
   /* didn't find anything.... reset lastplace */
@@ -117,9 +117,11 @@ void o_lock(GSCHEM_TOPLEVEL *w_current)
     if (object) {
       /* check to see if locked_color is already being used */
       if (object->locked_color == -1) {
+        o_emit_pre_change_notify (w_current->toplevel, object);
         object->selectable = FALSE;
         object->locked_color = object->color;
         object->color = LOCK_COLOR;
+        o_emit_change_notify (w_current->toplevel, object);
         w_current->toplevel->page_current->CHANGED=1;
       } else {
         s_log_message(_("Object already locked\n"));
@@ -155,9 +157,11 @@ void o_unlock(GSCHEM_TOPLEVEL *w_current)
     if (object) {
       /* only unlock if the object is locked */
       if (object->selectable == FALSE) {
+        o_emit_pre_change_notify (w_current->toplevel, object);
         object->selectable = TRUE;
         object->color = object->locked_color;
         object->locked_color = -1;
+        o_emit_change_notify (w_current->toplevel, object);
         w_current->toplevel->page_current->CHANGED = 1;
       } else {
         s_log_message(_("Object already unlocked\n"));
@@ -323,6 +327,10 @@ void o_edit_show_hidden_lowlevel (GSCHEM_TOPLEVEL *w_current,
  */
 void o_edit_show_hidden (GSCHEM_TOPLEVEL *w_current, const GList *o_list)
 {
+  TOPLEVEL *toplevel = w_current->toplevel;
+  const GList *iter;
+  PAGE *page;
+
   /* this function just shows the hidden text, but doesn't toggle it */
   /* this function does not change the CHANGED bit, no real changes are */
   /* made to the schematic */
@@ -333,6 +341,17 @@ void o_edit_show_hidden (GSCHEM_TOPLEVEL *w_current, const GList *o_list)
   i_show_state(w_current, NULL); /* update screen status */
 
   o_edit_show_hidden_lowlevel(w_current, o_list);
+
+  /* The spatial index of the other open pages only sees hidden text
+   * appear or go away once its bounds are recalculated too */
+  for (iter = geda_list_get_glist (toplevel->pages);
+       iter != NULL; iter = g_list_next (iter)) {
+    page = (PAGE *) iter->data;
+    if (page != toplevel->page_current) {
+      o_edit_show_hidden_lowlevel (w_current, s_page_objects (page));
+    }
+  }
+
   o_invalidate_all (w_current);
 
   if (w_current->toplevel->show_hidden_text) {
@@ -640,6 +659,31 @@ o_update_component (GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
   return o_new;
 }
 
+/*! \brief Wait for the autosave backup of a page to be written.
+ *  \par Function Description
+ *  Autosave backups are written in the background.  s_page_delete()
+ *  deletes the backup of the page, so it must only be called once
+ *  any queued write of the backup is done; otherwise the write would
+ *  create the backup again after the page is closed.
+ *
+ *  \param [in] page  The PAGE about to be deleted.
+ */
+void o_autosave_wait (PAGE *page)
+{
+  gchar *real_filename;
+  gchar *backup_filename;
+
+  real_filename = follow_symlinks (page->page_filename, NULL);
+  if (real_filename == NULL)
+    return;
+
+  backup_filename = f_get_autosave_filename (real_filename);
+  o_undo_wait_for_file (backup_filename);
+
+  g_free (backup_filename);
+  g_free (real_filename);
+}
+
 /*! \brief Do autosave on all pages that are marked.
  *  \par Function Description
  *  Looks for pages with the do_autosave_backup flag activated and
@@ -654,7 +698,6 @@ void o_autosave_backups(GSCHEM_TOPLEVEL *w_current)
   PAGE *p_save, *p_current;
   gchar *backup_filename;
   gchar *real_filename;
-  gchar *only_filename;
   gchar *dirname;
   mode_t saved_umask;
   mode_t mask;
@@ -684,10 +727,9 @@ void o_autosave_backups(GSCHEM_TOPLEVEL *w_current)
       } else {
         /* Get the directory in which the real filename lives */
         dirname = g_path_get_dirname (real_filename);
-        only_filename = g_path_get_basename(real_filename);
 
-        backup_filename = g_strdup_printf("%s%c"AUTOSAVE_BACKUP_FILENAME_STRING,
-                                          dirname, G_DIR_SEPARATOR, only_filename);
+        /* Named as o_autosave_wait() and s_page_delete() expect */
+        backup_filename = f_get_autosave_filename (real_filename);
 
         /* If there is not an existing file with that name, compute the
          * permissions and uid/gid that we will use for the newly-created file.
@@ -715,7 +757,6 @@ void o_autosave_backups(GSCHEM_TOPLEVEL *w_current)
 #endif
           }
         g_free (dirname);
-        g_free (only_filename);
         g_free (real_filename);
 
         /* Make the backup file writable before saving a new one */
@@ -730,28 +771,24 @@ void o_autosave_backups(GSCHEM_TOPLEVEL *w_current)
           umask(saved_umask);
         }
 
-        if (o_save (toplevel,
-                    s_page_objects (toplevel->page_current),
-                    backup_filename, NULL)) {
+        /* Make the backup file readonly so a 'rm *' command will ask
+           the user before deleting it */
+        saved_umask = umask(0);
+        mask = (S_IWRITE|S_IWGRP|S_IEXEC|S_IXGRP|S_IXOTH);
+        mask = (~mask)&0777;
+        mask &= ((~saved_umask) & 0777);
+        umask(saved_umask);
 
-          p_current->ops_since_last_backup = 0;
-                p_current->do_autosave_backup = 0;
+        /* The file is written in the background, which reports any
+         * failure to the log */
+        o_undo_write_file (backup_filename,
+                           o_save_buffer (toplevel,
+                                          s_page_objects (toplevel->page_current)),
+                           mask);
+
+        p_current->ops_since_last_backup = 0;
+        p_current->do_autosave_backup = 0;
 
-          /* Make the backup file readonly so a 'rm *' command will ask
-             the user before deleting it */
-          saved_umask = umask(0);
-          mask = (S_IWRITE|S_IWGRP|S_IEXEC|S_IXGRP|S_IXOTH);
-          mask = (~mask)&0777;
-          mask &= ((~saved_umask) & 0777);
-          if (chmod(backup_filename,mask) != 0) {
-            s_log_message (_("Could NOT set backup file [%s] readonly\n"),
-                           backup_filename);
-          }
-          umask(saved_umask);
-        } else {
-          s_log_message (_("Could NOT save backup file [%s]\n"),
-                         backup_filename);
-        }
         g_free (backup_filename);
       }
     }
@@ -185,6 +185,7 @@ void o_move_end(GSCHEM_TOPLEVEL *w_current)
 
         /* this next section of code is from */
         /* o_complex_world_translate_world */
+        o_complex_unshare (toplevel, object);
         object->complex->x = object->complex->x + diff_x;
         object->complex->y = object->complex->y + diff_y;
 
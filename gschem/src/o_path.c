@@ -342,6 +342,9 @@ void o_path_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
 
   if((pitch1 <= 0) || (pitch2 <= 0)) {
     fill_func = o_path_fill_fill;
+  } else if (o_fill_too_dense (w_current, o_current->fill_type,
+                               pitch1, pitch2)) {
+    fill_func = o_path_fill_hollow;
   }
 
   (*fill_func) (w_current, o_drawing_color (w_current, o_current),
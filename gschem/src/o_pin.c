@@ -60,8 +60,8 @@ void o_pin_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
                                  o_drawing_color (w_current, o_current));
   gschem_cairo_stroke (w_current, TYPE_SOLID, end, size, -1, -1);
 
-  /* draw the cue directly */
-  o_cue_draw_lowlevel(w_current, o_current, o_current->whichend);
+  /* The cue at the pin's end is left to o_cue_redraw_all(), which
+   * skips cues below the cue-lod-threshold */
 
 #if DEBUG
   printf("drawing pin\n");
@@ -285,51 +285,122 @@ void o_select_box_draw_rubber (GSCHEM_TOPLEVEL *w_current)
   gschem_cairo_stroke (w_current, TYPE_SOLID, END_NONE, 0, -1, -1);
 }
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Select the objects inside the selection box
  *  \par Function Description
+ *  Finds the visible objects lying entirely inside the selection box
+ *  through the page's spatial index, and selects them as one set with
+ *  o_select_object_list().
  *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
  */
 void o_select_box_search(GSCHEM_TOPLEVEL *w_current)
 {
   TOPLEVEL *toplevel = w_current->toplevel;
-  OBJECT *o_current=NULL;
-  int count = 0; /* object count */
-  int SHIFTKEY = w_current->SHIFTKEY;
-  int CONTROLKEY = w_current->CONTROLKEY;
   int left, right, top, bottom;
-  const GList *iter;
-	
+  GList *found;
+  GList *iter, *next;
+
   left = min(w_current->first_wx, w_current->second_wx);
   right = max(w_current->first_wx, w_current->second_wx);
   top = min(w_current->first_wy, w_current->second_wy);
   bottom = max(w_current->first_wy, w_current->second_wy);
 
-  iter = s_page_objects (toplevel->page_current);
-  while (iter != NULL) {
-    o_current = iter->data;
-    /* only select visible objects */
-    if (o_is_visible (toplevel, o_current) || toplevel->show_hidden_text) {
+  found = s_page_objects_inside_region (toplevel, toplevel->page_current,
+                                        left, top, right, bottom);
+
+  /* only select visible objects */
+  for (iter = found; iter != NULL; iter = next) {
+    OBJECT *o_current = iter->data;
+
+    next = g_list_next (iter);
+    if (!o_is_visible (toplevel, o_current) && !toplevel->show_hidden_text)
+      found = g_list_delete_link (found, iter);
+  }
+
+  /* if there were no objects to be found in select box, this still */
+  /* deselects anything remaining (except when the shift or control */
+  /* keys are pressed) */
+  o_select_object_list (w_current, found);
+  g_list_free (found);
+
+  i_update_menus(w_current);
+}
+
+/*! \brief Select a set of objects at once
+ *  \par Function Description
+ *  Selects \a objects the way a selection box does.  Without SHIFT or
+ *  CONTROL the selection is replaced by \a objects.  With SHIFT they
+ *  are added to it.  With CONTROL alone, each object's selection is
+ *  inverted.  Invisible attributes follow their objects.
+ *
+ *  Unlike calling o_select_object() for each object, the select and
+ *  deselect hooks are each run once with the whole set, and the
+ *  selection list only signals one change for each.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] objects    GList of OBJECTs to select.
+ */
+void o_select_object_list (GSCHEM_TOPLEVEL *w_current, GList *objects)
+{
+  TOPLEVEL *toplevel = w_current->toplevel;
+  SELECTION *selection = toplevel->page_current->selection_list;
+  int SHIFTKEY = w_current->SHIFTKEY;
+  int CONTROLKEY = w_current->CONTROLKEY;
+  GList *added = NULL, *removed = NULL;
+  GList *added_attribs = NULL, *removed_attribs = NULL;
+  GList *iter, *a_iter;
+
+  if (!SHIFTKEY && !CONTROLKEY) {
+    o_select_unselect_all (w_current);
+  }
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *o_current = iter->data;
+    gboolean removing_obj = (o_current->selected && CONTROLKEY && !SHIFTKEY);
+
+    if (removing_obj) {
+      removed = g_list_prepend (removed, o_current);
+    } else if (!o_current->selected) {
+      added = g_list_prepend (added, o_current);
+    }
+
+    /* Only invisible attributes follow the object; visible ones are
+     * picked by the box on their own, else they would be "double
+     * selected" when inverting the selection.  See
+     * o_attrib_select_invisible(). */
+    if (toplevel->show_hidden_text)
+      continue;
+
+    for (a_iter = o_current->attribs; a_iter != NULL;
+         a_iter = g_list_next (a_iter)) {
+      OBJECT *a_current = a_iter->data;
 
-      if ( o_current->w_left   >= left &&
-           o_current->w_right  <= right  &&
-           o_current->w_top    >= top  &&
-           o_current->w_bottom <= bottom ) {
+      if (o_is_visible (toplevel, a_current))
+        continue;
 
-        o_select_object(w_current, o_current, MULTIPLE, count);
-        count++;
+      if (removing_obj && a_current->selected) {
+        removed_attribs = g_list_prepend (removed_attribs, a_current);
+      } else if (!removing_obj && !a_current->selected) {
+        added_attribs = g_list_prepend (added_attribs, a_current);
       }
     }
-    iter = g_list_next (iter);
   }
 
-  /* if there were no objects to be found in select box, count will be */
-  /* zero, and you need to deselect anything remaining (except when the */
-  /* shift or control keys are pressed) */
-  if (count == 0 && !SHIFTKEY && !CONTROLKEY) {
-    o_select_unselect_all (w_current);
+  if (removed != NULL) {
+    removed = g_list_reverse (removed);
+    g_run_hook_object_list (w_current, "%deselect-objects-hook", removed);
+    removed = g_list_concat (removed, removed_attribs);
+    o_selection_remove_list (toplevel, selection, removed);
+    g_list_free (removed);
   }
-  i_update_menus(w_current);
+
+  if (added != NULL) {
+    added = g_list_reverse (added);
+    g_run_hook_object_list (w_current, "%select-objects-hook", added);
+  }
+  added = g_list_concat (added, g_list_reverse (added_attribs));
+  o_selection_add_list (toplevel, selection, added);
+  g_list_free (added);
 }
 
 /*! \brief Select all nets connected to the current net
@@ -463,17 +534,15 @@ void o_select_unselect_all(GSCHEM_TOPLEVEL *w_current)
   TOPLEVEL *toplevel = w_current->toplevel;
   SELECTION *selection = toplevel->page_current->selection_list;
   GList *removed = NULL;
-  GList *iter;
 
   removed = g_list_copy (geda_list_get_glist (selection));
-  for (iter = removed; iter != NULL; iter = g_list_next (iter)) {
-    o_selection_remove (toplevel, selection, (OBJECT *) iter->data);
-  }
+  o_selection_remove_list (toplevel, selection, removed);
 
   /* Call hooks */
   if (removed != NULL) {
     g_run_hook_object_list (w_current, "%deselect-objects-hook", removed);
   }
+  g_list_free (removed);
 }
 
 /*! \brief Selects all visible objects on the current page.
@@ -490,7 +559,8 @@ o_select_visible_unlocked (GSCHEM_TOPLEVEL *w_current)
   TOPLEVEL *toplevel = w_current->toplevel;
   SELECTION *selection = toplevel->page_current->selection_list;
   const GList *iter;
-  GList *added;
+  GList *added = NULL;
+  GList *a_iter;
 
   o_select_unselect_all (w_current);
   for (iter = s_page_objects (toplevel->page_current);
@@ -511,12 +581,19 @@ o_select_visible_unlocked (GSCHEM_TOPLEVEL *w_current)
      * w_current->SHIFTKEY and w_current->CONTROLKEY, which may well
      * be set if this function is called via a keystroke
      * (e.g. Ctrl-A). */
-    o_selection_add (toplevel, selection, obj);
+    added = g_list_prepend (added, obj);
 
     /* Add any attributes of object to selection as well. */
-    o_attrib_add_selected (w_current, selection, obj);
+    for (a_iter = obj->attribs; a_iter != NULL; a_iter = g_list_next (a_iter))
+      added = g_list_prepend (added, a_iter->data);
   }
 
+  /* Select everything at once, so the selection list only signals
+   * one change */
+  added = g_list_reverse (added);
+  o_selection_add_list (toplevel, selection, added);
+  g_list_free (added);
+
   /* Run hooks for all items selected */
   added = geda_list_get_glist (selection);
   if (added != NULL) {
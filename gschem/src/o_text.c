@@ -213,6 +213,165 @@ static void expand_bounds (int *left, int *top, int *right, int *bottom,
 }
 
 
+/* Texts measured or laid out are kept until there are this many */
+#define TEXT_EXTENTS_CACHE_SIZE 65536
+#define TEXT_LAYOUT_CACHE_SIZE  4096
+
+/*! Text laid out with Pango, shared by every text object showing the
+ *  same string at the same size.  Alignment and angle are applied when
+ *  the text is placed, so they are not part of the layout. */
+typedef struct {
+  PangoLayout *layout;                  /* NULL if only measured */
+  PangoFontMetrics *font_metrics;
+  PangoRectangle inked_rect;
+  PangoRectangle logical_rect;
+} TEXT_LAYOUT;
+
+/*! Extents of texts at 1000dpi, i.e. in world units.  They do not
+ *  depend on the window, so all windows share them. */
+static GHashTable *text_extents = NULL;
+static PangoLayout *text_measure_layout = NULL;
+
+static gchar *text_layout_key (OBJECT *o_current)
+{
+  return g_strdup_printf ("%d %s", o_current->text->size,
+                          o_current->text->disp_string);
+}
+
+static void text_layout_free (gpointer data)
+{
+  TEXT_LAYOUT *text = data;
+
+  if (text->layout != NULL)
+    g_object_unref (text->layout);
+  pango_font_metrics_unref (text->font_metrics);
+  g_free (text);
+}
+
+/*! \brief Lay out a text in a Pango layout and measure it.
+ *  \param [in] w_current     The GSCHEM_TOPLEVEL object.
+ *  \param [in] layout        The layout to use.
+ *  \param [in] scale_factor  Pixels per world unit.
+ *  \param [in] o_current     The text OBJECT.
+ *  \param [in] keep_layout   Whether to keep a reference to \a layout.
+ *  \return The new TEXT_LAYOUT.
+ */
+static TEXT_LAYOUT *text_layout_new (GSCHEM_TOPLEVEL *w_current,
+                                     PangoLayout *layout, double scale_factor,
+                                     OBJECT *o_current, gboolean keep_layout)
+{
+  TEXT_LAYOUT *text = g_new (TEXT_LAYOUT, 1);
+
+  text->font_metrics =
+    setup_pango_return_metrics (w_current, layout, scale_factor, o_current);
+  pango_layout_get_pixel_extents (layout, &text->inked_rect,
+                                  &text->logical_rect);
+  text->layout = keep_layout ? g_object_ref (layout) : NULL;
+
+  return text;
+}
+
+/*! \brief Get the extents of a text in world units.
+ *  \par Function Description
+ *  Looks up the extents of the string and size of \a o_current,
+ *  measuring them the first time they are asked for.
+ */
+static TEXT_LAYOUT *o_text_get_extents (GSCHEM_TOPLEVEL *w_current,
+                                        OBJECT *o_current)
+{
+  TEXT_LAYOUT *text;
+  gchar *key;
+
+  if (text_extents == NULL) {
+    text_extents = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free, text_layout_free);
+  } else if (g_hash_table_size (text_extents) >= TEXT_EXTENTS_CACHE_SIZE) {
+    g_hash_table_remove_all (text_extents);
+  }
+
+  key = text_layout_key (o_current);
+  text = g_hash_table_lookup (text_extents, key);
+  if (text != NULL) {
+    g_free (key);
+    return text;
+  }
+
+  /* Metric hinting is off, so the surface measured on does not matter */
+  if (text_measure_layout == NULL) {
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+    cr = cairo_create (surface);
+    text_measure_layout = pango_cairo_create_layout (cr);
+    cairo_destroy (cr);
+    cairo_surface_destroy (surface);
+  }
+
+  text = text_layout_new (w_current, text_measure_layout, 1.,
+                          o_current, FALSE);
+  g_hash_table_insert (text_extents, key, text);
+
+  return text;
+}
+
+/*! \brief Get a text laid out for drawing at the current zoom.
+ *  \par Function Description
+ *  Looks up the layout for the string and size of \a o_current in
+ *  the layouts kept by \a w_current, laying it out the first time it
+ *  is drawn.  The layouts are dropped whenever the zoom changes.
+ */
+static TEXT_LAYOUT *o_text_get_layout (GSCHEM_TOPLEVEL *w_current,
+                                       OBJECT *o_current)
+{
+  double scale = w_current->toplevel->page_current->to_screen_x_constant;
+  PangoLayout *layout;
+  TEXT_LAYOUT *text;
+  gchar *key;
+
+  if (w_current->text_layouts != NULL &&
+      (w_current->text_layouts_scale != scale ||
+       g_hash_table_size (w_current->text_layouts) >= TEXT_LAYOUT_CACHE_SIZE)) {
+    o_text_layout_cache_flush (w_current);
+  }
+
+  if (w_current->text_layouts == NULL) {
+    w_current->text_layouts =
+      g_hash_table_new_full (g_str_hash, g_str_equal,
+                             g_free, text_layout_free);
+    w_current->text_layouts_scale = scale;
+  }
+
+  key = text_layout_key (o_current);
+  text = g_hash_table_lookup (w_current->text_layouts, key);
+  if (text != NULL) {
+    g_free (key);
+    return text;
+  }
+
+  layout = pango_cairo_create_layout (w_current->cr);
+  text = text_layout_new (w_current, layout, scale, o_current, TRUE);
+  g_object_unref (layout);
+  g_hash_table_insert (w_current->text_layouts, key, text);
+
+  return text;
+}
+
+/*! \brief Forget the text laid out for drawing.
+ *  \par Function Description
+ *  Drops the layouts kept by \a w_current.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ */
+void o_text_layout_cache_flush (GSCHEM_TOPLEVEL *w_current)
+{
+  if (w_current->text_layouts != NULL) {
+    g_hash_table_destroy (w_current->text_layouts);
+    w_current->text_layouts = NULL;
+  }
+}
+
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -224,11 +383,8 @@ int o_text_get_rendered_bounds (void *user_data, OBJECT *o_current,
 {
   GSCHEM_TOPLEVEL *w_current = user_data;
   TOPLEVEL *toplevel = w_current->toplevel;
-  PangoLayout *layout;
-  cairo_t *cr;
+  TEXT_LAYOUT *text;
   double x, y;
-  PangoFontMetrics *font_metrics;
-  PangoRectangle logical_rect;
   PangoRectangle inked_rect;
   int angle;
   double rx, ry;
@@ -245,14 +401,10 @@ int o_text_get_rendered_bounds (void *user_data, OBJECT *o_current,
   if (o_current->text->disp_string == NULL)
     return FALSE;
 
-  cr = gdk_cairo_create (w_current->drawable);
-  layout = pango_cairo_create_layout (cr);
-
-  font_metrics = setup_pango_return_metrics (w_current, layout, 1., o_current);
-
-  pango_layout_get_pixel_extents (layout, &inked_rect, &logical_rect);
-  calculate_position (o_current, font_metrics, logical_rect, inked_rect, &x, &y);
-  pango_font_metrics_unref (font_metrics);
+  text = o_text_get_extents (w_current, o_current);
+  inked_rect = text->inked_rect;
+  calculate_position (o_current, text->font_metrics,
+                      text->logical_rect, inked_rect, &x, &y);
 
   tleft = x + inked_rect.x;
   tright = x + inked_rect.x + inked_rect.width;
@@ -284,9 +436,6 @@ int o_text_get_rendered_bounds (void *user_data, OBJECT *o_current,
   *min_y = o_current->text->y + top;
   *max_y = o_current->text->y + bottom;
 
-  g_object_unref (layout);
-  cairo_destroy (cr);
-
   return TRUE;
 }
 
@@ -374,11 +523,9 @@ static void o_text_draw_lowlevel(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current,
 {
   TOPLEVEL *toplevel = w_current->toplevel;
   cairo_t *cr = w_current->cr;
+  TEXT_LAYOUT *text;
   int sx, sy;
   double x, y;
-  PangoFontMetrics *font_metrics;
-  PangoRectangle logical_rect;
-  PangoRectangle inked_rect;
 
   g_return_if_fail (o_current != NULL);
   g_return_if_fail (o_current->text != NULL);
@@ -390,13 +537,9 @@ static void o_text_draw_lowlevel(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current,
   if (o_current->text->disp_string == NULL)
     return;
 
-  font_metrics =
-    setup_pango_return_metrics (w_current, w_current->pl,
-                                toplevel->page_current->to_screen_x_constant,
-                                o_current);
-
-  pango_layout_get_pixel_extents (w_current->pl, &inked_rect, &logical_rect);
-  calculate_position (o_current, font_metrics, logical_rect, inked_rect, &x, &y);
+  text = o_text_get_layout (w_current, o_current);
+  calculate_position (o_current, text->font_metrics,
+                      text->logical_rect, text->inked_rect, &x, &y);
 
   cairo_save (cr);
 
@@ -416,17 +559,43 @@ static void o_text_draw_lowlevel(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current,
    *     the grid lines, and ensures consistency with other lines when the
    *     page view is zoomed out. */
   cairo_move_to (cr, x + 0.5, y + 0.5);
-  gschem_pango_show_layout (cr, w_current->pl);
+  gschem_pango_show_layout (cr, text->layout);
 
 #ifdef DEBUG_TEXT
-  draw_construction_lines (w_current, x, y, font_metrics, logical_rect);
+  draw_construction_lines (w_current, x, y, text->font_metrics,
+                           text->logical_rect);
 #endif
 
-  pango_font_metrics_unref (font_metrics);
   cairo_restore (cr);
 }
 
 
+/*! \brief Check if text is too small on the screen to be laid out.
+ *  \par Function Description
+ *  Text shorter than the text level of detail threshold is drawn as
+ *  its bounding box, since laying it out with Pango costs far more
+ *  than the few pixels it covers are worth.
+ *
+ *  \param [in] w_current  The GSCHEM_TOPLEVEL object.
+ *  \param [in] o_current  The text OBJECT.
+ *  \return TRUE if the text should be drawn as a box.
+ */
+static gboolean o_text_too_small (GSCHEM_TOPLEVEL *w_current,
+                                  OBJECT *o_current)
+{
+  double height;
+
+  if (w_current->text_lod_threshold <= 0)
+    return FALSE;
+
+  /* Height of a line of text, in world units */
+  height = o_text_get_font_size_in_points (w_current->toplevel, o_current)
+           / 72.0 * 1000.0;
+
+  return (SCREENabs (w_current, (int) height) < w_current->text_lod_threshold);
+}
+
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -449,7 +618,8 @@ void o_text_draw(GSCHEM_TOPLEVEL *w_current, OBJECT *o_current)
     return;
   }
 
-  if (!w_current->fast_mousepan || !w_current->doing_pan) {
+  if ((!w_current->fast_mousepan || !w_current->doing_pan) &&
+      !o_text_too_small (w_current, o_current)) {
 
     o_text_draw_lowlevel (w_current, o_current, 0, 0,
                           o_drawing_color (w_current, o_current));
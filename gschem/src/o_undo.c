@@ -27,6 +27,8 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "gschem.h"
 
@@ -44,6 +46,228 @@ static char* tmp_path = NULL;
 /* of entries to free */
 #define UNDO_PADDING  5
 
+/* Checksums of the undo files written, by filename, so that a state
+ * identical to the one before it is not written again */
+static GHashTable *undo_checksums = NULL;
+
+/*! A file to be written by the writer thread. */
+typedef struct {
+  gchar *filename;    /* NULL to stop the writer */
+  gchar *buffer;      /* contents of the file */
+  mode_t mode;        /* permissions to give the file once written, or 0 */
+} UNDO_WRITE;
+
+/* Undo files and autosave backups are written on a thread of their
+ * own, so that a slow disk does not hold up editing.  Files queued but
+ * not yet written are counted in write_pending, by filename. */
+static GAsyncQueue *write_queue = NULL;
+static GThread *write_thread = NULL;
+static GMutex *write_mutex = NULL;
+static GCond *write_cond = NULL;
+static GHashTable *write_pending = NULL;
+
+/*! \brief Log a message from the writer thread. */
+static gboolean o_undo_write_log (gpointer data)
+{
+  s_log_message ("%s", (gchar *) data);
+  g_free (data);
+  return FALSE;
+}
+
+/*! \brief Write a queued file.
+ *  \par Function Description
+ *  Writes \a job out, on whatever thread calls it.  Failures are
+ *  logged from the main loop.
+ *
+ *  \param [in] job      The file to write.
+ *  \param [in] threaded TRUE if called from the writer thread.
+ */
+static void o_undo_write_now (UNDO_WRITE *job, gboolean threaded)
+{
+  GError *err = NULL;
+  gchar *message = NULL;
+
+  if (!g_file_set_contents (job->filename, job->buffer, -1, &err)) {
+    message = g_strdup_printf (_("Could NOT save file [%s]: %s\n"),
+                               job->filename, err->message);
+    g_error_free (err);
+  } else if (job->mode != 0 && chmod (job->filename, job->mode) != 0) {
+    message = g_strdup_printf (_("Could NOT set backup file [%s] readonly\n"),
+                               job->filename);
+  }
+
+  if (message != NULL) {
+    if (threaded) {
+      g_idle_add (o_undo_write_log, message);
+    } else {
+      o_undo_write_log (message);
+    }
+  }
+}
+
+/*! \brief The writer thread. */
+static gpointer o_undo_writer (gpointer data)
+{
+  UNDO_WRITE *job;
+  gpointer count;
+
+  for (;;) {
+    job = g_async_queue_pop (write_queue);
+    if (job->filename == NULL) {
+      g_free (job);
+      break;
+    }
+
+    o_undo_write_now (job, TRUE);
+
+    g_mutex_lock (write_mutex);
+    count = g_hash_table_lookup (write_pending, job->filename);
+    if (GPOINTER_TO_INT (count) > 1) {
+      g_hash_table_insert (write_pending, g_strdup (job->filename),
+                           GINT_TO_POINTER (GPOINTER_TO_INT (count) - 1));
+    } else {
+      g_hash_table_remove (write_pending, job->filename);
+    }
+    g_cond_broadcast (write_cond);
+    g_mutex_unlock (write_mutex);
+
+    g_free (job->filename);
+    g_free (job->buffer);
+    g_free (job);
+  }
+
+  return NULL;
+}
+
+/*! \brief Write a file in the background
+ *  \par Function Description
+ *  Queues \a buffer to be written to \a filename by the writer
+ *  thread, and returns at once.  The file is replaced as a whole once
+ *  written, so it never holds a partly written state.  Without thread
+ *  support, the file is written before returning.
+ *
+ *  \param [in] filename  The file to write.
+ *  \param [in] buffer    The contents to write; freed once written.
+ *  \param [in] mode      Permissions to set once written, or 0.
+ */
+void o_undo_write_file (const gchar *filename, gchar *buffer, int mode)
+{
+  UNDO_WRITE *job = g_new (UNDO_WRITE, 1);
+  gpointer count;
+
+  job->filename = g_strdup (filename);
+  job->buffer = buffer;
+  job->mode = mode;
+
+#ifdef HAVE_GTHREAD
+  if (write_thread == NULL && g_thread_supported ()) {
+    write_queue = g_async_queue_new ();
+    write_mutex = g_mutex_new ();
+    write_cond = g_cond_new ();
+    write_pending = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           g_free, NULL);
+    write_thread = g_thread_create (o_undo_writer, NULL, TRUE, NULL);
+  }
+#endif
+
+  if (write_thread == NULL) {
+    o_undo_write_now (job, FALSE);
+    g_free (job->filename);
+    g_free (job->buffer);
+    g_free (job);
+    return;
+  }
+
+  g_mutex_lock (write_mutex);
+  count = g_hash_table_lookup (write_pending, filename);
+  g_hash_table_insert (write_pending, g_strdup (filename),
+                       GINT_TO_POINTER (GPOINTER_TO_INT (count) + 1));
+  g_mutex_unlock (write_mutex);
+
+  g_async_queue_push (write_queue, job);
+}
+
+/*! \brief Wait until a file has been written
+ *  \par Function Description
+ *  Returns once every write of \a filename queued with
+ *  o_undo_write_file() has finished.
+ *
+ *  \param [in] filename  The file to wait for.
+ */
+void o_undo_wait_for_file (const gchar *filename)
+{
+  if (write_thread == NULL)
+    return;
+
+  g_mutex_lock (write_mutex);
+  while (g_hash_table_lookup (write_pending, filename) != NULL) {
+    g_cond_wait (write_cond, write_mutex);
+  }
+  g_mutex_unlock (write_mutex);
+}
+
+/*! \brief Wait until all queued files have been written. */
+void o_undo_wait_for_writes (void)
+{
+  if (write_thread == NULL)
+    return;
+
+  g_mutex_lock (write_mutex);
+  while (g_hash_table_size (write_pending) > 0) {
+    g_cond_wait (write_cond, write_mutex);
+  }
+  g_mutex_unlock (write_mutex);
+}
+
+/*! \brief Delete an undo file.
+ *  \par Function Description
+ *  Waits for any queued write of \a filename, which would otherwise
+ *  bring the file back, then deletes it and forgets its checksum.
+ *
+ *  \param [in] filename  The undo file to delete.
+ */
+static void o_undo_remove_file (const gchar *filename)
+{
+  o_undo_wait_for_file (filename);
+  unlink (filename);
+  if (undo_checksums != NULL) {
+    g_hash_table_remove (undo_checksums, filename);
+  }
+}
+
+/*! \brief Free undo steps, and delete their files.
+ *  \par Function Description
+ *  Deletes the files of \a head and the steps after it through
+ *  o_undo_remove_file(), then frees the steps with
+ *  s_undo_remove_rest().
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] head      The first undo step to free.
+ */
+static void o_undo_remove_rest (TOPLEVEL *toplevel, UNDO *head)
+{
+  UNDO *u_current;
+
+  for (u_current = head; u_current != NULL; u_current = u_current->next) {
+    if (u_current->filename != NULL) {
+      o_undo_remove_file (u_current->filename);
+      g_free (u_current->filename);
+      u_current->filename = NULL;
+    }
+  }
+
+  s_undo_remove_rest (toplevel, head);
+}
+
+/*! \brief Get the file holding the page contents of an undo step. */
+static char *o_undo_state_filename (UNDO *u_current)
+{
+  if (u_current->filename != NULL)
+    return u_current->filename;
+
+  return o_undo_find_prev_filename (u_current);
+}
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -78,6 +302,7 @@ void o_undo_savestate(GSCHEM_TOPLEVEL *w_current, int flag)
   TOPLEVEL *toplevel = w_current->toplevel;
   char *filename = NULL;
   GList *object_list = NULL;
+  GPtrArray *deltas = NULL;
   int levels;
   UNDO *u_current;
   UNDO *u_current_next;
@@ -108,30 +333,53 @@ void o_undo_savestate(GSCHEM_TOPLEVEL *w_current, int flag)
   }
 
   if (w_current->undo_type == UNDO_DISK && flag == UNDO_ALL) {
+    gchar *buffer;
+    gchar *checksum;
+    char *prev_filename = NULL;
+
+    /* f_save manages the creaton of backup copies, so it is only
+       called when saving a file, and not when saving an undo backup
+       copy.  The page is saved to a buffer here and written out in
+       the background. */
+    buffer = o_save_buffer (toplevel, s_page_objects (toplevel->page_current));
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_MD5, buffer, -1);
+
+    if (undo_checksums == NULL) {
+      undo_checksums = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                              g_free, g_free);
+    }
 
-    filename = g_strdup_printf("%s%cgschem.save%d_%d.sch",
-                               tmp_path, G_DIR_SEPARATOR,
-                               prog_pid, undo_file_index++);
+    if (toplevel->page_current->undo_current != NULL) {
+      prev_filename =
+        o_undo_state_filename (toplevel->page_current->undo_current);
+    }
 
-    /* Changed from f_save to o_save when adding backup copy creation. */
-    /* f_save manages the creaton of backup copies. 
-       This way, f_save is called only when saving a file, and not when
-       saving an undo backup copy */
-    o_save (toplevel, s_page_objects (toplevel->page_current), filename, NULL);
+    if (prev_filename != NULL &&
+        g_strcmp0 (g_hash_table_lookup (undo_checksums, prev_filename),
+                   checksum) == 0) {
+      /* Nothing changed: the step uses the file of the one before */
+      g_free (buffer);
+      g_free (checksum);
+    } else {
+      filename = g_strdup_printf("%s%cgschem.save%d_%d.sch",
+                                 tmp_path, G_DIR_SEPARATOR,
+                                 prog_pid, undo_file_index++);
+      g_hash_table_insert (undo_checksums, g_strdup (filename), checksum);
+      o_undo_write_file (filename, buffer, 0);
+    }
 
   } else if (w_current->undo_type == UNDO_MEMORY && flag == UNDO_ALL) {
-    object_list = o_glist_copy_all (toplevel,
-                                    s_page_objects (toplevel->page_current),
-                                    object_list);
+    /* Only keep what changed since the last undo step */
+    deltas = s_undo_diff_page (toplevel, toplevel->page_current);
   }
 
   /* Clear Anything above current */
   if (toplevel->page_current->undo_current) {
-    s_undo_remove_rest(toplevel,
+    o_undo_remove_rest(toplevel,
                        toplevel->page_current->undo_current->next);
     toplevel->page_current->undo_current->next = NULL;
   } else { /* undo current is NULL */
-    s_undo_remove_rest(toplevel,
+    o_undo_remove_rest(toplevel,
                        toplevel->page_current->undo_bottom);
     toplevel->page_current->undo_bottom = NULL;
   }
@@ -147,6 +395,7 @@ void o_undo_savestate(GSCHEM_TOPLEVEL *w_current, int flag)
              toplevel->page_current->bottom,
              toplevel->page_current->page_control,
              toplevel->page_current->up);
+  toplevel->page_current->undo_tos->deltas = deltas;
 
   toplevel->page_current->undo_current =
       toplevel->page_current->undo_tos;
@@ -197,22 +446,18 @@ void o_undo_savestate(GSCHEM_TOPLEVEL *w_current, int flag)
 
       u_current_next = u_current->next;
 
-      if (u_current->filename) {
+      if (u_current->filename && u_current_next->filename == NULL) {
+        /* The next step uses this file too, hand it over */
+        u_current_next->filename = u_current->filename;
+        u_current->filename = NULL;
+      } else if (u_current->filename) {
 #if DEBUG
         printf("Freeing: %s\n", u_current->filename);
 #endif
-        unlink(u_current->filename);
-        g_free(u_current->filename);
-      }
-
-      if (u_current->object_list) {
-        s_delete_object_glist (toplevel, u_current->object_list);
-        u_current->object_list = NULL;
+        o_undo_remove_file (u_current->filename);
       }
 
-      u_current->next = NULL;
-      u_current->prev = NULL;
-      g_free(u_current);
+      s_undo_remove (toplevel, u_current, u_current);
 
       u_current = u_current_next;
       levels--;
@@ -259,27 +504,6 @@ char *o_undo_find_prev_filename(UNDO *start)
   return(NULL); 
 }
 
-/*! \todo Finish function documentation!!!
- *  \brief
- *  \par Function Description
- *
- */
-GList *o_undo_find_prev_object_head (UNDO *start)
-{
-  UNDO *u_current;
-
-  u_current = start->prev;
-
-  while(u_current) {
-    if (u_current->object_list) {
-      return u_current->object_list;
-    }
-    u_current = u_current->prev;
-  }
-
-  return(NULL); 
-}
-
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -299,7 +523,7 @@ void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type)
   UNDO *save_tos;
   UNDO *save_current;
   int save_logging;
-  int find_prev_data=FALSE;
+  char *filename = NULL;
 
   char *save_filename;
 
@@ -324,17 +548,18 @@ void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type)
     return;
   }
 
-  if (u_next->type == UNDO_ALL && u_current->type == UNDO_VIEWPORT_ONLY) {
-#if DEBUG
-    printf("Type: %d\n", u_current->type);
-    printf("Current is an undo all, next is viewport only!\n");
-#endif
-    find_prev_data = TRUE;
+  if (w_current->undo_type == UNDO_DISK) {
+    /* Steps that only moved the viewport, or changed nothing, have no
+     * file of their own and use the one of the step before.  There is
+     * nothing to load if both steps use the same file. */
+    filename = o_undo_state_filename (u_current);
+    if (filename == o_undo_state_filename (u_next)) {
+      filename = NULL;
+    }
 
-    if (w_current->undo_type == UNDO_DISK) {
-      u_current->filename = o_undo_find_prev_filename(u_current);
-    } else {
-      u_current->object_list = o_undo_find_prev_object_head (u_current);
+    /* The file may still be being written */
+    if (filename != NULL) {
+      o_undo_wait_for_file (filename);
     }
   }
 
@@ -349,15 +574,11 @@ void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type)
   toplevel->page_current->undo_tos = NULL;
   toplevel->page_current->undo_current = NULL;
 
-  if (w_current->undo_type == UNDO_DISK && u_current->filename) {
-    PAGE *p_new;
-    s_page_delete (toplevel, toplevel->page_current);
-    p_new = s_page_new(toplevel, u_current->filename);
-    s_page_goto (toplevel, p_new);
-  } else if (w_current->undo_type == UNDO_MEMORY && u_current->object_list) {
+  if (w_current->undo_type == UNDO_DISK && filename) {
     PAGE *p_new;
+    o_autosave_wait (toplevel->page_current);
     s_page_delete (toplevel, toplevel->page_current);
-    p_new = s_page_new (toplevel, save_filename);
+    p_new = s_page_new(toplevel, filename);
     s_page_goto (toplevel, p_new);
   }
 
@@ -365,22 +586,26 @@ void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type)
   save_logging = do_logging;
   do_logging = FALSE;
 
-  if (w_current->undo_type == UNDO_DISK && u_current->filename) {
+  if (w_current->undo_type == UNDO_DISK && filename) {
 
-    f_open(toplevel, toplevel->page_current, u_current->filename, NULL);
+    f_open(toplevel, toplevel->page_current, filename, NULL);
 
     x_manual_resize(w_current);
     toplevel->page_current->page_control = u_current->page_control;
     toplevel->page_current->up = u_current->up;
     toplevel->page_current->CHANGED=1;
 
-  } else if (w_current->undo_type == UNDO_MEMORY && u_current->object_list) {
+  } else if (w_current->undo_type == UNDO_MEMORY) {
+    /* Undoing a step takes back its own changes, redoing one makes
+     * them again; steps that only moved the viewport have none */
+    GPtrArray *deltas = (type == UNDO_ACTION) ? u_next->deltas
+                                              : u_current->deltas;
 
-    s_page_delete_objects (toplevel, toplevel->page_current);
-
-    s_page_append_list (toplevel, toplevel->page_current,
-                        o_glist_copy_all (toplevel, u_current->object_list,
-                                          NULL));
+    if (deltas != NULL && deltas->len > 0) {
+      o_select_unselect_all (w_current);
+      s_undo_apply_deltas (toplevel, toplevel->page_current, deltas,
+                           type == UNDO_ACTION);
+    }
 
     x_manual_resize(w_current);
     toplevel->page_current->page_control = u_current->page_control;
@@ -435,13 +660,6 @@ void o_undo_callback(GSCHEM_TOPLEVEL *w_current, int type)
     }
   }
 
-  /* don't have to free data here since filename, object_list are */
-  /* just pointers to the real data (lower in the stack) */
-  if (find_prev_data) {
-    u_current->filename = NULL;
-    u_current->object_list = NULL;
-  }
-
 #if DEBUG
   printf("\n\n---Undo----\n");
   s_undo_print_all(toplevel->page_current->undo_bottom);
@@ -461,6 +679,23 @@ void o_undo_cleanup(void)
   int i;
   char *filename;
 
+  /* Let the writer finish, autosave backups included */
+  if (write_thread != NULL) {
+    o_undo_wait_for_writes ();
+    g_async_queue_push (write_queue, g_new0 (UNDO_WRITE, 1));
+    g_thread_join (write_thread);
+    write_thread = NULL;
+    g_async_queue_unref (write_queue);
+    g_mutex_free (write_mutex);
+    g_cond_free (write_cond);
+    g_hash_table_destroy (write_pending);
+  }
+
+  if (undo_checksums != NULL) {
+    g_hash_table_destroy (undo_checksums);
+    undo_checksums = NULL;
+  }
+
   for (i = 0 ; i < undo_file_index; i++) {
     filename = g_strdup_printf("%s%cgschem.save%d_%d.sch", tmp_path,
                                G_DIR_SEPARATOR, prog_pid, i);
@@ -485,6 +720,13 @@ void o_undo_remove_last_undo(GSCHEM_TOPLEVEL *w_current)
   }
 
   if (toplevel->page_current->undo_current) {
+    /* The page stays as the removed step left it: its deltas go into
+     * the next step, or what it recorded could not be undone */
+    if (toplevel->page_current->undo_current->prev != NULL) {
+      s_undo_carry_deltas (toplevel->page_current,
+                           toplevel->page_current->undo_current);
+    }
+
     toplevel->page_current->undo_current =
         toplevel->page_current->undo_current->prev;
     if (toplevel->page_current->undo_current == NULL) {
@@ -50,8 +50,6 @@ static int DOING_STROKE = FALSE;
 gint x_event_expose(GtkWidget *widget, GdkEventExpose *event,
                     GSCHEM_TOPLEVEL *w_current)
 {
-  GdkRectangle *rectangles;
-  int n_rectangles;
   cairo_t *save_cr;
   PangoLayout *save_pl;
 
@@ -67,9 +65,7 @@ gint x_event_expose(GtkWidget *widget, GdkEventExpose *event,
   w_current->cr = gdk_cairo_create( widget->window );
   w_current->pl = pango_cairo_create_layout (w_current->cr);
 
-  gdk_region_get_rectangles (event->region, &rectangles, &n_rectangles);
-  o_redraw_rects (w_current, rectangles, n_rectangles);
-  g_free (rectangles);
+  o_redraw_exposed (w_current, event->region);
 
   /* raise the dialog boxes if this feature is enabled */
   if (w_current->raise_dialog_boxes) {
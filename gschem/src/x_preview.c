@@ -506,6 +506,8 @@ preview_dispose (GObject *self)
     preview_w_current->drawing_area = NULL;
 
     x_window_free_gc (preview_w_current);
+    o_complex_glyph_cache_flush (preview_w_current);
+    o_text_layout_cache_flush (preview_w_current);
     
     s_toplevel_delete (preview_w_current->toplevel);
     g_free (preview_w_current);
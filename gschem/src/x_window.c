@@ -639,6 +639,17 @@ void x_window_close(GSCHEM_TOPLEVEL *w_current)
 
   x_window_free_gc(w_current);
 
+  if (w_current->backing != NULL) {
+    g_object_unref (w_current->backing);
+    w_current->backing = NULL;
+  }
+  if (w_current->backing_damage != NULL) {
+    gdk_region_destroy (w_current->backing_damage);
+    w_current->backing_damage = NULL;
+  }
+  o_complex_glyph_cache_flush (w_current);
+  o_text_layout_cache_flush (w_current);
+
   /* Clear Guile smob weak ref */
   if (w_current->smob != SCM_UNDEFINED) {
     SCM_SET_SMOB_DATA (w_current->smob, NULL);
@@ -860,6 +871,9 @@ x_window_save_page (GSCHEM_TOPLEVEL *w_current, PAGE *page, const gchar *filenam
 
   /* change to page */
   s_page_goto (toplevel, page);
+  /* an autosave backup still being written must not end up newer
+   * than the file */
+  o_undo_wait_for_writes ();
   /* and try saving current page to filename */
   ret = (gint)f_save (toplevel, toplevel->page_current, filename, &err);
   if (ret != 1) {
@@ -966,6 +980,7 @@ x_window_close_page (GSCHEM_TOPLEVEL *w_current, PAGE *page)
                  _("Discarding page [%s]\n") : _("Closing [%s]\n"),
                  page->page_filename);
   /* remove page from toplevel list of page and free */
+  o_autosave_wait (page);
   s_page_delete (toplevel, page);
 
   /* Switch to a different page if we just removed the current */
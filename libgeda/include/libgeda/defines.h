@@ -127,6 +127,10 @@
 #define CONN_ENDPOINT		1
 #define CONN_MIDPOINT		2
 
+/* The cue types */
+#define CUE_UNCONNECTED		0
+#define CUE_JUNCTION		1
+
 /* used by world_tiles to set the size of the array */
 #define MAX_TILES_X		10
 #define MAX_TILES_Y		10
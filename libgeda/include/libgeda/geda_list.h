@@ -53,7 +53,7 @@ GedaList *geda_list_new( void );
 void geda_list_add( GedaList *list, gpointer item );
 void geda_list_add_glist( GedaList *list, GList *items );
 void geda_list_remove( GedaList *list, gpointer item );
-/*void geda_list_remove_glist( GedaList *list, GList *items ); */ /* Undemanded as yet */
+void geda_list_remove_glist( GedaList *list, GList *items );
 void geda_list_remove_all( GedaList *list );
 
 /*const GList *geda_list_get_glist( GedaList *list ); */
@@ -113,6 +113,8 @@ PAGE *o_get_page (TOPLEVEL *toplevel, OBJECT *object);
 OBJECT *o_get_parent (TOPLEVEL *toplevel, OBJECT *object);
 void o_add_change_notify(TOPLEVEL *toplevel, ChangeNotifyFunc pre_change_func, ChangeNotifyFunc change_func, void *user_data);
 void o_remove_change_notify(TOPLEVEL *toplevel, ChangeNotifyFunc pre_change_func, ChangeNotifyFunc change_func, void *user_data);
+void o_emit_pre_change_notify(TOPLEVEL *toplevel, OBJECT *object);
+void o_emit_change_notify(TOPLEVEL *toplevel, OBJECT *object);
 gboolean o_is_visible (TOPLEVEL *toplevel, OBJECT *object);
 void o_set_visibility (TOPLEVEL *toplevel, OBJECT *object, int visibility);
 OBJECT_END o_get_line_end (int capstyle);
@@ -159,6 +161,7 @@ OBJECT *o_complex_new_embedded(TOPLEVEL *toplevel, char type, int color, int x,
 void o_complex_set_filename(TOPLEVEL *toplevel, const char *basename);
 void o_complex_translate_world(TOPLEVEL *toplevel, int dx, int dy, OBJECT *object);
 OBJECT *o_complex_copy(TOPLEVEL *toplevel, OBJECT *o_current);
+void o_complex_unshare(TOPLEVEL *toplevel, OBJECT *object);
 void o_complex_rotate_world(TOPLEVEL *toplevel, int world_centerx, int world_centery, int angle, OBJECT *object);
 void o_complex_mirror_world(TOPLEVEL *toplevel, int world_centerx, int world_centery, OBJECT *object);
 OBJECT *o_complex_find_pin_by_attribute(OBJECT *object, char *name, char *wanted_value);
@@ -243,8 +246,10 @@ void o_pin_set_type(TOPLEVEL *toplevel, OBJECT *o_current, int pin_type);
 /* o_selection.c */
 SELECTION *o_selection_new( void );
 void o_selection_add(TOPLEVEL *toplevel, SELECTION *selection, OBJECT *o_selected);
+void o_selection_add_list(TOPLEVEL *toplevel, SELECTION *selection, GList *objects);
 void o_selection_print_all(const SELECTION *selection);
 void o_selection_remove(TOPLEVEL *toplevel, SELECTION *selection, OBJECT *o_selected);
+void o_selection_remove_list(TOPLEVEL *toplevel, SELECTION *selection, GList *objects);
 void o_selection_select(TOPLEVEL *toplevel, OBJECT *object) G_GNUC_DEPRECATED;
 void o_selection_unselect(TOPLEVEL *toplevel, OBJECT *object) G_GNUC_DEPRECATED;
 
@@ -308,6 +313,7 @@ gchar *s_clib_symbol_get_data (const CLibSymbol *symbol);
 GList *s_clib_search (const gchar *pattern, const CLibSearchMode mode);
 void s_clib_flush_search_cache ();
 void s_clib_flush_symbol_cache ();
+void s_clib_get_cache_stats (guint *hits, guint *misses);
 void s_clib_symbol_invalidate_data (const CLibSymbol *symbol);
 const CLibSymbol *s_clib_get_symbol_by_name (const gchar *name);
 gchar *s_clib_symbol_get_data_by_name (const gchar *name);
@@ -338,6 +344,7 @@ void s_cue_output_all(TOPLEVEL *toplevel, const GList *obj_list, FILE *fp, int t
 void s_cue_output_lowlevel(TOPLEVEL *toplevel, OBJECT *object, int whichone, FILE *fp, int output_type);
 void s_cue_output_lowlevel_midpoints(TOPLEVEL *toplevel, OBJECT *object, FILE *fp, int output_type);
 void s_cue_output_single(TOPLEVEL *toplevel, OBJECT *object, FILE *fp, int type);
+void s_cue_append_cues(TOPLEVEL *toplevel, OBJECT *object, GArray *cues);
 
 /* s_hierarchy.c */
 PAGE *s_hierarchy_down_schematic_single(TOPLEVEL *toplevel, const gchar *filename, PAGE *parent, int page_control, int flag);
@@ -380,12 +387,14 @@ void s_page_autosave_init(TOPLEVEL *toplevel);
 gint s_page_autosave (TOPLEVEL *toplevel);
 void s_page_append (TOPLEVEL *toplevel, PAGE *page, OBJECT *object);
 void s_page_append_list (TOPLEVEL *toplevel, PAGE *page, GList *obj_list);
+void s_page_insert_list_after (TOPLEVEL *toplevel, PAGE *page, GList *after, GList *obj_list);
 void s_page_remove (TOPLEVEL *toplevel, PAGE *page, OBJECT *object);
 void s_page_replace (TOPLEVEL *toplevel, PAGE *page, OBJECT *object1, OBJECT *object2);
 void s_page_delete_objects (TOPLEVEL *toplevel, PAGE *page);
 const GList *s_page_objects (PAGE *page);
 GList *s_page_objects_in_region (TOPLEVEL *toplevel, PAGE *page, int min_x, int min_y, int max_x, int max_y);
 GList *s_page_objects_in_regions (TOPLEVEL *toplevel, PAGE *page, BOX *rects, int n_rects);
+GList *s_page_objects_inside_region (TOPLEVEL *toplevel, PAGE *page, int min_x, int min_y, int max_x, int max_y);
 
 /* s_papersizes.c */
 int s_papersizes_add_entry(char *new_papersize, int width, int height);
@@ -427,6 +436,7 @@ void s_slib_print_dirs(void);
 
 /* s_slot.c */
 char *s_slot_search_slot(OBJECT *object, OBJECT **return_found);
+GHashTable *s_slot_parse_slotdefs(OBJECT *object);
 void s_slot_update_object(TOPLEVEL *toplevel, OBJECT *object);
 
 /* s_tile.c */
@@ -446,6 +456,9 @@ void s_undo_remove_rest(TOPLEVEL *toplevel, UNDO *head);
 int s_undo_levels(UNDO *head);
 void s_undo_init(PAGE *p_current);
 void s_undo_free_all(TOPLEVEL *toplevel, PAGE *p_current);
+GPtrArray *s_undo_diff_page(TOPLEVEL *toplevel, PAGE *page);
+void s_undo_carry_deltas(PAGE *page, UNDO *u_current);
+void s_undo_apply_deltas(TOPLEVEL *toplevel, PAGE *page, GPtrArray *deltas, gboolean backwards);
 
 /* u_basic.c */
 char *u_basic_breakup_string(char *string, char delimiter, int count);
@@ -46,10 +46,13 @@ typedef struct st_page PAGE;
 typedef struct st_toplevel TOPLEVEL;
 typedef struct st_color COLOR;
 typedef struct st_undo UNDO;
+typedef struct st_undo_state UNDO_STATE;
 typedef struct st_tile TILE;
+typedef struct st_page_index PAGE_INDEX;
 typedef struct st_bounds BOUNDS;
 
 typedef struct st_conn CONN;
+typedef struct st_cue CUE;
 typedef struct st_bus_ripper BUS_RIPPER;
 
 /* netlist structures (gnetlist) */
@@ -201,6 +204,12 @@ struct st_complex {
   GList *prim_objs;			/* Primitive objects */
   /* objects which make up the */
   /* complex */
+
+  /* Copies of a complex share its prim_objs until one of them is
+   * changed (see o_complex_unshare()).  This lists the complex OBJECTs
+   * sharing them, the one the prim_objs belong to first; NULL if the
+   * prim_objs are not shared. */
+  GPtrArray *prim_objs_users;
 };
 
 struct st_circle {
@@ -321,6 +330,18 @@ struct st_conn {
   int other_whichone;
 };
 
+/* a cue drawn at a connection point, see s_cue.c */
+struct st_cue {
+  /*! \brief CUE_UNCONNECTED or CUE_JUNCTION */
+  int type;
+  /*! \brief x coord of the cue */
+  int x;
+  /*! \brief y coord of the cue */
+  int y;
+  /*! \brief whether a bus forms part of the connection */
+  int bus_involved;
+};
+
 /* this structure is used in gschem to add rippers when drawing nets */
 /* it is never stored in any object, it is only temporary */
 struct st_bus_ripper
@@ -352,6 +373,9 @@ struct st_undo {
   char *filename;
   GList *object_list;
 
+  /* or, for delta undo, the changes made by this step (see s_undo.c) */
+  GPtrArray *deltas;
+
   /* either UNDO_ALL or UNDO_VIEWPORT_ONLY */
   int type;
 
@@ -402,12 +426,15 @@ struct st_page {
   float to_world_y_constant;
 
   TILE world_tiles[MAX_TILES_X][MAX_TILES_Y];
+  PAGE_INDEX *spatial_index;  /* see s_index.c */
+  GHashTable *cue_cache;      /* see s_cue.c */
 
   /* Undo/Redo Stacks and pointers */	
   /* needs to go into page mechanism actually */
   UNDO *undo_bottom;	
   UNDO *undo_current;
   UNDO *undo_tos; 	/* Top Of Stack */
+  UNDO_STATE *undo_state;	/* page contents at undo_current, for delta undo */
 
   /* up and down the hierarchy */
   /* this holds the pid of the parent page */
@@ -96,8 +96,6 @@ OBJECT *o_attrib_find_attrib_by_name(const GList *list, char *name, int count);
 void o_bounds_invalidate(TOPLEVEL *toplevel, OBJECT *object);
 double o_shortest_distance_full(OBJECT *object, int x, int y, int force_solid);
 PAGE *o_get_page_compat (TOPLEVEL *toplevel, OBJECT *object) G_GNUC_DEPRECATED;
-void o_emit_pre_change_notify(TOPLEVEL *toplevel, OBJECT *object);
-void o_emit_change_notify(TOPLEVEL *toplevel, OBJECT *object);
 int o_get_capstyle (OBJECT_END end);
 
 /* o_box_basic.c */
@@ -150,6 +148,7 @@ void world_get_complex_bounds(TOPLEVEL *toplevel, OBJECT *complex, int *left, in
 gboolean o_complex_get_position(TOPLEVEL *toplevel, gint *x, gint *y, OBJECT *object);
 void o_complex_recalc(TOPLEVEL *toplevel, OBJECT *o_current);
 GList *o_complex_get_promotable (TOPLEVEL *toplevel, OBJECT *object, int detach);
+gboolean o_complex_release_shared (TOPLEVEL *toplevel, OBJECT *object);
 
 /* o_line_basic.c */
 OBJECT *o_line_read(TOPLEVEL *toplevel, const const char buf[], unsigned int release_ver, unsigned int fileformat_ver, GError **err);
@@ -228,6 +227,11 @@ OBJECT *s_conn_check_midpoint(OBJECT *o_current, int x, int y);
 void s_conn_print(GList *conn_list);
 void s_conn_init(void);
 
+/* s_cue.c */
+void s_cue_remove_object(PAGE *page, OBJECT *object);
+void s_cue_free(PAGE *page);
+void s_cue_init(void);
+
 /* s_encoding.c */
 gchar* s_encoding_base64_encode (gchar* src, guint srclen, guint* dstlenp, gboolean strict);
 gchar* s_encoding_base64_decode (gchar* src, guint srclen, guint* dstlenp);
@@ -236,6 +240,14 @@ gchar* s_encoding_base64_decode (gchar* src, guint srclen, guint* dstlenp);
 int s_path_to_polygon(PATH *path, GArray *points);
 double s_path_shortest_distance (PATH *path, int x, int y, int solid);
 
+/* s_index.c */
+void s_index_add_object(PAGE *page, OBJECT *object);
+void s_index_remove_object(PAGE *page, OBJECT *object);
+void s_index_reorder(PAGE *page);
+void s_index_touch(OBJECT *object);
+GList *s_index_query(TOPLEVEL *toplevel, PAGE *page, BOX *rects, int n_rects, gboolean contained);
+void s_index_free(PAGE *page);
+
 /* s_textbuffer.c */
 TextBuffer *s_textbuffer_new (const gchar *data, const gint size);
 TextBuffer *s_textbuffer_free (TextBuffer *tb);
@@ -249,6 +261,11 @@ void s_tile_remove_object(OBJECT *object);
 void s_tile_print(TOPLEVEL *toplevel, PAGE *page);
 void s_tile_free_all(PAGE *p_current);
 
+/* s_undo.c */
+void s_undo_object_added(PAGE *page, GList *link);
+void s_undo_object_removed(PAGE *page, OBJECT *object);
+void s_undo_init_hooks(void);
+
 /* s_weakref.c */
 void s_weakref_notify (void *dead_ptr, GList *weak_refs);
 GList *s_weakref_add (GList *weak_refs, void (*notify_func)(void *, void *), void *user_data);
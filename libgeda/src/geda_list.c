@@ -204,6 +204,39 @@ void geda_list_remove( GedaList *list, gpointer item )
 }
 
 
+/*! \brief Removes the given glist of items from the GedaList
+ *
+ *  \par Function Description
+ *  Removes the given glist of items from the GedaList, emitting a
+ *  single "changed" signal.  Items which are not in the list are
+ *  ignored.  The passed GList is not modified.
+ *
+ *  \param [in] list Pointer to the GedaList
+ *  \param [in] items GList of items to remove from the GedaList.
+ */
+void geda_list_remove_glist( GedaList *list, GList *items )
+{
+  GHashTable *remove;
+  GList *iter, *next;
+
+  if (items == NULL)
+    return;
+
+  remove = g_hash_table_new (g_direct_hash, g_direct_equal);
+  for (iter = items; iter != NULL; iter = g_list_next (iter))
+    g_hash_table_insert (remove, iter->data, iter->data);
+
+  for (iter = list->glist; iter != NULL; iter = next) {
+    next = g_list_next (iter);
+    if (g_hash_table_lookup (remove, iter->data) != NULL)
+      list->glist = g_list_delete_link (list->glist, iter);
+  }
+  g_hash_table_destroy (remove);
+
+  g_signal_emit( list, geda_list_signals[ CHANGED ], 0 );
+}
+
+
 /*! \brief Removes all the items in the given GedaList.
  *
  *  \par Function Description
@@ -65,6 +65,8 @@ void libgeda_init(void)
   s_attrib_init();
   s_color_init();
   s_conn_init();
+  s_cue_init();
+  s_undo_init_hooks();
 
   g_register_libgeda_funcs();
   g_register_libgeda_dirs();
@@ -490,6 +490,7 @@ void o_arc_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right  = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 
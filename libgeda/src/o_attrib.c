@@ -67,10 +67,14 @@
  */
 void o_attrib_add(TOPLEVEL *toplevel, OBJECT *object, OBJECT *item)
 {
+  o_emit_pre_change_notify (toplevel, item);
+
   /* Add link from item to attrib listing */
   item->attached_to = object;
   object->attribs = g_list_append (object->attribs, item);
 
+  o_emit_change_notify (toplevel, item);
+
   o_attrib_emit_attribs_changed (toplevel, object);
 }
 
@@ -174,8 +178,10 @@ void o_attrib_detach_all(TOPLEVEL *toplevel, OBJECT *object)
        a_iter = g_list_next (a_iter)) {
     a_current = a_iter->data;
 
+    o_emit_pre_change_notify (toplevel, a_current);
     a_current->attached_to = NULL;
     o_set_color (toplevel, a_current, DETACHED_ATTRIBUTE_COLOR);
+    o_emit_change_notify (toplevel, a_current);
     o_attrib_emit_attribs_changed (toplevel, object);
   }
 
@@ -225,11 +231,15 @@ void o_attrib_remove(TOPLEVEL *toplevel, GList **list, OBJECT *remove)
 
   g_return_if_fail (remove != NULL);
 
+  o_emit_pre_change_notify (toplevel, remove);
+
   attached_to = remove->attached_to;
   remove->attached_to = NULL;
 
   *list = g_list_remove (*list, remove);
 
+  o_emit_change_notify (toplevel, remove);
+
   o_attrib_emit_attribs_changed (toplevel, attached_to);
 }
 
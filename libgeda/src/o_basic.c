@@ -408,7 +408,9 @@ void o_translate_world (TOPLEVEL *toplevel, gint dx, gint dy, OBJECT *object)
   }
 
   if (func != NULL) {
+    o_emit_pre_change_notify (toplevel, object);
     (*func) (toplevel, dx, dy, object);
+    o_emit_change_notify (toplevel, object);
   }
 }
 
@@ -447,7 +449,9 @@ void o_rotate_world (TOPLEVEL *toplevel, int world_centerx, int world_centery, i
   }
 
   if (func != NULL) {
+    o_emit_pre_change_notify (toplevel, object);
     (*func) (toplevel, world_centerx, world_centery, angle, object);
+    o_emit_change_notify (toplevel, object);
   }
 }
 
@@ -485,7 +489,9 @@ void o_mirror_world (TOPLEVEL *toplevel, int world_centerx, int world_centery, O
   }
 
   if (func != NULL) {
+    o_emit_pre_change_notify (toplevel, object);
     (*func) (toplevel, world_centerx, world_centery, object);
+    o_emit_change_notify (toplevel, object);
   }
 }
 
@@ -563,6 +569,8 @@ double o_shortest_distance_full (OBJECT *object, int x, int y, int force_solid)
  */
 void o_bounds_invalidate(TOPLEVEL *toplevel, OBJECT *obj)
 {
+  s_index_touch (obj);
+
   do {
       obj->w_bounds_valid = FALSE;
   } while ((obj = obj->parent) != NULL);
@@ -582,11 +590,17 @@ void o_set_color (TOPLEVEL *toplevel, OBJECT *object, int color)
 {
   g_return_if_fail (object != NULL);
 
+  o_emit_pre_change_notify (toplevel, object);
+
   object->color = color;
 
   if (object->type == OBJ_COMPLEX ||
-      object->type == OBJ_PLACEHOLDER)
+      object->type == OBJ_PLACEHOLDER) {
+    o_complex_unshare (toplevel, object);
     o_glist_set_color (toplevel, object->complex->prim_objs, color);
+  }
+
+  o_emit_change_notify (toplevel, object);
 }
 
 
@@ -818,8 +832,10 @@ o_set_visibility (TOPLEVEL *toplevel, OBJECT *object, int visibility)
 {
   g_return_if_fail (object != NULL);
   if (object->visibility != visibility) {
+    o_emit_pre_change_notify (toplevel, object);
     object->visibility = visibility;
     o_bounds_invalidate (toplevel, object);
+    o_emit_change_notify (toplevel, object);
   }
 }
 
@@ -589,6 +589,7 @@ void o_box_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right  = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief Get BOX bounding rectangle in WORLD coordinates.
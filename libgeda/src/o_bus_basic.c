@@ -131,6 +131,7 @@ void o_bus_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief read a bus object from a char buffer
@@ -512,12 +513,15 @@ void o_bus_consolidate(TOPLEVEL *toplevel)
 void o_bus_modify(TOPLEVEL *toplevel, OBJECT *object,
 		  int x, int y, int whichone)
 {
+  o_emit_pre_change_notify (toplevel, object);
+
   object->line->x[whichone] = x;
   object->line->y[whichone] = y;
 
   o_bus_recalc (toplevel, object);
 
   s_tile_update_object(toplevel, object);
+  o_emit_change_notify (toplevel, object);
 }
 
 
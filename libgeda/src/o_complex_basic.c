@@ -282,6 +282,9 @@ GList *o_complex_get_promotable (TOPLEVEL *toplevel, OBJECT *object, int detach)
   if (!toplevel->attribute_promotion) /* controlled through rc file */
     return NULL;
 
+  if (detach)
+    o_complex_unshare (toplevel, object);
+
   attribs = o_attrib_find_floating_attribs (object->complex->prim_objs);
 
   for (iter = attribs; iter != NULL; iter = g_list_next (iter)) {
@@ -322,6 +325,8 @@ GList *o_complex_promote_attribs (TOPLEVEL *toplevel, OBJECT *object)
   GList *promotable = NULL;
   GList *iter = NULL;
 
+  o_complex_unshare (toplevel, object);
+
   promotable = o_complex_get_promotable (toplevel, object, FALSE);
 
   /* Run through the attributes deciding if we want to keep them (in
@@ -375,6 +380,8 @@ static void o_complex_remove_promotable_attribs (TOPLEVEL *toplevel, OBJECT *obj
 {
   GList *promotable, *iter;
 
+  o_complex_unshare (toplevel, object);
+
   promotable = o_complex_get_promotable (toplevel, object, FALSE);
 
   if (promotable == NULL)
@@ -504,6 +511,7 @@ OBJECT *o_complex_new(TOPLEVEL *toplevel,
 
   new_node->complex = (COMPLEX *) g_malloc(sizeof(COMPLEX));
   new_node->complex->prim_objs = NULL;
+  new_node->complex->prim_objs_users = NULL;
   new_node->complex->angle = angle;
   new_node->complex->mirror = mirror;
   new_node->complex->x = x;
@@ -579,6 +587,7 @@ OBJECT *o_complex_new_embedded(TOPLEVEL *toplevel,
 
   new_node->complex->angle = angle;
   new_node->complex->mirror = mirror;
+  new_node->complex->prim_objs_users = NULL;
 	
   new_node->complex_basename = g_strdup(basename);
 
@@ -621,6 +630,7 @@ void o_complex_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief read a complex object from a char buffer
@@ -757,6 +767,8 @@ void o_complex_translate_world(TOPLEVEL *toplevel, int dx, int dy,
                     (object->type == OBJ_COMPLEX ||
                      object->type == OBJ_PLACEHOLDER));
 
+  o_complex_unshare (toplevel, object);
+
   object->complex->x = object->complex->x + dx;
   object->complex->y = object->complex->y + dy;
 
@@ -765,10 +777,119 @@ void o_complex_translate_world(TOPLEVEL *toplevel, int dx, int dy,
   o_complex_recalc (toplevel, object);
 }
 
+/*! \brief Set the parent of the objects inside a complex. */
+static void o_complex_set_parent (GList *prim_objs, OBJECT *parent)
+{
+  GList *iter;
+
+  for (iter = prim_objs; iter != NULL; iter = g_list_next (iter)) {
+    ((OBJECT*) iter->data)->parent = parent;
+  }
+}
+
+/*! \brief Give a complex object its own contents
+ *  \par Function Description
+ *  Copies of a complex object share the objects inside it, until one
+ *  of them needs to change them.  This must be called before changing
+ *  anything in the prim_objs of \a object, and makes sure that no
+ *  other complex uses them.  It does nothing if they are not shared.
+ *
+ *  The shared objects stay with the complex they belong to, which may
+ *  be on a page and connected to other objects; the others get a copy.
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] object    The complex OBJECT about to be changed.
+ */
+void o_complex_unshare (TOPLEVEL *toplevel, OBJECT *object)
+{
+  GPtrArray *users;
+  GList *copy;
+  OBJECT *other;
+  guint i;
+
+  g_return_if_fail (object != NULL && object->complex != NULL);
+
+  users = object->complex->prim_objs_users;
+  if (users == NULL)
+    return;
+
+  copy = o_glist_copy_all (toplevel, object->complex->prim_objs, NULL);
+
+  if (g_ptr_array_index (users, 0) == object) {
+    /* Keep the originals and move everybody else to the copy */
+    g_ptr_array_remove_index (users, 0);
+    o_complex_set_parent (copy, g_ptr_array_index (users, 0));
+    for (i = 0; i < users->len; i++) {
+      other = g_ptr_array_index (users, i);
+      other->complex->prim_objs = copy;
+    }
+  } else {
+    g_ptr_array_remove (users, object);
+    o_complex_set_parent (copy, object);
+    object->complex->prim_objs = copy;
+  }
+
+  if (users->len == 1) {
+    other = g_ptr_array_index (users, 0);
+    other->complex->prim_objs_users = NULL;
+    g_ptr_array_free (users, TRUE);
+  }
+
+  object->complex->prim_objs_users = NULL;
+}
+
+/*! \brief Stop using shared complex contents before deletion
+ *  \par Function Description
+ *  Called when \a object is deleted.  If its prim_objs are shared with
+ *  copies, they are handed over to the copies instead of being deleted.
+ *  The copies are not on a page, so the objects are disconnected from
+ *  the page first.
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] object    The complex OBJECT being deleted.
+ *  \return TRUE if the prim_objs were handed over, FALSE if they belong
+ *           to \a object alone and must be deleted with it.
+ */
+gboolean o_complex_release_shared (TOPLEVEL *toplevel, OBJECT *object)
+{
+  GPtrArray *users = object->complex->prim_objs_users;
+  OBJECT *other;
+  GList *iter;
+
+  if (users == NULL)
+    return FALSE;
+
+  if (g_ptr_array_index (users, 0) == object) {
+    for (iter = object->complex->prim_objs; iter != NULL;
+         iter = g_list_next (iter)) {
+      s_conn_remove_object (toplevel, iter->data);
+    }
+    g_ptr_array_remove_index (users, 0);
+    o_complex_set_parent (object->complex->prim_objs,
+                          g_ptr_array_index (users, 0));
+  } else {
+    g_ptr_array_remove (users, object);
+  }
+
+  if (users->len == 1) {
+    other = g_ptr_array_index (users, 0);
+    other->complex->prim_objs_users = NULL;
+    g_ptr_array_free (users, TRUE);
+  }
+
+  object->complex->prim_objs_users = NULL;
+  object->complex->prim_objs = NULL;
+  return TRUE;
+}
+
 /*! \brief Create a copy of a COMPLEX object
  *  \par Function Description
  *  This function creates a copy of the complex object \a o_current.
  *
+ *  The copy shares the objects inside \a o_current until either of
+ *  them is changed, so copying a complex to a buffer costs the same
+ *  however many objects its symbol has.
+ *
  *  \param [in] toplevel     The TOPLEVEL object
  *  \param [in] o_current    The object that is copied
  *  \return a new COMPLEX object
@@ -776,7 +897,7 @@ void o_complex_translate_world(TOPLEVEL *toplevel, int dx, int dy,
 OBJECT *o_complex_copy(TOPLEVEL *toplevel, OBJECT *o_current)
 {
   OBJECT *o_new;
-  GList *iter;
+  GPtrArray *users;
 
   g_return_val_if_fail(o_current != NULL, NULL);
 
@@ -792,25 +913,21 @@ OBJECT *o_complex_copy(TOPLEVEL *toplevel, OBJECT *o_current)
   o_new->complex->angle = o_current->complex->angle;
   o_new->complex->mirror = o_current->complex->mirror;
 
-  /* Copy contents and set the parent pointers on the copied objects. */
-  o_new->complex->prim_objs =
-    o_glist_copy_all (toplevel, o_current->complex->prim_objs,
-                      NULL);
-
-  for (iter = o_new->complex->prim_objs;
-       iter != NULL;
-       iter = g_list_next (iter)) {
-    ((OBJECT*) iter->data)->parent = o_new;
+  /* Share the contents.  They have already had their promotable
+   * attributes removed and their slot set up, for the original. */
+  users = o_current->complex->prim_objs_users;
+  if (users == NULL) {
+    users = g_ptr_array_new ();
+    g_ptr_array_add (users, o_current);
+    o_current->complex->prim_objs_users = users;
   }
+  g_ptr_array_add (users, o_new);
+  o_new->complex->prim_objs_users = users;
+  o_new->complex->prim_objs = o_current->complex->prim_objs;
 
   /* Recalculate bounds */
   o_complex_recalc(toplevel, o_new);
 
-  /* Delete or hide attributes eligible for promotion inside the complex */
-  o_complex_remove_promotable_attribs (toplevel, o_new);
-
-  s_slot_update_object (toplevel, o_new);
-
   /* deal with stuff that has changed */
 
   /* here you need to create a list of attributes which need to be
@@ -53,7 +53,9 @@ void o_embed(TOPLEVEL *toplevel, OBJECT *o_current)
   {
 
     /* set the embedded flag */
+    o_emit_pre_change_notify (toplevel, o_current);
     o_current->complex_embedded = TRUE;
+    o_emit_change_notify (toplevel, o_current);
 
     s_log_message (_("Component [%s] has been embedded\n"),
                    o_current->complex_basename);
@@ -105,7 +107,9 @@ void o_unembed(TOPLEVEL *toplevel, OBJECT *o_current)
       
     } else {
       /* clear the embedded flag */
+      o_emit_pre_change_notify (toplevel, o_current);
       o_current->complex_embedded = FALSE;
+      o_emit_change_notify (toplevel, o_current);
 
       s_log_message (_("Component [%s] has been successfully unembedded\n"),
                      o_current->complex_basename);
@@ -193,8 +193,13 @@ GList *o_glist_copy_all (TOPLEVEL *toplevel,
           src_object->attached_to->copied_to != NULL) {
         o_attrib_attach(toplevel, dst_object,
                         src_object->attached_to->copied_to, FALSE);
-        /* handle slot= attribute, it's a special case */
-        if (g_ascii_strncasecmp (dst_object->text->string, "slot=", 5) == 0)
+        /* handle slot= attribute, it's a special case.  A copy that
+         * still shares its contents with the original already has the
+         * same slot set up. */
+        if (g_ascii_strncasecmp (dst_object->text->string, "slot=", 5) == 0 &&
+            (src_object->attached_to->complex == NULL ||
+             src_object->attached_to->copied_to->complex->prim_objs !=
+             src_object->attached_to->complex->prim_objs))
           s_slot_update_object (toplevel, src_object->attached_to->copied_to);
       }
     }
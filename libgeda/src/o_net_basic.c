@@ -128,6 +128,7 @@ void o_net_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief read a net object from a char buffer
@@ -630,12 +631,15 @@ void o_net_consolidate(TOPLEVEL *toplevel, PAGE *page)
 void o_net_modify(TOPLEVEL *toplevel, OBJECT *object,
 		  int x, int y, int whichone)
 {
+  o_emit_pre_change_notify (toplevel, object);
+
   object->line->x[whichone] = x;
   object->line->y[whichone] = y;
 
   o_net_recalc (toplevel, object);
 
   s_tile_update_object(toplevel, object);
+  o_emit_change_notify (toplevel, object);
 }
 
 /*! \brief Refresh & cache number of connected entities.
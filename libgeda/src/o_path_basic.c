@@ -493,8 +493,10 @@ void o_path_recalc (TOPLEVEL *toplevel, OBJECT *o_current)
     o_current->w_right  = right;
     o_current->w_bottom = bottom;
     o_current->w_bounds_valid = TRUE;
+    s_index_touch (o_current);
   } else {
     o_current->w_bounds_valid = FALSE;
+    s_index_touch (o_current);
   }
 }
 
@@ -354,6 +354,7 @@ void o_picture_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right  = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief Get picture bounding rectangle in WORLD coordinates.
@@ -960,7 +961,9 @@ void o_picture_embed (TOPLEVEL *toplevel, OBJECT *object)
     return;
   }
 
+  o_emit_pre_change_notify (toplevel, object);
   object->picture->embedded = 1;
+  o_emit_change_notify (toplevel, object);
 
   basename = g_path_get_basename (filename);
   s_log_message (_("Picture [%s] has been embedded\n"), basename);
@@ -994,7 +997,9 @@ void o_picture_unembed (TOPLEVEL *toplevel, OBJECT *object)
     return;
   }
 
+  o_emit_pre_change_notify (toplevel, object);
   object->picture->embedded = 0;
+  o_emit_change_notify (toplevel, object);
 
   basename = g_path_get_basename(filename);
   s_log_message (_("Picture [%s] has been unembedded\n"), basename);
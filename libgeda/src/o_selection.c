@@ -82,6 +82,68 @@ void o_selection_remove (TOPLEVEL *toplevel, SELECTION *selection, OBJECT *o_sel
 }
 
 
+/*! \brief Selects a list of objects and adds them to the selection list
+ *  \par Function Description
+ *  Like o_selection_add(), but for a whole list of objects.  The
+ *  selection list only signals that it has changed once, so handlers
+ *  of the signal run once for the whole set rather than per object.
+ *  Objects that are already selected are skipped.
+ *
+ *  \param [in] toplevel   The TOPLEVEL object
+ *  \param [in] selection  Pointer to the selection list
+ *  \param [in] objects    GList of objects to select.
+ */
+void o_selection_add_list (TOPLEVEL *toplevel, SELECTION *selection,
+                           GList *objects)
+{
+  GList *added = NULL;
+  GList *iter;
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *o_selected = iter->data;
+
+    if (o_selected->selected == FALSE) {
+      o_selection_select (toplevel, o_selected);
+      added = g_list_prepend (added, o_selected);
+    }
+  }
+
+  if (added != NULL) {
+    added = g_list_reverse (added);
+    geda_list_add_glist ((GedaList *)selection, added);
+    g_list_free (added);
+  }
+}
+
+/*! \brief Removes a list of objects from the selection list
+ *  \par Function Description
+ *  Like o_selection_remove(), but for a whole list of objects, with
+ *  a single change signal from the selection list.  Objects that are
+ *  not selected are skipped.
+ *
+ *  \param [in] toplevel   The TOPLEVEL object
+ *  \param [in] selection  Pointer to the selection list
+ *  \param [in] objects    GList of objects to unselect.
+ */
+void o_selection_remove_list (TOPLEVEL *toplevel, SELECTION *selection,
+                              GList *objects)
+{
+  GList *iter;
+
+  if (objects == NULL)
+    return;
+
+  for (iter = objects; iter != NULL; iter = g_list_next (iter)) {
+    OBJECT *o_selected = iter->data;
+
+    if (o_selected->selected)
+      o_selection_unselect (toplevel, o_selected);
+  }
+
+  geda_list_remove_glist ((GedaList *)selection, objects);
+}
+
+
 /*! \brief Prints the given selection list.
  *  \par Prints the given selection list.
  *  \param [in] selection Pointer to selection list to print.
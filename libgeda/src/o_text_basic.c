@@ -311,6 +311,7 @@ void o_text_recalc(TOPLEVEL *toplevel, OBJECT *o_current)
   o_current->w_right = right;
   o_current->w_bottom = bottom;
   o_current->w_bounds_valid = TRUE;
+  s_index_touch (o_current);
 }
 
 /*! \brief read a text object from a char buffer
@@ -521,6 +522,7 @@ void o_text_recreate(TOPLEVEL *toplevel, OBJECT *o_current)
   o_emit_pre_change_notify (toplevel, o_current);
   update_disp_string (o_current);
   o_current->w_bounds_valid = FALSE;
+  s_index_touch (o_current);
   o_emit_change_notify (toplevel, o_current);
 }
 
@@ -541,6 +543,7 @@ void o_text_translate_world(TOPLEVEL *toplevel,
 
   /* Update bounding box */
   o_current->w_bounds_valid = FALSE;
+  s_index_touch (o_current);
 }
 
 /*! \brief create a copy of a text object
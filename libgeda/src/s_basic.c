@@ -222,6 +222,11 @@ s_delete_object(TOPLEVEL *toplevel, OBJECT *o_current)
       s_page_remove (toplevel, o_current->page, o_current);
     }
 
+    /* Copies of this object keep the contents they share with it */
+    if (o_current->complex != NULL) {
+      o_complex_release_shared (toplevel, o_current);
+    }
+
     s_conn_remove_object (toplevel, o_current);
 
     if (o_current->attached_to != NULL) {
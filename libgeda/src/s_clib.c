@@ -230,6 +230,11 @@ static GHashTable *clib_search_cache = NULL;
  *  the time it was last used. */
 static GHashTable *clib_symbol_cache = NULL;
 
+/*! Number of s_clib_symbol_get_data() calls answered from
+ *  #clib_symbol_cache, and number that had to fetch the data. */
+static guint clib_symbol_cache_hits = 0;
+static guint clib_symbol_cache_misses = 0;
+
 /* Local static functions
  * ======================
  */
@@ -1182,8 +1187,10 @@ gchar *s_clib_symbol_get_data (const CLibSymbol *symbol)
   cached = g_hash_table_lookup (clib_symbol_cache, symptr);
   if (cached != NULL) {
     cached->accessed = time(NULL);
+    clib_symbol_cache_hits++;
     return g_strdup(cached->data);
   }
+  clib_symbol_cache_misses++;
 
   /* If the symbol wasn't found in the cache, get it directly. */
   switch (symbol->source->type)
@@ -1353,6 +1360,22 @@ void s_clib_flush_symbol_cache ()
   g_hash_table_remove_all (clib_symbol_cache);  /* Introduced in glib 2.12 */
 }
 
+/*! \brief Get symbol data cache statistics.
+ *  \par Function Description
+ *  Reports how many requests for symbol data have been made with
+ *  s_clib_symbol_get_data() since the library was initialised, and
+ *  how many of them were answered from the symbol data cache.
+ *
+ *  \param [out] hits    Number of requests answered from the cache.
+ *  \param [out] misses  Number of requests that fetched the data.
+ */
+void
+s_clib_get_cache_stats (guint *hits, guint *misses)
+{
+  if (hits != NULL) *hits = clib_symbol_cache_hits;
+  if (misses != NULL) *misses = clib_symbol_cache_misses;
+}
+
 /*! \brief Invalidate all cached data about a symbol.
  * \par Function Description
  * Removes all cached symbol data for \a symbol.
@@ -31,6 +31,145 @@
 #include <dmalloc.h>
 #endif
 
+/*! \brief The cached cues of a net, bus or pin.
+ *  \par
+ *  The geometry the cues were found for is kept, so that a change
+ *  which did not go through the connection system is still noticed.
+ */
+typedef struct {
+  int x[2];
+  int y[2];
+  int pin_type;
+  int whichend;
+  GArray *end_cues;  /* cues at the ends of the object */
+  GArray *mid_cues;  /* junctions along the object */
+} CUE_ENTRY;
+
+static void cue_entry_free (gpointer data)
+{
+  CUE_ENTRY *entry = data;
+
+  g_array_free (entry->end_cues, TRUE);
+  g_array_free (entry->mid_cues, TRUE);
+  g_free (entry);
+}
+
+/*! \brief Check whether an object is a bus or a bus pin. */
+static int cue_is_bus_related (OBJECT *object)
+{
+  return (object->type == OBJ_BUS ||
+           (object->type == OBJ_PIN && object->pin_type == PIN_TYPE_BUS));
+}
+
+/*! \brief Find the cue at one end of an object.
+ *  \par Function Description
+ *  Adds the cue at end \a whichone of \a object, if there is one,
+ *  to \a cues: a box if nothing is connected there, or a junction if
+ *  two or more objects meet there or the end lies on another object.
+ */
+static void cue_find_end (OBJECT *object, int whichone, GArray *cues)
+{
+  GList *cl_current;
+  CONN *conn;
+  CUE cue;
+  int type, count = 0;
+  int done = FALSE;
+
+  cue.x = object->line->x[whichone];
+  cue.y = object->line->y[whichone];
+  cue.bus_involved = cue_is_bus_related (object);
+
+  type = CONN_ENDPOINT;
+
+  cl_current = object->conn_list;
+  while (cl_current != NULL && !done) {
+    conn = (CONN *) cl_current->data;
+
+    if (conn->x == cue.x && conn->y == cue.y) {
+
+      if (conn->other_object && cue_is_bus_related (conn->other_object))
+        cue.bus_involved = TRUE;
+
+      switch (conn->type) {
+
+        case (CONN_ENDPOINT):
+          count++;
+          break;
+
+        case (CONN_MIDPOINT):
+          type = CONN_MIDPOINT;
+          done = TRUE;
+          count = 0;
+          break;
+      }
+    }
+
+    cl_current = g_list_next(cl_current);
+  }
+
+  switch (type) {
+
+    case (CONN_ENDPOINT):
+      if (object->type == OBJ_NET || object->type == OBJ_PIN) {
+        if (count < 1) {	/* Didn't find anything connected there */
+          cue.type = CUE_UNCONNECTED;
+          g_array_append_val (cues, cue);
+        } else if (count >= 2) {
+          cue.type = CUE_JUNCTION;
+          g_array_append_val (cues, cue);
+        }
+      }
+      break;
+
+    case (CONN_MIDPOINT):
+      cue.type = CUE_JUNCTION;
+      g_array_append_val (cues, cue);
+      break;
+  }
+}
+
+/*! \brief Find the junctions along a net or bus. */
+static void cue_find_midpoints (OBJECT *object, GArray *cues)
+{
+  GList *iter;
+  CUE cue;
+
+  for (iter = object->conn_list; iter != NULL; iter = g_list_next (iter)) {
+    CONN *conn = iter->data;
+
+    if (conn->type == CONN_MIDPOINT) {
+      cue.type = CUE_JUNCTION;
+      cue.x = conn->x;
+      cue.y = conn->y;
+      cue.bus_involved = (object->type == OBJ_BUS ||
+                          (conn->other_object &&
+                           conn->other_object->type == OBJ_BUS));
+      g_array_append_val (cues, cue);
+    }
+  }
+}
+
+/*! \brief Output a list of cues. */
+static void cue_output (TOPLEVEL *toplevel, GArray *cues, FILE *fp,
+                        int output_type)
+{
+  guint i;
+
+  if (output_type != POSTSCRIPT)
+    return;
+
+  for (i = 0; i < cues->len; i++) {
+    CUE *cue = &g_array_index (cues, CUE, i);
+
+    if (cue->type == CUE_UNCONNECTED) {
+      s_cue_postscript_fillbox (toplevel, fp, cue->x, cue->y);
+    } else {
+      s_cue_postscript_junction (toplevel, fp, cue->x, cue->y,
+                                 cue->bus_involved);
+    }
+  }
+}
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -78,35 +217,23 @@ void s_cue_postscript_junction (TOPLEVEL * toplevel, FILE * fp,
 }
 
 
-/*! \todo Finish function documentation!!!
- *  \brief
+/*! \brief Output the cues of a list of objects
  *  \par Function Description
+ *  Outputs the cues of the nets, buses and pins in \a obj_list,
+ *  including the pins inside components.
  *
+ *  \param [in] toplevel  The TOPLEVEL object
+ *  \param [in] obj_list  The OBJECTs to output cues for
+ *  \param [in] fp        The file handle to output to
+ *  \param [in] type      The type of output being produced
  */
 void s_cue_output_all (TOPLEVEL * toplevel, const GList *obj_list, FILE * fp,
                        int type)
 {
-  OBJECT *o_current;
   const GList *iter;
 
-  iter = obj_list;
-  while (iter != NULL) {
-    o_current = (OBJECT *)iter->data;
-    switch (o_current->type) {
-      case (OBJ_NET):
-      case (OBJ_BUS):
-      case (OBJ_PIN):
-        s_cue_output_single(toplevel, o_current, fp, type);
-        break;
-
-      case (OBJ_COMPLEX):
-      case (OBJ_PLACEHOLDER):
-        s_cue_output_all(toplevel, o_current->complex->prim_objs, fp,
-                         type);
-        break;
-
-    }
-    iter = g_list_next (iter);
+  for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
+    s_cue_output_single (toplevel, (OBJECT *)iter->data, fp, type);
   }
 }
 
@@ -118,78 +245,11 @@ void s_cue_output_all (TOPLEVEL * toplevel, const GList *obj_list, FILE * fp,
 void s_cue_output_lowlevel(TOPLEVEL * toplevel, OBJECT * object, int whichone,
 			   FILE * fp, int output_type)
 {
-  int x, y;
-  GList *cl_current;
-  CONN *conn;
-  int type, count = 0;
-  int done = FALSE;
-  int bus_involved = FALSE;
-
-  x = object->line->x[whichone];
-  y = object->line->y[whichone];
-
-  type = CONN_ENDPOINT;
-
-  if (object->type == OBJ_BUS ||
-       (object->type == OBJ_PIN && object->pin_type == PIN_TYPE_BUS))
-    bus_involved = TRUE;
-
-  cl_current = object->conn_list;
-  while (cl_current != NULL && !done) {
-    conn = (CONN *) cl_current->data;
-
-    if (conn->x == x && conn->y == y) {
-
-      if (conn->other_object &&
-           (conn->other_object->type == OBJ_BUS ||
-             (conn->other_object->type == OBJ_PIN &&
-              conn->other_object->pin_type == PIN_TYPE_BUS)))
-        bus_involved=TRUE;
-
-      switch (conn->type) {
-
-        case (CONN_ENDPOINT):
-          count++;
-          break;
-
-        case (CONN_MIDPOINT):
-          type = CONN_MIDPOINT;
-          done = TRUE;
-          count = 0;
-          break;
-      }
-    }
-
-    cl_current = g_list_next(cl_current);
-  }
-
-#if DEBUG
-  printf("type: %d count: %d\n", type, count);
-#endif
-
-  switch (type) {
-
-    case (CONN_ENDPOINT):
-      if (object->type == OBJ_NET || object->type == OBJ_PIN) {
-        if (count < 1) {	/* Didn't find anything connected there */
-          if (output_type == POSTSCRIPT) {
-            s_cue_postscript_fillbox(toplevel, fp, x, y);
-          }
-
-
-        } else if (count >= 2) {
-          if (output_type == POSTSCRIPT)
-            s_cue_postscript_junction (toplevel, fp, x, y, bus_involved);
-        }
-      }
-      break;
-
-    case (CONN_MIDPOINT):
-      if (output_type == POSTSCRIPT)
-        s_cue_postscript_junction (toplevel, fp, x, y, bus_involved);
-      break;
-  }
+  GArray *cues = g_array_new (FALSE, FALSE, sizeof (CUE));
 
+  cue_find_end (object, whichone, cues);
+  cue_output (toplevel, cues, fp, output_type);
+  g_array_free (cues, TRUE);
 }
 
 /*! \todo Finish function documentation!!!
@@ -200,36 +260,11 @@ void s_cue_output_lowlevel(TOPLEVEL * toplevel, OBJECT * object, int whichone,
 void s_cue_output_lowlevel_midpoints(TOPLEVEL * toplevel, OBJECT * object,
 				     FILE * fp, int output_type)
 {
-  int x, y;
-  GList *cl_current;
-  CONN *conn;
-  int bus_involved = FALSE;
-
-  if (object->type == OBJ_BUS)
-    bus_involved = TRUE;
-
-  cl_current = object->conn_list;
-  while (cl_current != NULL) {
-    conn = (CONN *) cl_current->data;
-
-    switch (conn->type) {
-      case (CONN_MIDPOINT):
+  GArray *cues = g_array_new (FALSE, FALSE, sizeof (CUE));
 
-        x = conn->x;
-        y = conn->y;
-
-        if (conn->other_object && conn->other_object->type == OBJ_BUS)
-          bus_involved = TRUE;
-
-        if (output_type == POSTSCRIPT) {
-          s_cue_postscript_junction (toplevel, fp, x, y, bus_involved);
-        }
-        break;
-    }
-
-
-    cl_current = g_list_next(cl_current);
-  }
+  cue_find_midpoints (object, cues);
+  cue_output (toplevel, cues, fp, output_type);
+  g_array_free (cues, TRUE);
 }
 
 /*! \brief Output cues for a single object
@@ -240,6 +275,9 @@ void s_cue_output_lowlevel_midpoints(TOPLEVEL * toplevel, OBJECT * object,
  *   - endpoint cues (identifying unconnected ends of objects)
  *   - junction cues (identifying net/pin/bus junctions)
  *
+ *  The cues are taken from the page's cue cache, see
+ *  s_cue_append_cues().
+ *
  *  \param [in] toplevel   The TOPLEVEL object
  *  \param [in] object     The OBJECT to output cues for
  *  \param [in] fp         The file handle to output to
@@ -248,35 +286,196 @@ void s_cue_output_lowlevel_midpoints(TOPLEVEL * toplevel, OBJECT * object,
 void s_cue_output_single(TOPLEVEL * toplevel, OBJECT * object, FILE * fp,
 			 int type)
 {
+  GArray *cues;
+
   g_return_if_fail (object != NULL);
 
+  cues = g_array_new (FALSE, FALSE, sizeof (CUE));
+  s_cue_append_cues (toplevel, object, cues);
+  cue_output (toplevel, cues, fp, type);
+  g_array_free (cues, TRUE);
+}
+
+
+/*! \brief Find the cues of a net, bus or pin. */
+static CUE_ENTRY *cue_entry_new (OBJECT *object)
+{
+  CUE_ENTRY *entry = g_new (CUE_ENTRY, 1);
+  int i;
+
+  for (i = 0; i < 2; i++) {
+    entry->x[i] = object->line->x[i];
+    entry->y[i] = object->line->y[i];
+  }
+  entry->pin_type = object->pin_type;
+  entry->whichend = object->whichend;
+  entry->end_cues = g_array_new (FALSE, FALSE, sizeof (CUE));
+  entry->mid_cues = g_array_new (FALSE, FALSE, sizeof (CUE));
+
   switch (object->type) {
     case (OBJ_NET):
-      /*
-       * s_cue_output_lowlevel handles both endpoints and junctions.
-       * The intention of the check is to skip drawing endpoint cues on nets
-       * that are not "fully connected".
-       * Junctions will be drawn correctly, as:
-       *  - net-net junctions are handled by s_cue_output_lowlevel_midpoints
-       *  - net-pin and pin-pin junctions are handled by case OBJ_PIN below
-       */
-      if (!o_net_is_fully_connected (toplevel, object)) {
-        s_cue_output_lowlevel(toplevel, object, 0, fp, type);
-        s_cue_output_lowlevel(toplevel, object, 1, fp, type);
-      }
-      break;
     case (OBJ_BUS):
-      s_cue_output_lowlevel(toplevel, object, 0, fp, type);
-      s_cue_output_lowlevel(toplevel, object, 1, fp, type);
+      cue_find_end (object, 0, entry->end_cues);
+      cue_find_end (object, 1, entry->end_cues);
+      cue_find_midpoints (object, entry->mid_cues);
       break;
     case (OBJ_PIN):
-      s_cue_output_lowlevel(toplevel, object, object->whichend, fp, type);
+      if (object->whichend == 0 || object->whichend == 1)
+        cue_find_end (object, object->whichend, entry->end_cues);
+      break;
+  }
+
+  return entry;
+}
+
+/*! \brief Check that a cache entry was made for an object as it is. */
+static gboolean cue_entry_matches (CUE_ENTRY *entry, OBJECT *object)
+{
+  return (entry->x[0] == object->line->x[0] &&
+          entry->y[0] == object->line->y[0] &&
+          entry->x[1] == object->line->x[1] &&
+          entry->y[1] == object->line->y[1] &&
+          entry->pin_type == object->pin_type &&
+          entry->whichend == object->whichend);
+}
+
+/*! \brief Find the page an object is on, through its parents. */
+static PAGE *cue_object_page (OBJECT *object)
+{
+  while (object->parent != NULL)
+    object = object->parent;
+
+  return object->page;
+}
+
+/*! \brief Drop the cached cues of an object and of anything in it. */
+static void cue_forget (GHashTable *cache, OBJECT *object)
+{
+  GList *iter;
+
+  g_hash_table_remove (cache, object);
+
+  if (object->type == OBJ_COMPLEX || object->type == OBJ_PLACEHOLDER) {
+    for (iter = object->complex->prim_objs;
+         iter != NULL;
+         iter = g_list_next (iter)) {
+      cue_forget (cache, iter->data);
+    }
+  }
+}
+
+/*! \brief Get the cues of an object
+ *  \par Function Description
+ *  Appends the junction and unconnected end cues of \a object to
+ *  \a cues.  For components, the cues of their pins are appended.
+ *  Other kinds of object have no cues.
+ *
+ *  The cues of objects on a page are cached on the page.  An
+ *  object's entry is dropped whenever its connections change, so
+ *  the cues are only worked out again for objects that changed.
+ *
+ *  \param [in]     toplevel  The TOPLEVEL object
+ *  \param [in]     object    The OBJECT to get cues for
+ *  \param [in,out] cues      A GArray of CUE to append the cues to.
+ */
+void s_cue_append_cues (TOPLEVEL *toplevel, OBJECT *object, GArray *cues)
+{
+  PAGE *page;
+  CUE_ENTRY *entry = NULL;
+  GList *iter;
+
+  switch (object->type) {
+    case (OBJ_NET):
+    case (OBJ_BUS):
+    case (OBJ_PIN):
       break;
+
+    case (OBJ_COMPLEX):
+    case (OBJ_PLACEHOLDER):
+      for (iter = object->complex->prim_objs;
+           iter != NULL;
+           iter = g_list_next (iter)) {
+        s_cue_append_cues (toplevel, iter->data, cues);
+      }
+      return;
+
     default:
       return;
   }
-  s_cue_output_lowlevel_midpoints(toplevel, object, fp, type);
+
+  page = cue_object_page (object);
+  if (page != NULL) {
+    if (page->cue_cache == NULL) {
+      page->cue_cache = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                               NULL, cue_entry_free);
+    }
+
+    entry = g_hash_table_lookup (page->cue_cache, object);
+    if (entry != NULL && !cue_entry_matches (entry, object)) {
+      g_hash_table_remove (page->cue_cache, object);
+      entry = NULL;
+    }
+  }
+
+  if (entry == NULL) {
+    entry = cue_entry_new (object);
+    if (page != NULL)
+      g_hash_table_insert (page->cue_cache, object, entry);
+  }
+
+  /*
+   * The intention of the check is to skip drawing endpoint cues on nets
+   * that are not "fully connected".  Whether a net is fully connected
+   * depends on the nets it is connected to as well, so it is not cached.
+   */
+  if (object->type != OBJ_NET ||
+      !o_net_is_fully_connected (toplevel, object)) {
+    g_array_append_vals (cues, entry->end_cues->data, entry->end_cues->len);
+  }
+  g_array_append_vals (cues, entry->mid_cues->data, entry->mid_cues->len);
+
+  if (page == NULL)
+    cue_entry_free (entry);
+}
+
+/*! \brief Forget the cached cues of an object removed from a page.
+ *  \param [in] page    The PAGE the object is removed from.
+ *  \param [in] object  The OBJECT removed.
+ */
+void s_cue_remove_object (PAGE *page, OBJECT *object)
+{
+  if (page->cue_cache != NULL)
+    cue_forget (page->cue_cache, object);
 }
 
+/*! \brief Free the cue cache of a page.
+ *  \param [in] page  The PAGE being deleted.
+ */
+void s_cue_free (PAGE *page)
+{
+  if (page->cue_cache != NULL) {
+    g_hash_table_destroy (page->cue_cache);
+    page->cue_cache = NULL;
+  }
+}
 
+/*! \brief Drop the cached cues of an object whose connections changed. */
+static void cue_conns_changed (TOPLEVEL *toplevel, OBJECT *object)
+{
+  PAGE *page = cue_object_page (object);
 
+  if (page != NULL && page->cue_cache != NULL)
+    cue_forget (page->cue_cache, object);
+}
+
+static void s_cue_init_toplevel (TOPLEVEL *toplevel)
+{
+  s_conn_append_conns_changed_hook (toplevel,
+                                    (ConnsChangedFunc) cue_conns_changed,
+                                    toplevel);
+}
+
+void s_cue_init (void)
+{
+  s_toplevel_append_new_hook ((NewToplevelFunc) s_cue_init_toplevel, NULL);
+}
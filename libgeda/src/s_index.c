@@ -0,0 +1,446 @@
+/* gEDA - GPL Electronic Design Automation
+ * libgeda - gEDA's library
+ * Copyright (C) 1998-2010 Ales Hvezda
+ * Copyright (C) 1998-2010 gEDA Contributors (see ChangeLog for details)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include <config.h>
+
+#include <stdio.h>
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#include "libgeda_priv.h"
+
+#ifdef HAVE_LIBDMALLOC
+#include <dmalloc.h>
+#endif
+
+/*! \file s_index.c
+ *  \brief Spatial index of the objects on a page
+ *
+ *  Finding the objects in an area of a page (under the mouse pointer,
+ *  inside a redraw region, inside a selection box) used to mean looking
+ *  at every object on the page.  The index divides the plane into
+ *  square cells and lists, for each cell, the objects whose bounds
+ *  overlap it, so that an area query only looks at the objects near
+ *  the area.  Objects covering many cells, such as title blocks, are
+ *  kept in a separate list that every query looks at.
+ *
+ *  The index is brought up to date lazily.  Adding an object to a page,
+ *  or recalculating or invalidating its bounds (see s_index_touch()),
+ *  only marks it, and marked objects are indexed again at the next
+ *  query.
+ *
+ *  Query results are in the order of the page's object list.
+ */
+
+/*! Size of a cell, in world units. */
+#define INDEX_CELL_SIZE 2000
+
+/*! Cell coordinates are clamped to a 16 bit range. */
+#define INDEX_CELL_MAX 32767
+
+/*! Objects covering more cells than this go in the large list. */
+#define INDEX_MAX_CELLS 64
+
+#define INDEX_CELL_KEY(x, y) \
+  GUINT_TO_POINTER ((((guint) (x) & 0xffff) << 16) | ((guint) (y) & 0xffff))
+
+typedef struct {
+  OBJECT *object;
+  guint order;                  /* position in the page's object list */
+  guint stamp;                  /* last query that looked at the entry */
+  gboolean indexed;             /* in the cells or the large list */
+  gboolean large;
+  int left, top, right, bottom; /* bounds of the object when indexed */
+  int x1, y1, x2, y2;           /* cells covered */
+} INDEX_ENTRY;
+
+struct st_page_index {
+  GHashTable *entries;          /* OBJECT -> INDEX_ENTRY */
+  GHashTable *cells;            /* cell key -> GPtrArray of INDEX_ENTRY */
+  GPtrArray *large;             /* INDEX_ENTRYs covering many cells */
+  GHashTable *dirty;            /* OBJECTs to index again */
+  guint next_order;
+  gboolean order_valid;
+  guint stamp;
+  gboolean updating;
+};
+
+
+/*! \brief Get the cell coordinate of a world coordinate. */
+static int index_cell (int w)
+{
+  int c;
+
+  /* Round towards minus infinity */
+  if (w >= 0)
+    c = w / INDEX_CELL_SIZE;
+  else
+    c = -((-w - 1) / INDEX_CELL_SIZE) - 1;
+
+  return CLAMP (c, -INDEX_CELL_MAX, INDEX_CELL_MAX);
+}
+
+static void index_cell_free (gpointer cell)
+{
+  g_ptr_array_free (cell, TRUE);
+}
+
+static PAGE_INDEX *index_get (PAGE *page)
+{
+  PAGE_INDEX *index = page->spatial_index;
+
+  if (index == NULL) {
+    index = g_new0 (PAGE_INDEX, 1);
+    index->entries = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                            NULL, g_free);
+    index->cells = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, index_cell_free);
+    index->large = g_ptr_array_new ();
+    index->dirty = g_hash_table_new (g_direct_hash, g_direct_equal);
+    index->order_valid = TRUE;
+    page->spatial_index = index;
+  }
+
+  return index;
+}
+
+/*! \brief Take an entry out of the cells it is listed in. */
+static void index_unlink (PAGE_INDEX *index, INDEX_ENTRY *entry)
+{
+  int x, y;
+
+  if (!entry->indexed)
+    return;
+
+  if (entry->large) {
+    g_ptr_array_remove_fast (index->large, entry);
+  } else {
+    for (x = entry->x1; x <= entry->x2; x++) {
+      for (y = entry->y1; y <= entry->y2; y++) {
+        GPtrArray *cell = g_hash_table_lookup (index->cells,
+                                               INDEX_CELL_KEY (x, y));
+        if (cell == NULL)
+          continue;
+        g_ptr_array_remove_fast (cell, entry);
+        if (cell->len == 0)
+          g_hash_table_remove (index->cells, INDEX_CELL_KEY (x, y));
+      }
+    }
+  }
+
+  entry->indexed = FALSE;
+}
+
+/*! \brief List an entry in the cells its object's bounds cover.
+ *  \par Function Description
+ *  Objects without bounds (e.g. hidden text while it is not shown) are
+ *  not listed.  Whoever changes whether they are shown has to
+ *  recalculate their bounds for them to be listed again.
+ */
+static void index_link (TOPLEVEL *toplevel, PAGE_INDEX *index,
+                        INDEX_ENTRY *entry)
+{
+  int x, y;
+
+  if (!world_get_single_object_bounds (toplevel, entry->object,
+                                       &entry->left, &entry->top,
+                                       &entry->right, &entry->bottom))
+    return;
+
+  entry->x1 = index_cell (entry->left);
+  entry->y1 = index_cell (entry->top);
+  entry->x2 = index_cell (entry->right);
+  entry->y2 = index_cell (entry->bottom);
+  entry->large = ((double) (entry->x2 - entry->x1 + 1)
+                  * (entry->y2 - entry->y1 + 1) > INDEX_MAX_CELLS);
+  entry->indexed = TRUE;
+
+  if (entry->large) {
+    g_ptr_array_add (index->large, entry);
+    return;
+  }
+
+  for (x = entry->x1; x <= entry->x2; x++) {
+    for (y = entry->y1; y <= entry->y2; y++) {
+      GPtrArray *cell = g_hash_table_lookup (index->cells,
+                                             INDEX_CELL_KEY (x, y));
+      if (cell == NULL) {
+        cell = g_ptr_array_new ();
+        g_hash_table_insert (index->cells, INDEX_CELL_KEY (x, y), cell);
+      }
+      g_ptr_array_add (cell, entry);
+    }
+  }
+}
+
+/*! \brief Index the marked objects again. */
+static void index_update (TOPLEVEL *toplevel, PAGE_INDEX *index)
+{
+  GHashTableIter iter;
+  gpointer object;
+
+  if (g_hash_table_size (index->dirty) == 0)
+    return;
+
+  /* Working out bounds recalculates them, which would mark the
+   * objects again */
+  index->updating = TRUE;
+
+  g_hash_table_iter_init (&iter, index->dirty);
+  while (g_hash_table_iter_next (&iter, &object, NULL)) {
+    INDEX_ENTRY *entry = g_hash_table_lookup (index->entries, object);
+
+    if (entry == NULL)
+      continue;
+    index_unlink (index, entry);
+    index_link (toplevel, index, entry);
+  }
+  g_hash_table_remove_all (index->dirty);
+
+  index->updating = FALSE;
+}
+
+/*! \brief Number the entries in the order of the page's object list. */
+static void index_renumber (PAGE *page, PAGE_INDEX *index)
+{
+  const GList *iter;
+  guint order = 0;
+
+  for (iter = s_page_objects (page); iter != NULL; iter = g_list_next (iter)) {
+    INDEX_ENTRY *entry = g_hash_table_lookup (index->entries, iter->data);
+
+    if (entry != NULL)
+      entry->order = ++order;
+  }
+
+  index->next_order = order;
+  index->order_valid = TRUE;
+}
+
+static gint index_compare_order (gconstpointer a, gconstpointer b)
+{
+  const INDEX_ENTRY *entry_a = *(INDEX_ENTRY * const *) a;
+  const INDEX_ENTRY *entry_b = *(INDEX_ENTRY * const *) b;
+
+  if (entry_a->order < entry_b->order) return -1;
+  if (entry_a->order > entry_b->order) return 1;
+  return 0;
+}
+
+/*! \brief Collect the entries in some cells not yet seen by this query. */
+static void index_collect (PAGE_INDEX *index, GPtrArray *cell,
+                           GPtrArray *found)
+{
+  guint i;
+
+  for (i = 0; i < cell->len; i++) {
+    INDEX_ENTRY *entry = g_ptr_array_index (cell, i);
+
+    if (entry->stamp != index->stamp) {
+      entry->stamp = index->stamp;
+      g_ptr_array_add (found, entry);
+    }
+  }
+}
+
+
+/*! \brief Add an object to the index of its page.
+ *  \par Function Description
+ *  Called when \a object is added to \a page.  The object is indexed
+ *  at the next query.
+ *
+ *  \param [in] page    The PAGE the object was added to.
+ *  \param [in] object  The OBJECT added.
+ */
+void s_index_add_object (PAGE *page, OBJECT *object)
+{
+  PAGE_INDEX *index = index_get (page);
+  INDEX_ENTRY *entry;
+
+  entry = g_new0 (INDEX_ENTRY, 1);
+  entry->object = object;
+  entry->order = ++index->next_order;
+  g_hash_table_insert (index->entries, object, entry);
+  g_hash_table_insert (index->dirty, object, object);
+}
+
+/*! \brief Remove an object from the index of its page.
+ *  \param [in] page    The PAGE the object is removed from.
+ *  \param [in] object  The OBJECT removed.
+ */
+void s_index_remove_object (PAGE *page, OBJECT *object)
+{
+  PAGE_INDEX *index = page->spatial_index;
+  INDEX_ENTRY *entry;
+
+  if (index == NULL)
+    return;
+
+  entry = g_hash_table_lookup (index->entries, object);
+  if (entry == NULL)
+    return;
+
+  index_unlink (index, entry);
+  g_hash_table_remove (index->dirty, object);
+  g_hash_table_remove (index->entries, object);
+}
+
+/*! \brief Note that the order of a page's objects has changed.
+ *  \par Function Description
+ *  Must be called when objects are put anywhere but at the end of the
+ *  page's object list.  The objects are numbered again at the next
+ *  query.
+ *
+ *  \param [in] page  The PAGE whose objects were reordered.
+ */
+void s_index_reorder (PAGE *page)
+{
+  if (page->spatial_index != NULL)
+    page->spatial_index->order_valid = FALSE;
+}
+
+/*! \brief Note that an object's bounds may have changed.
+ *  \par Function Description
+ *  Called whenever the bounds of \a object are recalculated or
+ *  invalidated.  If \a object is part of an object on a page, the
+ *  object on the page is indexed again at the next query.
+ *
+ *  \param [in] object  The OBJECT whose bounds changed.
+ */
+void s_index_touch (OBJECT *object)
+{
+  PAGE_INDEX *index;
+
+  while (object->parent != NULL)
+    object = object->parent;
+
+  if (object->page == NULL)
+    return;
+
+  index = object->page->spatial_index;
+  if (index == NULL || index->updating)
+    return;
+
+  g_hash_table_insert (index->dirty, object, object);
+}
+
+/*! \brief Find the objects on a page in some regions.
+ *  \par Function Description
+ *  Finds the objects whose bounds are inside, or intersect, any of
+ *  the regions, in the order they are in the page's object list.
+ *  If \a contained is TRUE, only the objects whose bounds lie
+ *  entirely inside one of the regions are found.
+ *
+ *  \param [in] toplevel   The TOPLEVEL object.
+ *  \param [in] page       The PAGE to find objects on.
+ *  \param [in] rects      The regions to look in.
+ *  \param [in] n_rects    The number of regions.
+ *  \param [in] contained  TRUE to skip objects only partly inside.
+ *  \return A newly allocated GList of OBJECTs.
+ */
+GList *s_index_query (TOPLEVEL *toplevel, PAGE *page,
+                      BOX *rects, int n_rects, gboolean contained)
+{
+  PAGE_INDEX *index = index_get (page);
+  GPtrArray *found;
+  GList *list = NULL;
+  guint n_cells;
+  int i;
+  gint j;
+
+  index_update (toplevel, index);
+  if (!index->order_valid)
+    index_renumber (page, index);
+
+  index->stamp++;
+  found = g_ptr_array_new ();
+
+  n_cells = g_hash_table_size (index->cells);
+  for (i = 0; i < n_rects; i++) {
+    int x1 = index_cell (rects[i].lower_x);
+    int y1 = index_cell (rects[i].lower_y);
+    int x2 = index_cell (rects[i].upper_x);
+    int y2 = index_cell (rects[i].upper_y);
+    int x, y;
+
+    /* Big regions are cheaper to handle by going through every cell */
+    if ((double) (x2 - x1 + 1) * (y2 - y1 + 1) > n_cells) {
+      GHashTableIter iter;
+      gpointer cell;
+
+      g_hash_table_iter_init (&iter, index->cells);
+      while (g_hash_table_iter_next (&iter, NULL, &cell))
+        index_collect (index, cell, found);
+      break;
+    }
+
+    for (x = x1; x <= x2; x++) {
+      for (y = y1; y <= y2; y++) {
+        GPtrArray *cell = g_hash_table_lookup (index->cells,
+                                               INDEX_CELL_KEY (x, y));
+        if (cell != NULL)
+          index_collect (index, cell, found);
+      }
+    }
+  }
+  index_collect (index, index->large, found);
+
+  g_ptr_array_sort (found, index_compare_order);
+
+  for (j = found->len - 1; j >= 0; j--) {
+    INDEX_ENTRY *entry = g_ptr_array_index (found, j);
+
+    for (i = 0; i < n_rects; i++) {
+      if (contained ? (entry->left   >= rects[i].lower_x &&
+                       entry->right  <= rects[i].upper_x &&
+                       entry->top    >= rects[i].lower_y &&
+                       entry->bottom <= rects[i].upper_y)
+                    : (entry->right  >= rects[i].lower_x &&
+                       entry->left   <= rects[i].upper_x &&
+                       entry->top    <= rects[i].upper_y &&
+                       entry->bottom >= rects[i].lower_y)) {
+        list = g_list_prepend (list, entry->object);
+        break;
+      }
+    }
+  }
+
+  g_ptr_array_free (found, TRUE);
+
+  return list;
+}
+
+/*! \brief Free the index of a page.
+ *  \param [in] page  The PAGE being deleted.
+ */
+void s_index_free (PAGE *page)
+{
+  PAGE_INDEX *index = page->spatial_index;
+
+  if (index == NULL)
+    return;
+
+  g_hash_table_destroy (index->cells);
+  g_hash_table_destroy (index->entries);
+  g_hash_table_destroy (index->dirty);
+  g_ptr_array_free (index->large, TRUE);
+  g_free (index);
+  page->spatial_index = NULL;
+}
@@ -60,8 +60,10 @@ static gint global_pid = 0;
 
 /* Called just before removing an OBJECT from a PAGE. */
 static void
-object_added (TOPLEVEL *toplevel, PAGE *page, OBJECT *object)
+object_added (TOPLEVEL *toplevel, PAGE *page, GList *link)
 {
+  OBJECT *object = link->data;
+
   /* Set up object parent pointer */
 #ifndef NDEBUG
   if (object->page != NULL) {
@@ -70,12 +72,20 @@ object_added (TOPLEVEL *toplevel, PAGE *page, OBJECT *object)
 #endif
   object->page = page;
 
+  /* Objects on a page own what is inside them */
+  if (object->type == OBJ_COMPLEX || object->type == OBJ_PLACEHOLDER)
+    o_complex_unshare (toplevel, object);
+
   /* Add object to tile system. */
   s_tile_add_object (toplevel, object);
 
+  s_index_add_object (page, object);
+
   /* Update object connection tracking */
   s_conn_update_object (toplevel, object);
 
+  s_undo_object_added (page, link);
+
   o_emit_change_notify (toplevel, object);
 }
 
@@ -103,6 +113,10 @@ pre_object_removed (TOPLEVEL *toplevel, PAGE *page, OBJECT *object)
 
   /* Remove object from tile system */
   s_tile_remove_object (object);
+
+  s_index_remove_object (page, object);
+  s_cue_remove_object (page, object);
+  s_undo_object_removed (page, object);
 }
 
 /*! \brief create a new page object
@@ -244,6 +258,8 @@ void s_page_delete (TOPLEVEL *toplevel, PAGE *page)
   s_tile_print(toplevel, page);
 #endif
   s_tile_free_all (page);
+  s_index_free (page);
+  s_cue_free (page);
 
   /* free current page undo structs */
   s_undo_free_all (toplevel, page); 
@@ -632,8 +648,10 @@ gint s_page_autosave (TOPLEVEL *toplevel)
  */
 void s_page_append (TOPLEVEL *toplevel, PAGE *page, OBJECT *object)
 {
-  page->_object_list = g_list_append (page->_object_list, object);
-  object_added (toplevel, page, object);
+  GList *link = g_list_prepend (NULL, object);
+
+  page->_object_list = g_list_concat (page->_object_list, link);
+  object_added (toplevel, page, link);
 }
 
 /*! \brief Append a GList of OBJECTs to the PAGE
@@ -651,8 +669,51 @@ void s_page_append_list (TOPLEVEL *toplevel, PAGE *page, GList *obj_list)
   GList *iter;
   page->_object_list = g_list_concat (page->_object_list, obj_list);
   for (iter = obj_list; iter != NULL; iter = g_list_next (iter)) {
-    object_added (toplevel, page, iter->data);
+    object_added (toplevel, page, iter);
+  }
+}
+
+/*! \brief Insert a GList of OBJECTs into the PAGE after a given link
+ *
+ *  \par Function Description
+ *  Links the passed OBJECT GList into the PAGE's object_list directly
+ *  after the list element \a after, or at the start of the list if
+ *  \a after is NULL.  No search is done: \a after must be an element
+ *  of the list returned by s_page_objects() for \a page.
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] page      The PAGE the objects are being added to.
+ *  \param [in] after     The element of the object list to insert
+ *                        after, or NULL.
+ *  \param [in] obj_list  The OBJECT list being added to the page.
+ */
+void s_page_insert_list_after (TOPLEVEL *toplevel, PAGE *page,
+                               GList *after, GList *obj_list)
+{
+  GList *last;
+  GList *iter;
+
+  if (obj_list == NULL)
+    return;
+
+  last = g_list_last (obj_list);
+
+  if (after == NULL) {
+    page->_object_list = g_list_concat (obj_list, page->_object_list);
+  } else {
+    last->next = after->next;
+    if (after->next != NULL)
+      after->next->prev = last;
+    after->next = obj_list;
+    obj_list->prev = after;
+  }
+
+  for (iter = obj_list; ; iter = g_list_next (iter)) {
+    object_added (toplevel, page, iter);
+    if (iter == last)
+      break;
   }
+  s_index_reorder (page);
 }
 
 /*! \brief Remove an OBJECT from the PAGE
@@ -697,7 +758,8 @@ s_page_replace (TOPLEVEL *toplevel, PAGE *page,
 
   pre_object_removed (toplevel, page, object1);
   iter->data = object2;
-  object_added (toplevel, page, object2);
+  object_added (toplevel, page, iter);
+  s_index_reorder (page);
 }
 
 /*! \brief Remove and free all OBJECTs from the PAGE
@@ -774,35 +836,40 @@ GList *s_page_objects_in_region (TOPLEVEL *toplevel, PAGE *page,
  *  \param [in] page      The PAGE to find objects on.
  *  \param [in] rects     The BOX regions to check.
  *  \param [in] n_rects   The number of regions.
- *  \return The GList of OBJECTs in the region.
+ *  \return The GList of OBJECTs in the region, in the order they are
+ *          on the page.
  */
 GList *s_page_objects_in_regions (TOPLEVEL *toplevel, PAGE *page,
                                   BOX *rects, int n_rects)
 {
-  GList *iter;
-  GList *list = NULL;
-  int i;
-
-  for (iter = page->_object_list; iter != NULL; iter = g_list_next (iter)) {
-    OBJECT *object = iter->data;
-    int left, top, right, bottom;
-    int visible;
-
-    visible = world_get_single_object_bounds (toplevel, object,
-                                              &left, &top, &right, &bottom);
-    if (visible) {
-      for (i = 0; i < n_rects; i++) {
-        if (right  >= rects[i].lower_x &&
-            left   <= rects[i].upper_x &&
-            top    <= rects[i].upper_y &&
-            bottom >= rects[i].lower_y) {
-          list = g_list_prepend (list, object);
-          break;
-        }
-      }
-    }
-  }
+  return s_index_query (toplevel, page, rects, n_rects, FALSE);
+}
+
+/*! \brief Find the objects entirely inside a given region
+ *
+ *  \par Function Description
+ *  Finds the objects whose bounds lie completely inside the passed
+ *  box shaped region.  Objects which only intersect it are skipped.
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] page      The PAGE to find objects on.
+ *  \param [in] min_x     The smaller X coordinate of the region.
+ *  \param [in] min_y     The smaller Y coordinate of the region.
+ *  \param [in] max_x     The larger  X coordinate of the region.
+ *  \param [in] max_y     The larger  Y coordinate of the region.
+ *  \return The GList of OBJECTs inside the region, in the order they
+ *          are on the page.
+ */
+GList *s_page_objects_inside_region (TOPLEVEL *toplevel, PAGE *page,
+                                     int min_x, int min_y,
+                                     int max_x, int max_y)
+{
+  BOX rect;
+
+  rect.lower_x = min_x;
+  rect.lower_y = min_y;
+  rect.upper_x = max_x;
+  rect.upper_y = max_y;
 
-  list = g_list_reverse (list);
-  return list;
+  return s_index_query (toplevel, page, &rect, 1, TRUE);
 }
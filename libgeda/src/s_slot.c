@@ -73,37 +73,110 @@ char *s_slot_search_slot (OBJECT *object, OBJECT **return_found)
 }
 
 
-/*! \brief Search for slotdef attribute.
+/*! \brief Parse the slotdef attributes of an object.
  *  \par Function Description
- *  Search for slotdef attribute.
+ *  Reads every slotdef=#:#,#,#... attribute of \a object (attached or
+ *  inherited) in a single pass, and returns a table mapping each slot
+ *  number, as written before the colon, to the pin numbers listed
+ *  after it.  The n-th pin number of a slot belongs to the pin with
+ *  pinseq=n.  Where a slot is defined more than once, the first
+ *  definition wins; slotdefs without a colon are ignored.
  *
- *  \param [in] object      The OBJECT list to search.
- *  \param [in] slotnumber  The slot number to search for.
- *  \return Character string with attribute value, NULL otherwise.
+ *  \param [in] object  The OBJECT whose slotdefs to parse.
+ *  \return A new GHashTable from slot number strings to NULL terminated
+ *          arrays of pin number strings.
  *
  *  \warning
- *  Caller must g_free returned character string.
+ *  Caller must g_hash_table_destroy returned table.
+ */
+GHashTable *s_slot_parse_slotdefs (OBJECT *object)
+{
+  GHashTable *slotdefs;
+  GList *attributes;
+  GList *iter;
+  GPtrArray *pins;
+  gchar **tokens;
+  char *name;
+  char *value;
+  char *colon;
+  int i;
+
+  slotdefs = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                    g_free, (GDestroyNotify) g_strfreev);
+
+  attributes = o_attrib_return_attribs (object);
+  for (iter = attributes; iter != NULL; iter = g_list_next (iter)) {
+    if (!o_attrib_get_name_value (iter->data, &name, &value))
+      continue;
+
+    colon = (strcmp (name, "slotdef") == 0) ? strchr (value, ':') : NULL;
+    g_free (name);
+
+    if (colon == NULL) {
+      g_free (value);
+      continue;
+    }
+
+    *colon = '\0';
+    if (g_hash_table_lookup (slotdefs, value) != NULL) {
+      g_free (value);
+      continue;
+    }
+
+    /* loop on all pins found in slotdef= attribute */
+    pins = g_ptr_array_new ();
+    tokens = g_strsplit_set (colon + 1, DELIMITERS, -1);
+    for (i = 0; tokens[i] != NULL; i++) {
+      if (*tokens[i] != '\0')
+        g_ptr_array_add (pins, g_strdup (tokens[i]));
+    }
+    g_strfreev (tokens);
+    g_ptr_array_add (pins, NULL);
+
+    g_hash_table_insert (slotdefs, g_strdup (value),
+                         g_ptr_array_free (pins, FALSE));
+    g_free (value);
+  }
+  g_list_free (attributes);
+
+  return slotdefs;
+}
+
+
+/*! \brief Index the pins of a component by pinseq.
+ *  \par Function Description
+ *  Returns a table from pinseq= values to the pins of \a object.
+ *  Where several pins have the same pinseq, the first one wins, as
+ *  with o_complex_find_pin_by_attribute().
+ *
+ *  \param [in] object  The component OBJECT.
+ *  \return A new GHashTable, to be freed with g_hash_table_destroy().
  */
-static char *s_slot_search_slotdef (OBJECT *object, int slotnumber)
+static GHashTable *s_slot_pinseq_index (OBJECT *object)
 {
-  int counter = 0;
-  char *slotdef;
-  char *search_for;
+  GHashTable *index;
+  GList *iter;
+  OBJECT *o_current;
+  char *pinseq;
 
-  search_for = g_strdup_printf ("%d:", slotnumber);
+  index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 
-  while (1) {
-    slotdef = o_attrib_search_object_attribs_by_name (object, "slotdef",
-                                                      counter++);
-    if (slotdef == NULL ||
-        strncmp (slotdef, search_for, strlen (search_for)) == 0)
-      break;
+  for (iter = object->complex->prim_objs; iter != NULL;
+       iter = g_list_next (iter)) {
+    o_current = iter->data;
 
-    g_free (slotdef);
+    if (o_current->type != OBJ_PIN)
+      continue;
+
+    pinseq = o_attrib_search_object_attribs_by_name (o_current, "pinseq", 0);
+    if (pinseq == NULL || g_hash_table_lookup (index, pinseq) != NULL) {
+      g_free (pinseq);
+      continue;
+    }
+    g_hash_table_insert (index, pinseq, o_current);
   }
 
-  g_free (search_for);
-  return slotdef;
+  return index;
 }
 
 
@@ -126,14 +199,17 @@ void s_slot_update_object (TOPLEVEL *toplevel, OBJECT *object)
   OBJECT *o_pin_object;
   OBJECT *o_pinnum_attrib;
   GList *attributes;
+  GHashTable *slotdefs;
+  GHashTable *pinseq_index;
   char *string;
-  char *slotdef;
   char *pinseq;
+  gchar **pins;
   int slot;
   int slot_string;
   int pin_counter;    /* Internal pin counter private to this fcn. */
-  char* current_pin;  /* text from slotdef= to be made into pinnumber= */
-  char* cptr;         /* char pointer pointing to pinnumbers in slotdef=#:#,#,# string */
+  int i;
+
+  o_complex_unshare (toplevel, object);
 
   /* For this particular graphic object (component instantiation) */
   /* get the slot number as a string */
@@ -155,44 +231,33 @@ void s_slot_update_object (TOPLEVEL *toplevel, OBJECT *object)
 
   /* OK, now that we have the slot number, use it to get the */
   /* corresponding slotdef=#:#,#,# string.  */
-  slotdef = s_slot_search_slotdef (object, slot);
+  slotdefs = s_slot_parse_slotdefs (object);
+  string = g_strdup_printf ("%d", slot);
+  pins = g_hash_table_lookup (slotdefs, string);
+  g_free (string);
 
-  if (slotdef == NULL) {
+  if (pins == NULL) {
     if (slot_string) /* only an error if there's a slot string */
       s_log_message (_("Did not find slotdef=#:#,#,#... attribute\n"));
+    g_hash_table_destroy (slotdefs);
     return;
   }
 
-  if (!strstr (slotdef, ":")) {
-    /* Didn't find proper slotdef=#:... put warning into log */
-    s_log_message (_("Improper slotdef syntax: missing \":\".\n"));
-    g_free (slotdef);
-    return;
-  }
-
-  /* skip over slotdef number */
-  /* slotdef is in the form #:#,#,# */
-  /* this code skips first #: */
-  cptr = slotdef;
-  while (*cptr != '\0' && *cptr != ':') {
-    cptr++;
-  }
-  cptr++; /* skip colon */
-
-  if (*cptr == '\0') {
+  if (pins[0] == NULL) {
     s_log_message (_("Did not find proper slotdef=#:#,#,#... attribute\n"));
-    g_free (slotdef);
+    g_hash_table_destroy (slotdefs);
     return;
   }
 
-  /* loop on all pins found in slotdef= attribute */
+  /* Look the pins up by pinseq once, rather than searching every pin
+   * for each pin number in the slotdef */
+  pinseq_index = s_slot_pinseq_index (object);
+
   pin_counter = 1;  /* internal pin_counter */
-  /* get current pinnumber= from slotdef= attrib */
-  current_pin = strtok (cptr, DELIMITERS);
-  while (current_pin != NULL) {
+  for (i = 0; pins[i] != NULL; i++) {
     /* get pin on this component with pinseq == pin_counter */
     pinseq = g_strdup_printf ("%d", pin_counter);
-    o_pin_object = o_complex_find_pin_by_attribute (object, "pinseq", pinseq);
+    o_pin_object = g_hash_table_lookup (pinseq_index, pinseq);
     g_free (pinseq);
 
     if (o_pin_object != NULL) {
@@ -205,16 +270,15 @@ void s_slot_update_object (TOPLEVEL *toplevel, OBJECT *object)
       if (o_pinnum_attrib != NULL) {
         o_text_set_string (toplevel,
                            o_pinnum_attrib,
-                           g_strdup_printf ("pinnumber=%s", current_pin));
+                           g_strdup_printf ("pinnumber=%s", pins[i]));
       }
 
       pin_counter++;
     } else {
       s_log_message (_("component missing pinseq= attribute\n"));
     }
-
-    current_pin = strtok (NULL, DELIMITERS);
   }
 
-  g_free (slotdef);
+  g_hash_table_destroy (pinseq_index);
+  g_hash_table_destroy (slotdefs);
 }
@@ -21,6 +21,9 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
 #ifdef HAVE_STDLIB_H
 #include <stdlib.h>
 #endif
@@ -34,6 +37,103 @@
 #include <dmalloc.h>
 #endif
 
+/*! \file s_undo.c
+ *  \brief Undo stack
+ *
+ *  Each page keeps a stack of UNDO entries, one per step.  A step can
+ *  be saved as a whole copy of the page (a file, or an object list),
+ *  or as deltas: the changes made to the page since the previous step.
+ *
+ *  For delta undo, the page contents are seen as a sequence of groups,
+ *  one per toplevel object, made of the object and its attached
+ *  attributes, identified by the sid of the object and held as text in
+ *  the libgeda file format.  The groups of the page at the current
+ *  undo step are kept in the page's undo_state.
+ *
+ *  The undo_state is a journal: the change notifications, and the
+ *  page adding and removing objects, mark the groups they touch as
+ *  dirty.  s_undo_diff_page() saves only the dirty groups again to
+ *  produce the deltas of a new step, and s_undo_apply_deltas() replays
+ *  the deltas of a step forwards or backwards, touching only the
+ *  groups that changed.  The journal also knows where each object is
+ *  in the page's object list, so that neither has to search the page.
+ */
+
+/*! A toplevel object and its attributes, as saved in a page state. */
+typedef struct {
+  char *text;         /* the group in the libgeda file format */
+  int prev;           /* sid of the preceding group, or -1 */
+} UNDO_GROUP;
+
+/*! The change of a single group between two undo steps. */
+typedef struct {
+  int sid;
+  char *before;       /* group text before the step, or NULL if absent */
+  char *after;        /* group text after the step, or NULL if absent */
+  int before_prev, after_prev;
+} UNDO_DELTA;
+
+/*! The delta undo journal of a page. */
+struct st_undo_state {
+  GHashTable *groups; /* sid -> UNDO_GROUP, the page at undo_current */
+  GHashTable *links;  /* sid -> element of the page's object list */
+  GHashTable *dirty;  /* sids of the groups that may have changed */
+  GPtrArray *carried; /* deltas of a dropped step, for the next one */
+};
+
+static void s_undo_group_free (UNDO_GROUP *group)
+{
+  g_free (group->text);
+  g_free (group);
+}
+
+static UNDO_STATE *s_undo_state_new (void)
+{
+  UNDO_STATE *state = g_new (UNDO_STATE, 1);
+
+  state->groups = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                         (GDestroyNotify) s_undo_group_free);
+  state->links = g_hash_table_new (g_direct_hash, g_direct_equal);
+  state->dirty = g_hash_table_new (g_direct_hash, g_direct_equal);
+  state->carried = NULL;
+
+  return state;
+}
+
+static void s_undo_delta_free (UNDO_DELTA *delta)
+{
+  g_free (delta->before);
+  g_free (delta->after);
+  g_free (delta);
+}
+
+static void s_undo_state_free (UNDO_STATE *state)
+{
+  if (state->carried != NULL) {
+    g_ptr_array_foreach (state->carried, (GFunc) s_undo_delta_free, NULL);
+    g_ptr_array_free (state->carried, TRUE);
+  }
+  g_hash_table_destroy (state->groups);
+  g_hash_table_destroy (state->links);
+  g_hash_table_destroy (state->dirty);
+  g_free (state);
+}
+
+/*! \brief Free the deltas of an undo entry. */
+static void s_undo_free_deltas (UNDO *u_current)
+{
+  guint i;
+
+  if (u_current->deltas == NULL)
+    return;
+
+  for (i = 0; i < u_current->deltas->len; i++) {
+    s_undo_delta_free (g_ptr_array_index (u_current->deltas, i));
+  }
+  g_ptr_array_free (u_current->deltas, TRUE);
+  u_current->deltas = NULL;
+}
+
 /*! \todo Finish function documentation!!!
  *  \brief
  *  \par Function Description
@@ -85,6 +185,7 @@ UNDO *s_undo_new_head(void)
   u_new->type = -1;
   u_new->filename = NULL;
   u_new->object_list = NULL;
+  u_new->deltas = NULL;
   u_new->left = u_new->right = u_new->top = u_new->bottom = -1;
 
   u_new->page_control = 0;
@@ -123,6 +224,7 @@ UNDO *s_undo_add (UNDO *head, int type, char *filename, GList *object_list,
   u_new->filename = g_strdup (filename);
 	
   u_new->object_list = object_list;
+  u_new->deltas = NULL;
 
   u_new->type = type;
 
@@ -167,6 +269,10 @@ void s_undo_print_all( UNDO *head )
     if (u_current->object_list) {
       print_struct_forw (u_current->object_list);
     }
+
+    if (u_current->deltas) {
+      printf("%d deltas\n", u_current->deltas->len);
+    }
 		
     printf("\t%d %d %d %d\n", u_current->left, u_current->top,
            u_current->right, u_current->bottom);
@@ -200,6 +306,8 @@ void s_undo_destroy_all(TOPLEVEL *toplevel, UNDO *head)
       u_current->object_list = NULL;
     }
 
+    s_undo_free_deltas (u_current);
+
     g_free(u_current);
     u_current = u_prev;
   }
@@ -240,6 +348,8 @@ void s_undo_remove(TOPLEVEL *toplevel, UNDO *head, UNDO *u_tos)
         u_current->object_list = NULL;
       }
 
+      s_undo_free_deltas (u_current);
+
       g_free(u_current);
       return;
     }
@@ -272,6 +382,8 @@ void s_undo_remove_rest(TOPLEVEL *toplevel, UNDO *head)
       u_current->object_list = NULL;
     }
 
+    s_undo_free_deltas (u_current);
+
     g_free(u_current);
     u_current = u_next;
   }
@@ -289,7 +401,7 @@ int s_undo_levels(UNDO *head)
 	
   u_current = head;
   while (u_current != NULL) {
-    if (u_current->filename || u_current->object_list) {
+    if (u_current->filename || u_current->object_list || u_current->deltas) {
       count++;	
     } 	
 		
@@ -308,6 +420,7 @@ void s_undo_init(PAGE *p_current)
 {
 	p_current->undo_tos = p_current->undo_bottom = NULL;
 	p_current->undo_current = NULL;
+	p_current->undo_state = NULL;
 }
 
 /*! \todo Finish function documentation!!!
@@ -321,4 +434,480 @@ void s_undo_free_all(TOPLEVEL *toplevel, PAGE *p_current)
   p_current->undo_bottom = NULL;
   p_current->undo_tos = NULL;
   p_current->undo_current = NULL;
+
+  if (p_current->undo_state != NULL) {
+    s_undo_state_free (p_current->undo_state);
+    p_current->undo_state = NULL;
+  }
+}
+
+/*! \brief Find the toplevel object whose group \a object belongs to. */
+static OBJECT *s_undo_group_root (OBJECT *object)
+{
+  while (object->parent != NULL)
+    object = object->parent;
+
+  if (object->attached_to != NULL)
+    object = object->attached_to;
+
+  return object;
+}
+
+/*! \brief Mark the group of a toplevel object as changed. */
+static void s_undo_mark (PAGE *page, OBJECT *object)
+{
+  if (page == NULL || page->undo_state == NULL)
+    return;
+
+  g_hash_table_insert (page->undo_state->dirty,
+                       GINT_TO_POINTER (object->sid), GINT_TO_POINTER (TRUE));
+}
+
+/*! \brief Find the first toplevel object after \a link in a page. */
+static OBJECT *s_undo_next_group (GList *link)
+{
+  OBJECT *object;
+
+  for (link = g_list_next (link); link != NULL; link = g_list_next (link)) {
+    object = link->data;
+    if (object->attached_to == NULL)
+      return object;
+  }
+
+  return NULL;
+}
+
+/*! \brief Find the sid of the last toplevel object before \a link. */
+static int s_undo_prev_sid (GList *link)
+{
+  OBJECT *object;
+
+  for (link = g_list_previous (link); link != NULL;
+       link = g_list_previous (link)) {
+    object = link->data;
+    if (object->attached_to == NULL)
+      return object->sid;
+  }
+
+  return -1;
+}
+
+/*! \brief Note an object added to a page in its undo journal.
+ *  \par Function Description
+ *  Called by the page once \a link has been put in its object list.
+ *
+ *  \param [in] page  The page the object was added to.
+ *  \param [in] link  The element of the page's object list holding it.
+ */
+void s_undo_object_added (PAGE *page, GList *link)
+{
+  OBJECT *object = link->data;
+
+  if (page->undo_state == NULL)
+    return;
+
+  g_hash_table_insert (page->undo_state->links,
+                       GINT_TO_POINTER (object->sid), link);
+  s_undo_mark (page, s_undo_group_root (object));
+}
+
+/*! \brief Note an object about to be removed from a page.
+ *  \par Function Description
+ *  Called by the page while \a object is still in its object list.
+ *  The group after a removed toplevel object follows another group
+ *  from then on, so it is marked as well.
+ *
+ *  \param [in] page    The page the object is removed from.
+ *  \param [in] object  The object being removed.
+ */
+void s_undo_object_removed (PAGE *page, OBJECT *object)
+{
+  GList *link;
+  OBJECT *next;
+
+  if (page->undo_state == NULL)
+    return;
+
+  link = g_hash_table_lookup (page->undo_state->links,
+                              GINT_TO_POINTER (object->sid));
+  if (link != NULL && object->attached_to == NULL) {
+    next = s_undo_next_group (link);
+    if (next != NULL)
+      s_undo_mark (page, next);
+  }
+
+  g_hash_table_remove (page->undo_state->links, GINT_TO_POINTER (object->sid));
+  s_undo_mark (page, s_undo_group_root (object));
+}
+
+/*! \brief Change notification handler for the undo journal. */
+static void s_undo_object_changed (void *user_data, OBJECT *object)
+{
+  OBJECT *root = s_undo_group_root (object);
+
+  s_undo_mark (root->page, root);
+}
+
+static void s_undo_init_toplevel (TOPLEVEL *toplevel)
+{
+  o_add_change_notify (toplevel,
+                       (ChangeNotifyFunc) s_undo_object_changed,
+                       (ChangeNotifyFunc) s_undo_object_changed, NULL);
+}
+
+void s_undo_init_hooks (void)
+{
+  s_toplevel_append_new_hook ((NewToplevelFunc) s_undo_init_toplevel, NULL);
+}
+
+/*! \brief Save a toplevel object and its attributes as text. */
+static char *s_undo_group_text (TOPLEVEL *toplevel, OBJECT *object)
+{
+  GList link;
+  char *text;
+
+  link.data = object;
+  link.next = NULL;
+  link.prev = NULL;
+
+  text = o_save_objects (toplevel, &link, FALSE);
+  return (text != NULL) ? text : g_strdup ("");
+}
+
+/*! \brief Record the change of a group in a list of deltas. */
+static void s_undo_add_delta (GPtrArray *deltas, int sid,
+                              UNDO_GROUP *before, UNDO_GROUP *after)
+{
+  UNDO_DELTA *delta = g_new (UNDO_DELTA, 1);
+
+  delta->sid = sid;
+  delta->before = (before != NULL) ? g_strdup (before->text) : NULL;
+  delta->before_prev = (before != NULL) ? before->prev : -1;
+  delta->after = (after != NULL) ? g_strdup (after->text) : NULL;
+  delta->after_prev = (after != NULL) ? after->prev : -1;
+
+  g_ptr_array_add (deltas, delta);
+}
+
+/*! \brief Bring the groups of a page's undo journal up to date.
+ *  \par Function Description
+ *  Saves again every group marked as changed, and records in \a deltas,
+ *  if not NULL, those that were added, removed or whose content
+ *  changed.  A group that appears or goes away while its object stays
+ *  in the object list (an attribute being attached or detached) also
+ *  changes what the next group follows, so that one is looked at too.
+ */
+static void s_undo_update_state (TOPLEVEL *toplevel, PAGE *page,
+                                 GPtrArray *deltas)
+{
+  UNDO_STATE *state = page->undo_state;
+  GList *sids;
+  GList *iter;
+
+  while (g_hash_table_size (state->dirty) > 0) {
+    sids = g_hash_table_get_keys (state->dirty);
+    g_hash_table_remove_all (state->dirty);
+
+    for (iter = sids; iter != NULL; iter = g_list_next (iter)) {
+      GList *link = g_hash_table_lookup (state->links, iter->data);
+      OBJECT *object = (link != NULL) ? link->data : NULL;
+      UNDO_GROUP *old = g_hash_table_lookup (state->groups, iter->data);
+      UNDO_GROUP *group = NULL;
+      OBJECT *next;
+
+      if (object != NULL && object->attached_to == NULL) {
+        group = g_new (UNDO_GROUP, 1);
+        group->text = s_undo_group_text (toplevel, object);
+        group->prev = s_undo_prev_sid (link);
+      }
+
+      if (link != NULL && (group == NULL) != (old == NULL)) {
+        next = s_undo_next_group (link);
+        if (next != NULL)
+          s_undo_mark (page, next);
+      }
+
+      if (deltas != NULL &&
+          (group == NULL ? old != NULL
+                         : old == NULL || strcmp (old->text, group->text) != 0)) {
+        s_undo_add_delta (deltas, GPOINTER_TO_INT (iter->data), old, group);
+      }
+
+      if (group != NULL) {
+        g_hash_table_insert (state->groups, iter->data, group);
+      } else {
+        g_hash_table_remove (state->groups, iter->data);
+      }
+    }
+
+    g_list_free (sids);
+  }
+}
+
+/*! \brief Join the deltas of two consecutive undo steps.
+ *  \par Function Description
+ *  Returns the deltas going from the state before \a first to the state
+ *  after \a later.  A group changed by both keeps its text from before
+ *  the first step and from after the later one, and is left out if
+ *  that ends up changing nothing.  Both arrays are used up.
+ */
+static GPtrArray *s_undo_merge_deltas (GPtrArray *first, GPtrArray *later)
+{
+  GHashTable *by_sid = g_hash_table_new (g_direct_hash, g_direct_equal);
+  GPtrArray *merged = g_ptr_array_new ();
+  UNDO_DELTA *delta, *earlier;
+  guint i;
+
+  for (i = 0; i < first->len; i++) {
+    delta = g_ptr_array_index (first, i);
+    g_hash_table_insert (by_sid, GINT_TO_POINTER (delta->sid), delta);
+  }
+
+  for (i = 0; i < later->len; i++) {
+    delta = g_ptr_array_index (later, i);
+    earlier = g_hash_table_lookup (by_sid, GINT_TO_POINTER (delta->sid));
+    if (earlier == NULL)
+      continue;
+
+    g_free (earlier->after);
+    earlier->after = delta->after;
+    earlier->after_prev = delta->after_prev;
+    delta->after = NULL;
+    s_undo_delta_free (delta);
+    g_ptr_array_index (later, i) = NULL;
+  }
+
+  for (i = 0; i < first->len; i++) {
+    delta = g_ptr_array_index (first, i);
+    if (g_strcmp0 (delta->before, delta->after) == 0) {
+      s_undo_delta_free (delta);
+    } else {
+      g_ptr_array_add (merged, delta);
+    }
+  }
+  for (i = 0; i < later->len; i++) {
+    delta = g_ptr_array_index (later, i);
+    if (delta != NULL)
+      g_ptr_array_add (merged, delta);
+  }
+
+  g_hash_table_destroy (by_sid);
+  g_ptr_array_free (first, TRUE);
+  g_ptr_array_free (later, TRUE);
+  return merged;
+}
+
+/*! \brief Record the changes of a page since the current undo step.
+ *  \par Function Description
+ *  Returns the groups of \a page that were added, removed or changed
+ *  since the last call, and brings the page's undo_state up to date.
+ *  Only the groups the journal marked as changed are saved and
+ *  compared.  The first time this is called for a page the journal is
+ *  started from the whole page, and no deltas are returned.
+ *
+ *  Only the content of groups is compared; a group that merely follows
+ *  another one because groups were added or removed before it is not
+ *  recorded.
+ *
+ *  \param [in] toplevel  The TOPLEVEL object.
+ *  \param [in] page      The page to compare.
+ *  \return A new GPtrArray of deltas, to be stored in an UNDO entry.
+ */
+GPtrArray *s_undo_diff_page (TOPLEVEL *toplevel, PAGE *page)
+{
+  GPtrArray *deltas = g_ptr_array_new ();
+  const GList *iter;
+  OBJECT *o_current;
+
+  if (page->undo_state == NULL) {
+    page->undo_state = s_undo_state_new ();
+
+    for (iter = s_page_objects (page); iter != NULL;
+         iter = g_list_next (iter)) {
+      o_current = iter->data;
+      g_hash_table_insert (page->undo_state->links,
+                           GINT_TO_POINTER (o_current->sid), (GList *) iter);
+      if (o_current->attached_to == NULL)
+        s_undo_mark (page, o_current);
+    }
+
+    s_undo_update_state (toplevel, page, NULL);
+    return deltas;
+  }
+
+  s_undo_update_state (toplevel, page, deltas);
+
+  if (page->undo_state->carried != NULL) {
+    deltas = s_undo_merge_deltas (page->undo_state->carried, deltas);
+    page->undo_state->carried = NULL;
+  }
+
+  return deltas;
+}
+
+/*! \brief Keep the deltas of an undo step that is dropped.
+ *  \par Function Description
+ *  The journal of \a page stays at the state after a step even when the
+ *  step itself is taken off the undo stack, as gschem does with the
+ *  step it saves when a move starts.  The deltas of that step are
+ *  handed over here and folded into the deltas the next call to
+ *  s_undo_diff_page() returns, so that what the dropped step recorded
+ *  can still be undone.  \a u_current is left without deltas.
+ *
+ *  \param [in] page       The page the step belongs to.
+ *  \param [in] u_current  The undo step being dropped.
+ */
+void s_undo_carry_deltas (PAGE *page, UNDO *u_current)
+{
+  if (u_current->deltas == NULL)
+    return;
+
+  if (page->undo_state == NULL) {
+    s_undo_free_deltas (u_current);
+    return;
+  }
+
+  if (page->undo_state->carried != NULL) {
+    u_current->deltas = s_undo_merge_deltas (page->undo_state->carried,
+                                             u_current->deltas);
+  }
+  page->undo_state->carried = u_current->deltas;
+  u_current->deltas = NULL;
+}
+
+/*! \brief Take a toplevel object and its attributes off a page. */
+static void s_undo_delete_group (TOPLEVEL *toplevel, OBJECT *object)
+{
+  GList *attribs = g_list_copy (object->attribs);
+  GList *iter;
+
+  for (iter = attribs; iter != NULL; iter = g_list_next (iter)) {
+    s_delete_object (toplevel, iter->data);
+  }
+  g_list_free (attribs);
+
+  s_delete_object (toplevel, object);
+}
+
+/*! \brief Read a group of an undo step back into a page.
+ *  \par Function Description
+ *  Puts the group right after the one it followed in the target state,
+ *  found through the journal, or at the start of the page if it was
+ *  first.
+ */
+static void s_undo_insert_group (TOPLEVEL *toplevel, PAGE *page,
+                                 UNDO_DELTA *delta, gboolean backwards)
+{
+  char *to = backwards ? delta->before : delta->after;
+  int prev = backwards ? delta->before_prev : delta->after_prev;
+  GList *new_objects;
+  GList *after = NULL;
+  GList *iter;
+  OBJECT *o_current;
+  GError *err = NULL;
+  char *buffer;
+
+  buffer = g_strconcat (o_file_format_header (), to, NULL);
+  new_objects = o_read_buffer (toplevel, NULL, buffer, strlen (buffer),
+                               "undo", &err);
+  g_free (buffer);
+
+  if (err != NULL) {
+    s_log_message (_("Could not restore undo state: %s\n"), err->message);
+    g_error_free (err);
+  }
+
+  for (iter = new_objects; iter != NULL; iter = g_list_next (iter)) {
+    o_current = iter->data;
+    if (o_current->attached_to == NULL)
+      o_current->sid = delta->sid;
+  }
+
+  if (prev != -1) {
+    after = g_hash_table_lookup (page->undo_state->links,
+                                 GINT_TO_POINTER (prev));
+    if (after == NULL) {
+      s_page_append_list (toplevel, page, new_objects);
+      return;
+    }
+  }
+
+  s_page_insert_list_after (toplevel, page, after, new_objects);
+}
+
+/*! \brief Replay the deltas of an undo step.
+ *  \par Function Description
+ *  Takes \a page from the state after the step to the state before it
+ *  if \a backwards is TRUE (undo), or the other way round (redo).
+ *  Every group that changed is first taken off the page, then the
+ *  groups of the target state are read back in with their original
+ *  sids, each right after the group it followed.  Groups that did not
+ *  change are left alone.
+ *
+ *  \param [in] toplevel   The TOPLEVEL object.
+ *  \param [in] page       The page to change.
+ *  \param [in] deltas     The deltas of the step, from s_undo_diff_page().
+ *  \param [in] backwards  TRUE to undo the step, FALSE to redo it.
+ */
+void s_undo_apply_deltas (TOPLEVEL *toplevel, PAGE *page,
+                          GPtrArray *deltas, gboolean backwards)
+{
+  GHashTable *inserts;
+  GPtrArray *chain;
+  UNDO_DELTA *delta;
+  GList *link;
+  OBJECT *o_current;
+  int prev;
+  guint i, j;
+
+  if (deltas == NULL || deltas->len == 0 || page->undo_state == NULL)
+    return;
+
+  /* take the groups that change off the page */
+  inserts = g_hash_table_new (g_direct_hash, g_direct_equal);
+  for (i = 0; i < deltas->len; i++) {
+    delta = g_ptr_array_index (deltas, i);
+
+    if ((backwards ? delta->after : delta->before) != NULL) {
+      link = g_hash_table_lookup (page->undo_state->links,
+                                  GINT_TO_POINTER (delta->sid));
+      o_current = (link != NULL) ? link->data : NULL;
+      if (o_current != NULL && o_current->attached_to == NULL)
+        s_undo_delete_group (toplevel, o_current);
+    }
+
+    if ((backwards ? delta->before : delta->after) != NULL) {
+      g_hash_table_insert (inserts, GINT_TO_POINTER (delta->sid), delta);
+    }
+  }
+
+  /* put the groups of the target state back; a group that follows
+   * another one being put back has to wait for it */
+  chain = g_ptr_array_new ();
+  for (i = 0; i < deltas->len; i++) {
+    delta = g_ptr_array_index (deltas, i);
+    if (g_hash_table_lookup (inserts, GINT_TO_POINTER (delta->sid)) == NULL)
+      continue;
+
+    g_ptr_array_set_size (chain, 0);
+    while (delta != NULL) {
+      g_hash_table_remove (inserts, GINT_TO_POINTER (delta->sid));
+      g_ptr_array_add (chain, delta);
+
+      prev = backwards ? delta->before_prev : delta->after_prev;
+      delta = (prev == -1) ? NULL :
+              g_hash_table_lookup (inserts, GINT_TO_POINTER (prev));
+    }
+
+    for (j = chain->len; j > 0; j--) {
+      s_undo_insert_group (toplevel, page, g_ptr_array_index (chain, j - 1),
+                           backwards);
+    }
+  }
+
+  g_ptr_array_free (chain, TRUE);
+  g_hash_table_destroy (inserts);
+
+  /* the page is now at the target step */
+  s_undo_update_state (toplevel, page, NULL);
 }
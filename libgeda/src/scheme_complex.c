@@ -223,6 +223,9 @@ SCM_DEFINE (complex_contents, "%complex-contents", 1, 0, 0,
 
   OBJECT *obj = edascm_to_object (complex_s);
 
+  /* The contents may be changed through the objects returned */
+  o_complex_unshare (edascm_c_current_toplevel (), obj);
+
   return edascm_from_object_glist (obj->complex->prim_objs);
 }
 
@@ -275,6 +278,7 @@ SCM_DEFINE (complex_append_x, "%complex-append!", 2, 0, 0,
    * it's guaranteed not to be present in a page at this point. */
   o_emit_pre_change_notify (toplevel, parent);
 
+  o_complex_unshare (toplevel, parent);
   parent->complex->prim_objs =
     g_list_append (parent->complex->prim_objs, child);
   child->parent = parent;
@@ -353,6 +357,7 @@ SCM_DEFINE (complex_remove_x, "%complex-remove!", 2, 0, 0,
    * only the parent will remain in the page. */
   o_emit_pre_change_notify (toplevel, parent);
 
+  o_complex_unshare (toplevel, parent);
   parent->complex->prim_objs =
     g_list_remove_all (parent->complex->prim_objs, child);
   child->parent = NULL;
@@ -62,6 +62,13 @@
 
 scm_t_bits geda_smob_tag;
 
+/* The weak reference lists smobs add themselves to are shared by every
+ * thread in Guile mode, and smobs are freed by the garbage collector
+ * while other threads create new ones.  Nothing run while holding the
+ * lock may allocate Scheme memory, or the collector could try to take
+ * it again. */
+G_LOCK_DEFINE_STATIC (smob_weakrefs);
+
 /*! \brief Weak reference notify function for gEDA smobs.
  * \par Function Description
  * Clears a gEDA smob's pointer when the target object is destroyed.
@@ -102,6 +109,7 @@ smob_free (SCM smob)
   data = (void *) SCM_SMOB_DATA (smob);
 
   /* Otherwise, clear the weak reference */
+  G_LOCK (smob_weakrefs);
   switch (EDASCM_SMOB_TYPE (smob)) {
   case GEDA_SMOB_TOPLEVEL:
     s_toplevel_weak_unref ((TOPLEVEL *) data, smob_weakref_notify, smob);
@@ -120,6 +128,7 @@ smob_free (SCM smob)
     /* This should REALLY definitely never be run */
     g_critical ("%s: received bad smob flags.", __FUNCTION__);
   }
+  G_UNLOCK (smob_weakrefs);
 
   /* If the smob is marked as garbage-collectable, destroy its
    * contents.
@@ -233,7 +242,9 @@ edascm_from_toplevel (TOPLEVEL *toplevel)
   SCM_SET_SMOB_FLAGS (smob, GEDA_SMOB_TOPLEVEL);
 
   /* Set weak reference */
+  G_LOCK (smob_weakrefs);
   s_toplevel_weak_ref (toplevel, smob_weakref_notify, smob);
+  G_UNLOCK (smob_weakrefs);
 
   return smob;
 }
@@ -255,7 +266,9 @@ edascm_from_page (PAGE *page)
   SCM_SET_SMOB_FLAGS (smob, GEDA_SMOB_PAGE);
 
   /* Set weak reference */
+  G_LOCK (smob_weakrefs);
   s_page_weak_ref (page, smob_weakref_notify, smob);
+  G_UNLOCK (smob_weakrefs);
 
   return smob;
 }
@@ -313,8 +326,10 @@ edascm_from_object (OBJECT *object)
   SCM_SET_SMOB_FLAGS (smob, GEDA_SMOB_OBJECT);
 
   /* Set weak references */
+  G_LOCK (smob_weakrefs);
   s_object_weak_ref (object, smob_weakref_notify, smob);
   s_toplevel_weak_ref (toplevel, smob_weakref2_notify, smob);
+  G_UNLOCK (smob_weakrefs);
 
   return smob;
 }